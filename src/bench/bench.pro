@@ -21,11 +21,15 @@ SOURCES += \
     optionsdialog.cpp \
     benchlivenodeengine.cpp \
     previewimageprovider.cpp \
+    previewscheduler.cpp \
+    thumbnailcache.cpp \
     directorypreviewadapter.cpp \
+    directorypreviewmodel.cpp \
     qmlpreviewadapter.cpp \
     host.cpp \
     hostmodel.cpp \
     hostwidget.cpp \
+    hostconnection.cpp \
     dummydelegate.cpp \
     allhostswidget.cpp \
     hostmanager.cpp \
@@ -42,11 +46,15 @@ HEADERS += \
     optionsdialog.h \
     benchlivenodeengine.h \
     previewimageprovider.h \
+    previewscheduler.h \
+    thumbnailcache.h \
     directorypreviewadapter.h \
+    directorypreviewmodel.h \
     qmlpreviewadapter.h \
     host.h \
     hostmodel.h \
     hostwidget.h \
+    hostconnection.h \
     dummydelegate.h \
     allhostswidget.h \
     hostmanager.h \
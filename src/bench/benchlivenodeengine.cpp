@@ -32,6 +32,7 @@
 #include "benchlivenodeengine.h"
 #include "directorypreviewadapter.h"
 #include "previewimageprovider.h"
+#include "previewscheduler.h"
 #include "qmlpreviewadapter.h"
 #include "widgets/windowwidget.h"
 #include "liveruntime.h"
@@ -44,12 +45,17 @@ BenchLiveNodeEngine::BenchLiveNodeEngine(QObject *parent)
     : LiveNodeEngine(parent),
       m_ww(0),
       m_imageProvider(new PreviewImageProvider(this)),
+      m_previewScheduler(0),
       m_workspaceView(0),
       m_clipToRootObject(false)
 {
     setQmlEngine(new QQmlEngine(this));
     setFallbackView(new QQuickView(qmlEngine(), 0));
 
+    // Created after the QML engine, so that it is destroyed before it
+    m_previewScheduler = new PreviewScheduler(this);
+    m_imageProvider->setScheduler(m_previewScheduler);
+
     qmlEngine()->addImageProvider("qmlLiveDirectoryPreview", m_imageProvider);
 }
 
@@ -103,6 +109,9 @@ QImage BenchLiveNodeEngine::convertIconToImage(const QFileInfo &info, const QSiz
 
 void BenchLiveNodeEngine::initPlugins()
 {
+    if (!m_plugins.isEmpty())
+        return;
+
     LiveNodeEngine::initPlugins();
 
     DirectoryPreviewAdapter *adapter = new DirectoryPreviewAdapter(this);
@@ -115,7 +124,7 @@ void BenchLiveNodeEngine::initPlugins()
                 Qt::QueuedConnection);
     }
 
-    QmlPreviewAdapter *previewAdapter = new QmlPreviewAdapter(this);
+    QmlPreviewAdapter *previewAdapter = new QmlPreviewAdapter(m_previewScheduler, this);
 
     previewAdapter->setImportPaths(qmlEngine()->importPathList());
 
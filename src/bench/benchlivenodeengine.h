@@ -35,6 +35,7 @@
 
 class WindowWidget;
 class PreviewImageProvider;
+class PreviewScheduler;
 class WorkspaceView;
 class BenchLiveNodeEngine : public LiveNodeEngine
 {
@@ -61,6 +62,7 @@ private Q_SLOTS:
 private:
     WindowWidget* m_ww;
     QPointer<PreviewImageProvider> m_imageProvider;
+    PreviewScheduler *m_previewScheduler;
     WorkspaceView* m_workspaceView;
     bool m_clipToRootObject;
 };
@@ -30,6 +30,7 @@
 ****************************************************************************/
 
 #include "directorypreviewadapter.h"
+#include "directorypreviewmodel.h"
 #include "livedocument.h"
 #include <QFileInfo>
 #include <QDir>
@@ -37,7 +38,8 @@
 #include <QQmlEngine>
 
 DirectoryPreviewAdapter::DirectoryPreviewAdapter(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    m_model(new DirectoryPreviewModel(this))
 {
 }
 
@@ -70,9 +72,11 @@ bool DirectoryPreviewAdapter::canAdapt(const QUrl &url) const
 QUrl DirectoryPreviewAdapter::adapt(const QUrl &url, QQmlContext *context)
 {
     QString path(LiveDocument::toFilePath(url));
-    QDir dir(path);
 
-    context->setContextProperty("files", dir.entryList(QDir::Files | QDir::NoDotDot | QDir::NoDot | QDir::NoSymLinks));
+    // Reloading the same directory keeps the listing and only applies the changes
+    m_model->setPath(QDir(path).absolutePath());
+
+    context->setContextProperty("files", m_model);
     context->setContextProperty("path", path);
     context->setContextProperty("adapter", this);
 
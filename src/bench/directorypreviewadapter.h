@@ -33,6 +33,8 @@
 
 #include "contentadapterinterface.h"
 
+class DirectoryPreviewModel;
+
 QT_FORWARD_DECLARE_CLASS(QDeclarativeContext);
 class DirectoryPreviewAdapter : public QObject, public ContentAdapterInterface
 {
@@ -52,4 +54,7 @@ public:
 Q_SIGNALS:
 
     void loadDocument(const QString& path);
+
+private:
+    DirectoryPreviewModel *m_model;
 };
@@ -0,0 +1,319 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "directorypreviewmodel.h"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+#include <algorithm>
+
+namespace {
+const int BATCH_SIZE = 256;
+const int BATCH_INTERVAL = 50; // ms
+
+// Same order as QDir::entryList() sorting by name
+bool entryLessThan(const DirectoryEntry &a, const DirectoryEntry &b)
+{
+    const int result = QString::compare(a.name, b.name, Qt::CaseInsensitive);
+    return result != 0 ? result < 0 : a.name < b.name;
+}
+}
+
+/*
+ * Lists a directory in a background thread. Entries are reported in batches as they
+ * are found, the complete sorted list is reported once the scan finished. A scan is
+ * abandoned as soon as the model requests a newer one.
+ */
+class DirectoryScanner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DirectoryScanner(const QAtomicInt *generation)
+        : m_generation(generation)
+    {
+    }
+
+public slots:
+    void scan(const QString &path, int generation)
+    {
+        DirectoryEntryList all;
+        DirectoryEntryList batch;
+        QElapsedTimer batchTimer;
+        batchTimer.start();
+
+        QDirIterator it(path, QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        while (it.hasNext()) {
+            if (m_generation->load() != generation)
+                return;
+
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            DirectoryEntry entry;
+            entry.name = info.fileName();
+            entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+            entry.size = info.size();
+            batch.append(entry);
+
+            if (batch.size() >= BATCH_SIZE || batchTimer.elapsed() >= BATCH_INTERVAL) {
+                all += batch;
+                emit entriesFound(generation, batch);
+                batch.clear();
+                batchTimer.restart();
+            }
+        }
+
+        all += batch;
+        if (!batch.isEmpty())
+            emit entriesFound(generation, batch);
+
+        std::sort(all.begin(), all.end(), entryLessThan);
+        emit finished(generation, all);
+    }
+
+signals:
+    void entriesFound(int generation, const DirectoryEntryList &entries);
+    void finished(int generation, const DirectoryEntryList &entries);
+
+private:
+    const QAtomicInt *m_generation;
+};
+
+/*
+ * Lists the files of a directory for the folder view.
+ *
+ * The directory is scanned in a background thread and rows are inserted as they are
+ * found, so that the view becomes usable immediately even on directories with many
+ * thousands of files. Rows are kept sorted by name.
+ *
+ * Setting the same path again rescans the directory and applies only the differences,
+ * so that views reloaded on workspace changes keep their delegates. A modified file is
+ * removed and inserted again for its preview to be requested again.
+ */
+DirectoryPreviewModel::DirectoryPreviewModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_scanning(false)
+    , m_scanner(new DirectoryScanner(&m_generation))
+{
+    qRegisterMetaType<DirectoryEntryList>();
+
+    m_scanner->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_scanner, &QObject::deleteLater);
+    connect(this, &DirectoryPreviewModel::scanRequested, m_scanner, &DirectoryScanner::scan);
+    connect(m_scanner, &DirectoryScanner::entriesFound, this, &DirectoryPreviewModel::onEntriesFound);
+    connect(m_scanner, &DirectoryScanner::finished, this, &DirectoryPreviewModel::onScanFinished);
+    m_thread.setObjectName(QStringLiteral("DirectoryPreviewModel"));
+    m_thread.start();
+}
+
+DirectoryPreviewModel::~DirectoryPreviewModel()
+{
+    // Abandon a running scan
+    m_generation.fetchAndAddOrdered(1);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString DirectoryPreviewModel::path() const
+{
+    return m_path;
+}
+
+void DirectoryPreviewModel::setPath(const QString &path)
+{
+    if (path == m_path) {
+        rescan();
+        return;
+    }
+
+    beginResetModel();
+    m_path = path;
+    m_entries.clear();
+    endResetModel();
+    emit pathChanged();
+
+    rescan();
+}
+
+bool DirectoryPreviewModel::isScanning() const
+{
+    return m_scanning;
+}
+
+void DirectoryPreviewModel::rescan()
+{
+    if (m_path.isEmpty())
+        return;
+
+    const int generation = m_generation.fetchAndAddOrdered(1) + 1;
+    setScanning(true);
+    emit scanRequested(m_path, generation);
+}
+
+int DirectoryPreviewModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_entries.count();
+}
+
+QVariant DirectoryPreviewModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.count())
+        return QVariant();
+
+    const DirectoryEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case FileNameRole:
+        return entry.name;
+    case FilePathRole:
+        return m_path + QLatin1Char('/') + entry.name;
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> DirectoryPreviewModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[FileNameRole] = "fileName";
+    roles[FilePathRole] = "filePath";
+    return roles;
+}
+
+void DirectoryPreviewModel::onEntriesFound(int generation, const DirectoryEntryList &entries)
+{
+    if (generation != m_generation.load())
+        return;
+
+    insertEntries(entries);
+}
+
+void DirectoryPreviewModel::onScanFinished(int generation, const DirectoryEntryList &entries)
+{
+    if (generation != m_generation.load())
+        return;
+
+    mergeEntries(entries);
+    setScanning(false);
+}
+
+/*
+ * Inserts the entries not listed yet at their sorted positions. Entries landing next
+ * to each other are inserted together.
+ */
+void DirectoryPreviewModel::insertEntries(const DirectoryEntryList &entries)
+{
+    DirectoryEntryList sorted = entries;
+    std::sort(sorted.begin(), sorted.end(), entryLessThan);
+
+    int i = 0;
+    while (i < sorted.count()) {
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), sorted.at(i), entryLessThan);
+        const int row = it - m_entries.begin();
+        if (it != m_entries.end() && it->name == sorted.at(i).name) {
+            ++i;
+            continue;
+        }
+
+        int last = i;
+        while (last + 1 < sorted.count()
+               && (row == m_entries.count() || entryLessThan(sorted.at(last + 1), m_entries.at(row)))) {
+            ++last;
+        }
+
+        beginInsertRows(QModelIndex(), row, row + last - i);
+        for (int j = i; j <= last; ++j)
+            m_entries.insert(row + j - i, sorted.at(j));
+        endInsertRows();
+
+        i = last + 1;
+    }
+}
+
+/*
+ * Makes the rows match the sorted \a entries of a complete scan.
+ */
+void DirectoryPreviewModel::mergeEntries(const DirectoryEntryList &entries)
+{
+    int row = 0;
+    int i = 0;
+    while (row < m_entries.count() || i < entries.count()) {
+        if (i == entries.count() || (row < m_entries.count() && entryLessThan(m_entries.at(row), entries.at(i)))) {
+            int last = row;
+            while (last + 1 < m_entries.count()
+                   && (i == entries.count() || entryLessThan(m_entries.at(last + 1), entries.at(i)))) {
+                ++last;
+            }
+            beginRemoveRows(QModelIndex(), row, last);
+            m_entries.remove(row, last - row + 1);
+            endRemoveRows();
+        } else if (row == m_entries.count() || entryLessThan(entries.at(i), m_entries.at(row))) {
+            int last = i;
+            while (last + 1 < entries.count()
+                   && (row == m_entries.count() || entryLessThan(entries.at(last + 1), m_entries.at(row)))) {
+                ++last;
+            }
+            beginInsertRows(QModelIndex(), row, row + last - i);
+            for (int j = i; j <= last; ++j)
+                m_entries.insert(row + j - i, entries.at(j));
+            endInsertRows();
+            row += last - i + 1;
+            i = last + 1;
+        } else {
+            const DirectoryEntry &entry = m_entries.at(row);
+            if (entry.lastModified != entries.at(i).lastModified || entry.size != entries.at(i).size) {
+                beginRemoveRows(QModelIndex(), row, row);
+                m_entries.remove(row);
+                endRemoveRows();
+                beginInsertRows(QModelIndex(), row, row);
+                m_entries.insert(row, entries.at(i));
+                endInsertRows();
+            }
+            ++row;
+            ++i;
+        }
+    }
+}
+
+void DirectoryPreviewModel::setScanning(bool scanning)
+{
+    if (scanning == m_scanning)
+        return;
+
+    m_scanning = scanning;
+    emit scanningChanged();
+}
+
+#include "directorypreviewmodel.moc"
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QAtomicInt>
+#include <QThread>
+#include <QVector>
+
+class DirectoryScanner;
+
+struct DirectoryEntry
+{
+    QString name;
+    qint64 lastModified;
+    qint64 size;
+};
+
+typedef QVector<DirectoryEntry> DirectoryEntryList;
+
+Q_DECLARE_METATYPE(DirectoryEntryList)
+
+class DirectoryPreviewModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path NOTIFY pathChanged)
+    Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged)
+
+public:
+    enum Roles {
+        FileNameRole = Qt::UserRole + 1,
+        FilePathRole
+    };
+
+    explicit DirectoryPreviewModel(QObject *parent = 0);
+    ~DirectoryPreviewModel();
+
+    QString path() const;
+    void setPath(const QString &path);
+
+    bool isScanning() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+public slots:
+    void rescan();
+
+signals:
+    void pathChanged();
+    void scanningChanged();
+    void scanRequested(const QString &path, int generation);
+
+private slots:
+    void onEntriesFound(int generation, const DirectoryEntryList &entries);
+    void onScanFinished(int generation, const DirectoryEntryList &entries);
+
+private:
+    void insertEntries(const DirectoryEntryList &entries);
+    void mergeEntries(const DirectoryEntryList &entries);
+    void setScanning(bool scanning);
+
+    QString m_path;
+    DirectoryEntryList m_entries;
+    QAtomicInt m_generation;
+    bool m_scanning;
+
+    QThread m_thread;
+    DirectoryScanner *m_scanner;
+};
@@ -59,7 +59,8 @@ Host::Host(const Host &host, QObject *parent) :
     m_followTreeSelection(host.followTreeSelection()),
     m_autoDiscoveryId(host.autoDiscoveryId()),
     m_productVersion(host.productVersion()),
-    m_systemName(host.systemName())
+    m_systemName(host.systemName()),
+    m_manifestHash(host.manifestHash())
 {
 }
 
@@ -175,6 +176,11 @@ void Host::setSystemName(QString arg)
     m_systemName = arg;
 }
 
+void Host::setManifestHash(QByteArray arg)
+{
+    m_manifestHash = arg;
+}
+
 void Host::setPort(int arg)
 {
     if (m_port != arg) {
@@ -247,6 +253,11 @@ QString Host::systemName() const
     return m_systemName;
 }
 
+QByteArray Host::manifestHash() const
+{
+    return m_manifestHash;
+}
+
 QUuid Host::autoDiscoveryId() const
 {
     return m_autoDiscoveryId;
@@ -63,6 +63,7 @@ public:
     Q_PROPERTY(QUuid autoDiscoveryId READ autoDiscoveryId WRITE setAutoDiscoveryId NOTIFY autoDiscoveryIdChanged)
     Q_PROPERTY(QString productVersion READ productVersion WRITE setProductVersion)
     Q_PROPERTY(QString systemName READ systemName WRITE setSystemName)
+    Q_PROPERTY(QByteArray manifestHash READ manifestHash WRITE setManifestHash)
 
     explicit Host(Type type = Manual, QObject *parent = 0);
     Host(const Host& host, QObject *parent = 0);
@@ -82,6 +83,7 @@ public:
     QUuid autoDiscoveryId() const;
     QString productVersion() const;
     QString systemName() const;
+    QByteArray manifestHash() const;
 
 
     void saveToSettings(QSettings *s);
@@ -116,6 +118,7 @@ public slots:
     void setAutoDiscoveryId(QUuid arg);
     void setProductVersion(QString arg);
     void setSystemName(QString arg);
+    void setManifestHash(QByteArray arg);
 
 private:
 
@@ -132,6 +135,7 @@ private:
     QUuid m_autoDiscoveryId;
     QString m_productVersion;
     QString m_systemName;
+    QByteArray m_manifestHash;
 };
 
 Q_DECLARE_METATYPE( Host* )
@@ -0,0 +1,441 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "hostconnection.h"
+
+#include "livedocument.h"
+#include "livehubengine.h"
+#include "remotepublisher.h"
+#include "ipc/ipcclient.h"
+
+#include <QThread>
+
+/*
+ * Lives in the network thread and drives the RemotePublisher there.
+ *
+ * Calls are identified by UUIDs generated by HostConnection on the GUI thread,
+ * so that these can be returned immediately. Results reported by the publisher
+ * are translated back to these UUIDs.
+ */
+class HostConnectionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    HostConnectionWorker();
+
+    RemotePublisher *publisher() const { return m_publisher; }
+
+public Q_SLOTS:
+    void connectToServer(const QString &hostName, int port);
+    void disconnectFromServer();
+    void setWorkspace(const QString &path);
+    void setPayloadSource(LiveHubEngine *hub);
+
+    void activateDocument(const QUuid &id, const LiveDocument &document);
+    void reloadDocument(const QUuid &id);
+    void prefetchDocuments(const QUuid &id, const QStringList &documents);
+    void beginBulkSend(const QUuid &id);
+    void endBulkSend(const QUuid &id);
+    void sendDocument(const QUuid &id, const LiveDocument &document);
+    void checkPin(const QUuid &id, const QString &pin);
+    void setXOffset(const QUuid &id, int offset);
+    void setYOffset(const QUuid &id, int offset);
+    void setRotation(const QUuid &id, int rotation);
+    void initComplete(const QUuid &id);
+    void joinMulticast(const QUuid &id, const QString &address, quint16 port, quint32 session,
+                       const QByteArray &key, quint32 firstSequence);
+    void multicastBarrier(const QUuid &id, quint32 sequence);
+    void abandonMulticast(const QUuid &id, quint32 sequence);
+
+Q_SIGNALS:
+    void stateChanged(QAbstractSocket::SocketState state);
+    void connected();
+    void disconnected();
+    void sentSuccessfully(const QUuid &uuid);
+    void sendingError(const QUuid &uuid, QAbstractSocket::SocketError socketError);
+    void connectionError(QAbstractSocket::SocketError error);
+
+private Q_SLOTS:
+    void onConnected();
+    void onDisconnected();
+    void onConnectionError(QAbstractSocket::SocketError error);
+    void onSentSuccessfully(const QUuid &remoteId);
+    void onSendingError(const QUuid &remoteId, QAbstractSocket::SocketError socketError);
+
+private:
+    void track(const QUuid &id, const QUuid &remoteId);
+    void syncState();
+
+private:
+    RemotePublisher *m_publisher;
+    QAbstractSocket::SocketState m_state;
+    QHash<QUuid, QUuid> m_ids;
+};
+
+HostConnectionWorker::HostConnectionWorker()
+    : m_publisher(new RemotePublisher(this))
+    , m_state(QAbstractSocket::UnconnectedState)
+{
+    connect(m_publisher, &RemotePublisher::connected, this, &HostConnectionWorker::onConnected);
+    connect(m_publisher, &RemotePublisher::disconnected, this, &HostConnectionWorker::onDisconnected);
+    connect(m_publisher, &RemotePublisher::connectionError, this, &HostConnectionWorker::onConnectionError);
+    connect(m_publisher, &RemotePublisher::sentSuccessfully, this, &HostConnectionWorker::onSentSuccessfully);
+    connect(m_publisher, &RemotePublisher::sendingError, this, &HostConnectionWorker::onSendingError);
+}
+
+void HostConnectionWorker::connectToServer(const QString &hostName, int port)
+{
+    m_publisher->connectToServer(hostName, port);
+    syncState();
+}
+
+void HostConnectionWorker::disconnectFromServer()
+{
+    m_publisher->disconnectFromServer();
+    syncState();
+}
+
+void HostConnectionWorker::setWorkspace(const QString &path)
+{
+    m_publisher->setWorkspace(path);
+}
+
+void HostConnectionWorker::setPayloadSource(LiveHubEngine *hub)
+{
+    m_publisher->setPayloadSource(hub);
+}
+
+void HostConnectionWorker::activateDocument(const QUuid &id, const LiveDocument &document)
+{
+    track(id, m_publisher->activateDocument(document));
+}
+
+void HostConnectionWorker::reloadDocument(const QUuid &id)
+{
+    track(id, m_publisher->reloadDocument());
+}
+
+void HostConnectionWorker::prefetchDocuments(const QUuid &id, const QStringList &documents)
+{
+    track(id, m_publisher->prefetchDocuments(documents));
+}
+
+void HostConnectionWorker::beginBulkSend(const QUuid &id)
+{
+    track(id, m_publisher->beginBulkSend());
+}
+
+void HostConnectionWorker::endBulkSend(const QUuid &id)
+{
+    track(id, m_publisher->endBulkSend());
+}
+
+void HostConnectionWorker::sendDocument(const QUuid &id, const LiveDocument &document)
+{
+    track(id, m_publisher->sendDocument(document));
+}
+
+void HostConnectionWorker::checkPin(const QUuid &id, const QString &pin)
+{
+    track(id, m_publisher->checkPin(pin));
+}
+
+void HostConnectionWorker::setXOffset(const QUuid &id, int offset)
+{
+    track(id, m_publisher->setXOffset(offset));
+}
+
+void HostConnectionWorker::setYOffset(const QUuid &id, int offset)
+{
+    track(id, m_publisher->setYOffset(offset));
+}
+
+void HostConnectionWorker::setRotation(const QUuid &id, int rotation)
+{
+    track(id, m_publisher->setRotation(rotation));
+}
+
+void HostConnectionWorker::initComplete(const QUuid &id)
+{
+    track(id, m_publisher->initComplete());
+}
+
+void HostConnectionWorker::joinMulticast(const QUuid &id, const QString &address, quint16 port,
+                                         quint32 session, const QByteArray &key, quint32 firstSequence)
+{
+    track(id, m_publisher->joinMulticast(address, port, session, key, firstSequence));
+}
+
+void HostConnectionWorker::multicastBarrier(const QUuid &id, quint32 sequence)
+{
+    track(id, m_publisher->multicastBarrier(sequence));
+}
+
+void HostConnectionWorker::abandonMulticast(const QUuid &id, quint32 sequence)
+{
+    track(id, m_publisher->abandonMulticast(sequence));
+}
+
+void HostConnectionWorker::onConnected()
+{
+    syncState();
+    emit connected();
+}
+
+void HostConnectionWorker::onDisconnected()
+{
+    syncState();
+    emit disconnected();
+}
+
+void HostConnectionWorker::onConnectionError(QAbstractSocket::SocketError error)
+{
+    syncState();
+    emit connectionError(error);
+}
+
+void HostConnectionWorker::onSentSuccessfully(const QUuid &remoteId)
+{
+    const QUuid id = m_ids.take(remoteId);
+    if (!id.isNull())
+        emit sentSuccessfully(id);
+}
+
+void HostConnectionWorker::onSendingError(const QUuid &remoteId, QAbstractSocket::SocketError socketError)
+{
+    const QUuid id = m_ids.take(remoteId);
+    if (!id.isNull())
+        emit sendingError(id, socketError);
+}
+
+void HostConnectionWorker::track(const QUuid &id, const QUuid &remoteId)
+{
+    // Nothing was queued, e.g. the document could not be read
+    if (remoteId.isNull()) {
+        emit sendingError(id, QAbstractSocket::UnknownSocketError);
+        return;
+    }
+
+    m_ids.insert(remoteId, id);
+}
+
+void HostConnectionWorker::syncState()
+{
+    const QAbstractSocket::SocketState state = m_publisher->state();
+    if (state == m_state)
+        return;
+
+    m_state = state;
+    emit stateChanged(m_state);
+}
+
+/*
+ * Offers the RemotePublisher interface to the GUI thread while the publisher and its
+ * socket live in the given network thread. The state is the one last reported by that
+ * thread.
+ */
+HostConnection::HostConnection(QThread *thread, QObject *parent)
+    : QObject(parent)
+    , m_worker(new HostConnectionWorker)
+    , m_state(QAbstractSocket::UnconnectedState)
+{
+    qRegisterMetaType<LiveDocument>();
+    qRegisterMetaType<QAbstractSocket::SocketError>();
+    qRegisterMetaType<QAbstractSocket::SocketState>();
+    qRegisterMetaType<QList<quint32>>();
+
+    if (thread)
+        m_worker->moveToThread(thread);
+
+    connect(m_worker, &HostConnectionWorker::stateChanged, this, &HostConnection::onStateChanged);
+    connect(m_worker, &HostConnectionWorker::connected, this, &HostConnection::connected);
+    connect(m_worker, &HostConnectionWorker::disconnected, this, &HostConnection::disconnected);
+    connect(m_worker, &HostConnectionWorker::connectionError, this, &HostConnection::connectionError);
+    connect(m_worker, &HostConnectionWorker::sentSuccessfully, this, &HostConnection::sentSuccessfully);
+    connect(m_worker, &HostConnectionWorker::sendingError, this, &HostConnection::sendingError);
+
+    RemotePublisher *publisher = m_worker->publisher();
+    connect(publisher, &RemotePublisher::needsPinAuthentication, this, &HostConnection::needsPinAuthentication);
+    connect(publisher, &RemotePublisher::needsPublishWorkspaceWithHash, this, &HostConnection::needsPublishWorkspace);
+    connect(publisher, &RemotePublisher::activeDocumentChanged, this, &HostConnection::activeDocumentChanged);
+    connect(publisher, &RemotePublisher::pinOk, this, &HostConnection::pinOk);
+    connect(publisher, &RemotePublisher::multicastJoined, this, &HostConnection::multicastJoined);
+    connect(publisher, &RemotePublisher::multicastNack, this, &HostConnection::multicastNack);
+    connect(publisher, &RemotePublisher::remoteLog, this, &HostConnection::remoteLog);
+    connect(publisher, &RemotePublisher::clearLog, this, &HostConnection::clearLog);
+}
+
+HostConnection::~HostConnection()
+{
+    m_worker->deleteLater();
+}
+
+QAbstractSocket::SocketState HostConnection::state() const
+{
+    return m_state;
+}
+
+QString HostConnection::errorToString(QAbstractSocket::SocketError error)
+{
+    return IpcClient::errorToString(error);
+}
+
+void HostConnection::connectToServer(const QString &hostName, int port)
+{
+    // Avoid repeated attempts until the network thread reports back
+    m_state = QAbstractSocket::HostLookupState;
+
+    QMetaObject::invokeMethod(m_worker, "connectToServer", Q_ARG(QString, hostName), Q_ARG(int, port));
+}
+
+void HostConnection::setPayloadSource(LiveHubEngine *hub)
+{
+    QMetaObject::invokeMethod(m_worker, "setPayloadSource", Q_ARG(LiveHubEngine*, hub));
+}
+
+void HostConnection::setWorkspace(const QString &path)
+{
+    QMetaObject::invokeMethod(m_worker, "setWorkspace", Q_ARG(QString, path));
+}
+
+void HostConnection::disconnectFromServer()
+{
+    QMetaObject::invokeMethod(m_worker, "disconnectFromServer");
+}
+
+QUuid HostConnection::activateDocument(const LiveDocument &document)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "activateDocument", Q_ARG(QUuid, id), Q_ARG(LiveDocument, document));
+    return id;
+}
+
+QUuid HostConnection::reloadDocument()
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "reloadDocument", Q_ARG(QUuid, id));
+    return id;
+}
+
+QUuid HostConnection::prefetchDocuments(const QStringList &documents)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "prefetchDocuments", Q_ARG(QUuid, id), Q_ARG(QStringList, documents));
+    return id;
+}
+
+QUuid HostConnection::beginBulkSend()
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "beginBulkSend", Q_ARG(QUuid, id));
+    return id;
+}
+
+QUuid HostConnection::endBulkSend()
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "endBulkSend", Q_ARG(QUuid, id));
+    return id;
+}
+
+QUuid HostConnection::sendDocument(const LiveDocument &document)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "sendDocument", Q_ARG(QUuid, id), Q_ARG(LiveDocument, document));
+    return id;
+}
+
+QUuid HostConnection::checkPin(const QString &pin)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "checkPin", Q_ARG(QUuid, id), Q_ARG(QString, pin));
+    return id;
+}
+
+QUuid HostConnection::setXOffset(int offset)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "setXOffset", Q_ARG(QUuid, id), Q_ARG(int, offset));
+    return id;
+}
+
+QUuid HostConnection::setYOffset(int offset)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "setYOffset", Q_ARG(QUuid, id), Q_ARG(int, offset));
+    return id;
+}
+
+QUuid HostConnection::setRotation(int rotation)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "setRotation", Q_ARG(QUuid, id), Q_ARG(int, rotation));
+    return id;
+}
+
+QUuid HostConnection::initComplete()
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "initComplete", Q_ARG(QUuid, id));
+    return id;
+}
+
+QUuid HostConnection::joinMulticast(const QString &address, quint16 port, quint32 session,
+                                    const QByteArray &key, quint32 firstSequence)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "joinMulticast", Q_ARG(QUuid, id), Q_ARG(QString, address),
+                              Q_ARG(quint16, port), Q_ARG(quint32, session), Q_ARG(QByteArray, key),
+                              Q_ARG(quint32, firstSequence));
+    return id;
+}
+
+QUuid HostConnection::multicastBarrier(quint32 sequence)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "multicastBarrier", Q_ARG(QUuid, id), Q_ARG(quint32, sequence));
+    return id;
+}
+
+QUuid HostConnection::abandonMulticast(quint32 sequence)
+{
+    const QUuid id = QUuid::createUuid();
+    QMetaObject::invokeMethod(m_worker, "abandonMulticast", Q_ARG(QUuid, id), Q_ARG(quint32, sequence));
+    return id;
+}
+
+void HostConnection::onStateChanged(QAbstractSocket::SocketState state)
+{
+    m_state = state;
+}
+
+#include "hostconnection.moc"
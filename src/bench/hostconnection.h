@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QAbstractSocket>
+#include <QUuid>
+
+class LiveDocument;
+class LiveHubEngine;
+class HostConnectionWorker;
+
+QT_FORWARD_DECLARE_CLASS(QThread);
+
+class HostConnection : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HostConnection(QThread *thread, QObject *parent = 0);
+    ~HostConnection();
+
+    QAbstractSocket::SocketState state() const;
+    static QString errorToString(QAbstractSocket::SocketError error);
+
+    void connectToServer(const QString &hostName, int port);
+    void setPayloadSource(LiveHubEngine *hub);
+
+Q_SIGNALS:
+    void connected();
+    void disconnected();
+    void sentSuccessfully(const QUuid &uuid);
+    void sendingError(const QUuid &uuid, QAbstractSocket::SocketError socketError);
+    void connectionError(QAbstractSocket::SocketError error);
+    void needsPinAuthentication();
+    void needsPublishWorkspace(const QByteArray &manifestHash);
+    void activeDocumentChanged(const LiveDocument &document);
+    void pinOk(bool ok);
+    void multicastJoined(bool ok);
+    void multicastNack(const QList<quint32> &sequences);
+    void remoteLog(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
+    void clearLog();
+
+public Q_SLOTS:
+    void setWorkspace(const QString &path);
+    void disconnectFromServer();
+    QUuid activateDocument(const LiveDocument &document);
+    QUuid reloadDocument();
+    QUuid prefetchDocuments(const QStringList &documents);
+    QUuid beginBulkSend();
+    QUuid endBulkSend();
+    QUuid sendDocument(const LiveDocument &document);
+    QUuid checkPin(const QString &pin);
+    QUuid setXOffset(int offset);
+    QUuid setYOffset(int offset);
+    QUuid setRotation(int rotation);
+    QUuid initComplete();
+    QUuid joinMulticast(const QString &address, quint16 port, quint32 session, const QByteArray &key,
+                        quint32 firstSequence);
+    QUuid multicastBarrier(quint32 sequence);
+    QUuid abandonMulticast(quint32 sequence);
+
+private Q_SLOTS:
+    void onStateChanged(QAbstractSocket::SocketState state);
+
+private:
+    HostConnectionWorker *m_worker;
+    QAbstractSocket::SocketState m_state;
+};
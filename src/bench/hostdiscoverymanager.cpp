@@ -31,21 +31,68 @@
 
 #include "hostdiscoverymanager.h"
 #include "hostmodel.h"
+#include "ipc/discoverydatagram.h"
+
+#include <QUdpSocket>
+
+Q_DECLARE_LOGGING_CATEGORY(hdmLog)
+Q_LOGGING_CATEGORY(hdmLog, "QmlLive.Bench.HostDiscovery", QtInfoMsg)
+
+namespace {
+// Models are updated at most this often, no matter how many runtimes announce
+const int MODEL_UPDATE_INTERVAL = 500;
+const int EXPIRY_CHECK_INTERVAL = 1000;
+}
 
 HostDiscoveryManager::HostDiscoveryManager(QObject *parent) :
     QObject(parent) ,
+    m_socket(0),
+    m_updateTimer(new QTimer(this)),
+    m_expiryTimer(new QTimer(this)),
     m_discoverymodel(new HostModel(this)),
     m_knownhostsmodel(0)
 {
+    m_clock.start();
+
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(MODEL_UPDATE_INTERVAL);
+    connect(m_updateTimer, &QTimer::timeout, this, &HostDiscoveryManager::updateModels);
+
+    m_expiryTimer->setInterval(EXPIRY_CHECK_INTERVAL);
+    connect(m_expiryTimer, &QTimer::timeout, this, &HostDiscoveryManager::expireHosts);
+    m_expiryTimer->start();
+
+    rescan();
 }
 
 void HostDiscoveryManager::rescan()
 {
+    if (!m_socket && !listen())
+        return;
+
+    DiscoveryDatagram query;
+    query.type = DiscoveryDatagram::Query;
+    const QByteArray data = query.encode();
+    m_socket->writeDatagram(data, DiscoveryDatagram::defaultGroup(), DiscoveryDatagram::DefaultPort);
 }
 
 void HostDiscoveryManager::setKnownHostsModel(HostModel *model)
 {
+    if (m_knownhostsmodel)
+        disconnect(m_knownhostsmodel, 0, this, 0);
+
     m_knownhostsmodel = model;
+
+    if (m_knownhostsmodel) {
+        connect(m_knownhostsmodel, &HostModel::rowsInserted, this, &HostDiscoveryManager::onKnownHostsInserted);
+        // Known hosts restored from settings get reset into the model
+        connect(m_knownhostsmodel, &HostModel::modelReset, this, [this] {
+            foreach (const QUuid &id, m_hosts.keys())
+                scheduleUpdate(id);
+        });
+        foreach (const QUuid &id, m_hosts.keys())
+            scheduleUpdate(id);
+    }
 }
 
 HostModel *HostDiscoveryManager::knownHostsModel() const
@@ -58,67 +105,151 @@ HostModel *HostDiscoveryManager::discoveredHostsModel() const
     return m_discoverymodel;
 }
 
-void HostDiscoveryManager::deviceAdded(const QUuid &uuid, const QString &type, int version, const QString &domain)
+bool HostDiscoveryManager::listen()
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);
+    QUdpSocket *socket = new QUdpSocket(this);
+    if (!socket->bind(QHostAddress::AnyIPv4, DiscoveryDatagram::DefaultPort,
+                      QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)
+            || !socket->joinMulticastGroup(DiscoveryDatagram::defaultGroup())) {
+        qCWarning(hdmLog) << "Cannot listen for runtime announcements:" << socket->errorString();
+        delete socket;
+        return false;
+    }
+
+    m_socket = socket;
+    connect(m_socket, &QUdpSocket::readyRead, this, &HostDiscoveryManager::readDatagrams);
+    return true;
 }
 
-void HostDiscoveryManager::deviceChanged(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::readDatagrams()
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);
+    while (m_socket->hasPendingDatagrams()) {
+        QByteArray data;
+        data.resize(int(m_socket->pendingDatagramSize()));
+        QHostAddress sender;
+        if (m_socket->readDatagram(data.data(), data.size(), &sender) < 0)
+            continue;
+
+        DiscoveryDatagram datagram;
+        if (!datagram.decode(data))
+            continue;
+
+        switch (datagram.type) {
+        case DiscoveryDatagram::Announce:
+            announced(datagram, sender);
+            break;
+        case DiscoveryDatagram::Leave:
+            if (m_hosts.remove(datagram.id))
+                scheduleUpdate(datagram.id);
+            break;
+        }
+    }
 }
 
-void HostDiscoveryManager::deviceRemoved(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::announced(const DiscoveryDatagram &datagram, const QHostAddress &sender)
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);
+    QString address = sender.toString();
+    bool isIPv4 = false;
+    const QHostAddress ipv4(sender.toIPv4Address(&isIPv4));
+    if (isIPv4)
+        address = ipv4.toString();
+
+    auto it = m_hosts.find(datagram.id);
+    if (it == m_hosts.end()) {
+        it = m_hosts.insert(datagram.id, DiscoveredHost());
+        scheduleUpdate(datagram.id);
+    } else if (it->address != address || it->port != datagram.port
+               || it->productVersion != datagram.productVersion
+               || it->systemName != datagram.systemName
+               || it->manifestHash != datagram.manifestHash) {
+        scheduleUpdate(datagram.id);
+    }
+
+    it->address = address;
+    it->port = datagram.port;
+    it->productVersion = datagram.productVersion;
+    it->systemName = datagram.systemName;
+    it->manifestHash = datagram.manifestHash;
+    it->expires = m_clock.elapsed() + datagram.ttl;
 }
 
-void HostDiscoveryManager::serviceAdded(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::expireHosts()
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);}
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_hosts.begin(); it != m_hosts.end(); ) {
+        if (it->expires <= now) {
+            qCDebug(hdmLog) << "Runtime announcement expired:" << it->address << it->port;
+            scheduleUpdate(it.key());
+            it = m_hosts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-void HostDiscoveryManager::serviceChanged(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::scheduleUpdate(const QUuid &id)
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);}
+    m_changed.insert(id);
+    if (!m_updateTimer->isActive())
+        m_updateTimer->start();
+}
 
-void HostDiscoveryManager::serviceRemoved(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::updateModels()
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);}
+    foreach (const QUuid &id, m_changed) {
+        auto it = m_hosts.constFind(id);
+        const DiscoveredHost *discovered = it != m_hosts.constEnd() ? &it.value() : 0;
 
-void HostDiscoveryManager::updateHostFromExtraValues(Host *host, QMap<QString, QStringList> extraValues)
-{
-    Q_UNUSED(host);
-    Q_UNUSED(extraValues);
+        QList<Host *> hosts = m_discoverymodel->findByAutoDiscoveryId(id);
+        if (!discovered) {
+            foreach (Host *host, hosts)
+                m_discoverymodel->removeHost(host);
+        } else if (hosts.isEmpty()) {
+            Host *host = new Host(Host::AutoDiscovery, m_discoverymodel);
+            host->setAutoDiscoveryId(id);
+            host->setName(discovered->systemName.isEmpty()
+                          ? discovered->address
+                          : QString("%1 (%2)").arg(discovered->systemName, discovered->address));
+            updateHost(host, discovered);
+            m_discoverymodel->addHost(host);
+        } else {
+            foreach (Host *host, hosts)
+                updateHost(host, discovered);
+        }
+
+        if (m_knownhostsmodel) {
+            foreach (Host *host, m_knownhostsmodel->findByAutoDiscoveryId(id)) {
+                if (host->type() == Host::AutoDiscovery)
+                    updateHost(host, discovered);
+            }
+        }
+    }
+
+    m_changed.clear();
 }
 
-bool HostDiscoveryManager::checkExtraValues(QMap<QString, QStringList> extraValues)
+void HostDiscoveryManager::updateHost(Host *host, const DiscoveredHost *discovered)
 {
-    Q_UNUSED(extraValues);
-    return true;
+    if (!discovered) {
+        host->setOnline(false);
+        return;
+    }
+
+    host->setAddress(discovered->address);
+    host->setPort(discovered->port);
+    host->setProductVersion(discovered->productVersion);
+    host->setSystemName(discovered->systemName);
+    host->setManifestHash(discovered->manifestHash);
+    host->setOnline(true);
 }
 
-void HostDiscoveryManager::serviceAlive(const QUuid &uuid, const QString &type, int version, const QString &domain)
+void HostDiscoveryManager::onKnownHostsInserted(const QModelIndex &parent, int first, int last)
 {
-    Q_UNUSED(uuid);
-    Q_UNUSED(type);
-    Q_UNUSED(version);
-    Q_UNUSED(domain);
+    Q_UNUSED(parent);
+
+    for (int i = first; i <= last; ++i) {
+        Host *host = m_knownhostsmodel->hostAt(i);
+        if (host && host->type() == Host::AutoDiscovery && !host->autoDiscoveryId().isNull())
+            scheduleUpdate(host->autoDiscoveryId());
+    }
 }
@@ -33,9 +33,13 @@
 
 #include <QObject>
 #include <QtCore>
+#include <QHostAddress>
+
+QT_FORWARD_DECLARE_CLASS(QUdpSocket)
 
 class HostModel;
 class Host;
+struct DiscoveryDatagram;
 class HostDiscoveryManager : public QObject
 {
     Q_OBJECT
@@ -50,20 +54,33 @@ public:
     HostModel *discoveredHostsModel() const;
 
 private slots:
-    void deviceAdded(const QUuid &uuid, const QString &type, int version, const QString &domain);
-    void deviceChanged(const QUuid &uuid, const QString &type, int version, const QString &domain);
-    void deviceRemoved(const QUuid &uuid, const QString &type, int version, const QString &domain);
+    void readDatagrams();
+    void expireHosts();
+    void updateModels();
+    void onKnownHostsInserted(const QModelIndex &parent, int first, int last);
 
-    void serviceAdded(const QUuid &uuid, const QString &type, int version, const QString &domain);
-    void serviceChanged(const QUuid &uuid, const QString &type, int version, const QString &domain);
-    void serviceRemoved(const QUuid &uuid, const QString &type, int version, const QString &domain);
-    void serviceAlive(const QUuid &uuid, const QString &type, int version, const QString &domain);
+private:
+    struct DiscoveredHost {
+        QString address;
+        quint16 port;
+        QString productVersion;
+        QString systemName;
+        QByteArray manifestHash;
+        qint64 expires;
+    };
 
-    void updateHostFromExtraValues(Host *host, QMap<QString, QStringList> extraValues);
-    bool checkExtraValues(QMap<QString, QStringList> extraValues);
+    bool listen();
+    void announced(const DiscoveryDatagram &datagram, const QHostAddress &sender);
+    void scheduleUpdate(const QUuid &id);
+    void updateHost(Host *host, const DiscoveredHost *discovered);
+
+    QUdpSocket *m_socket;
+    QHash<QUuid, DiscoveredHost> m_hosts;
+    QSet<QUuid> m_changed;
+    QElapsedTimer m_clock;
+    QTimer *m_updateTimer;
+    QTimer *m_expiryTimer;
 
-private:
     HostModel* m_discoverymodel;
     HostModel* m_knownhostsmodel;
 };
-
@@ -34,15 +34,23 @@
 #include "hostwidget.h"
 #include "dummydelegate.h"
 #include "livehubengine.h"
+#include "ipc/multicastsender.h"
 #include "logreceiver.h"
 #include "widgets/logview.h"
 
 #include <QDockWidget>
 #include <QDebug>
 #include <QFileInfo>
+#include <QThread>
+
+namespace {
+const int NETWORK_THREAD_COUNT = 2;
+}
 
 HostManager::HostManager(QWidget *parent) :
-    QListView(parent)
+    QListView(parent),
+    m_multicastSender(0),
+    m_nextNetworkThread(0)
 {
     setFrameStyle(QFrame::StyledPanel);
     setAlternatingRowColors(false);
@@ -61,6 +69,32 @@ HostManager::HostManager(QWidget *parent) :
     setDropIndicatorShown(true);
 
     viewport()->setAutoFillBackground(false);
+
+    // Keep host transfers from blocking the UI and the local preview
+    for (int i = 0; i < NETWORK_THREAD_COUNT; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QStringLiteral("HostNetwork%1").arg(i));
+        thread->start();
+        m_networkThreads.append(thread);
+    }
+}
+
+HostManager::~HostManager()
+{
+    // Host connections release their sockets in the network threads
+    qDeleteAll(findChildren<HostWidget*>());
+
+    foreach (QThread *thread, m_networkThreads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+QThread *HostManager::nextNetworkThread()
+{
+    QThread *thread = m_networkThreads.at(m_nextNetworkThread);
+    m_nextNetworkThread = (m_nextNetworkThread + 1) % m_networkThreads.count();
+    return thread;
 }
 
 void HostManager::setModel(HostModel *model)
@@ -82,6 +116,26 @@ void HostManager::setLiveHubEngine(LiveHubEngine *engine)
     }
 }
 
+bool HostManager::setMulticastGroup(const QHostAddress &group, quint16 port)
+{
+    if (!m_multicastSender)
+        m_multicastSender = new MulticastSender(this);
+
+    if (!m_multicastSender->start(group, port)) {
+        qWarning() << "Cannot publish by multicast:" << m_multicastSender->errorString();
+        delete m_multicastSender;
+        m_multicastSender = 0;
+    }
+
+    for (int i=0; i < m_model->rowCount(); i++) {
+        HostWidget *widget = qobject_cast<HostWidget*>(indexWidget(m_model->index(i, 0)));
+        if (widget)
+            widget->setMulticastSender(m_multicastSender);
+    }
+
+    return m_multicastSender != 0;
+}
+
 void HostManager::followTreeSelection(const LiveDocument &currentFile)
 {
     if (!currentFile.isFileIn(m_engine->workspace()))
@@ -108,11 +162,31 @@ void HostManager::setCurrentFile(const LiveDocument &currentFile)
 
 void HostManager::publishAll()
 {
+    bool multicast = false;
+
     for (int i=0; i < m_model->rowCount(); i++) {
         HostWidget *widget = qobject_cast<HostWidget*>(indexWidget(m_model->index(i, 0)));
-        if (widget)
+        if (!widget)
+            continue;
+        if (widget->isMulticastJoined())
+            multicast = true;
+        else
             widget->publishWorkspace();
     }
+
+    // Send the workspace once for all hosts which joined the multicast group
+    if (multicast) {
+        connect(m_engine.data(), &LiveHubEngine::publishFile, this, &HostManager::multicastDocument);
+        m_engine->publishWorkspace();
+        disconnect(m_engine.data(), &LiveHubEngine::publishFile, this, &HostManager::multicastDocument);
+    }
+}
+
+void HostManager::multicastDocument(const LiveDocument &document)
+{
+    const QByteArray payload = m_engine->documentPayload(document);
+    if (!payload.isEmpty())
+        m_multicastSender->send(payload);
 }
 
 void HostManager::refreshAll()
@@ -149,9 +223,10 @@ void HostManager::rowsInserted(const QModelIndex &parent, int start, int end)
 
 void HostManager::addHost(int index)
 {
-    HostWidget *widget = new HostWidget();
+    HostWidget *widget = new HostWidget(nextNetworkThread());
     Host *host = m_model->hostAt(index);
     widget->setLiveHubEngine(m_engine.data());
+    widget->setMulticastSender(m_multicastSender);
     widget->setHost(host);
     setIndexWidget(m_model->index(index,0), widget);
     connect(widget, &HostWidget::openHostConfig, this, &HostManager::openHostConfig);
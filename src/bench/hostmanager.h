@@ -38,17 +38,23 @@ class LiveDocument;
 class LiveHubEngine;
 class HostModel;
 class Host;
+class MulticastSender;
+
+QT_FORWARD_DECLARE_CLASS(QHostAddress);
 
 QT_FORWARD_DECLARE_CLASS(QDockWidget);
+QT_FORWARD_DECLARE_CLASS(QThread);
 
 class HostManager : public QListView
 {
     Q_OBJECT
 public:
     explicit HostManager(QWidget *parent = 0);
+    ~HostManager();
 
     void setModel(HostModel* model);
     void setLiveHubEngine(LiveHubEngine* engine);
+    bool setMulticastGroup(const QHostAddress &group, quint16 port);
 
 signals:
     void logWidgetAdded(QDockWidget* log);
@@ -66,13 +72,19 @@ private slots:
     void rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end);
     void modelReseted();
     void addHost(int index);
+    void multicastDocument(const LiveDocument &document);
 
 private:
     using QListView::setModel;
 
+    QThread *nextNetworkThread();
+
     QPointer<LiveHubEngine> m_engine;
 
     HostModel* m_model;
     QList<QDockWidget*> m_logList;
+    MulticastSender *m_multicastSender;
+    QList<QThread*> m_networkThreads;
+    int m_nextNetworkThread;
 };
 
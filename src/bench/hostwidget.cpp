@@ -32,7 +32,9 @@
 #include "hostwidget.h"
 
 #include "host.h"
+#include "hostconnection.h"
 #include "livehubengine.h"
+#include "ipc/multicastsender.h"
 
 #include <QMessageBox>
 
@@ -42,8 +44,11 @@ Q_LOGGING_CATEGORY(csLog, "QmlLive.Bench.ConnectionState", QtInfoMsg)
 const int LABEL_STACK_INDEX=0;
 const int PROGRESS_STACK_INDEX=1;
 
-HostWidget::HostWidget(QWidget *parent) :
-    QWidget(parent)
+HostWidget::HostWidget(QThread *networkThread, QWidget *parent) :
+    QWidget(parent),
+    m_publisher(new HostConnection(networkThread, this)),
+    m_multicastJoined(false),
+    m_multicastSynced(0)
 {
     setContentsMargins(0,0,0,0);
     setAcceptDrops(true);
@@ -103,16 +108,18 @@ HostWidget::HostWidget(QWidget *parent) :
 
     vbox->addWidget(toolBar);;
 
-    connect(&m_publisher, &RemotePublisher::connected, this, &HostWidget::connected);
-    connect(&m_publisher, &RemotePublisher::connected, this, &HostWidget::onConnected);
-    connect(&m_publisher, &RemotePublisher::disconnected, this, &HostWidget::onDisconnected);
-    connect(&m_publisher, &RemotePublisher::connectionError, this, &HostWidget::onConnectionError);
-    connect(&m_publisher, &RemotePublisher::sendingError, this, &HostWidget::onSendingError);
-    connect(&m_publisher, &RemotePublisher::sentSuccessfully, this, &HostWidget::onSentSuccessfully);
-    connect(&m_publisher, &RemotePublisher::needsPinAuthentication, this, &HostWidget::showPinDialog);
-    connect(&m_publisher, &RemotePublisher::pinOk, this, &HostWidget::onPinOk);
-    connect(&m_publisher, &RemotePublisher::remoteLog, this, &HostWidget::remoteLog);
-    connect(&m_publisher, &RemotePublisher::clearLog, this, &HostWidget::clearLog);
+    connect(m_publisher, &HostConnection::connected, this, &HostWidget::connected);
+    connect(m_publisher, &HostConnection::connected, this, &HostWidget::onConnected);
+    connect(m_publisher, &HostConnection::disconnected, this, &HostWidget::onDisconnected);
+    connect(m_publisher, &HostConnection::connectionError, this, &HostWidget::onConnectionError);
+    connect(m_publisher, &HostConnection::sendingError, this, &HostWidget::onSendingError);
+    connect(m_publisher, &HostConnection::sentSuccessfully, this, &HostWidget::onSentSuccessfully);
+    connect(m_publisher, &HostConnection::needsPinAuthentication, this, &HostWidget::showPinDialog);
+    connect(m_publisher, &HostConnection::pinOk, this, &HostWidget::onPinOk);
+    connect(m_publisher, &HostConnection::remoteLog, this, &HostWidget::remoteLog);
+    connect(m_publisher, &HostConnection::clearLog, this, &HostWidget::clearLog);
+    connect(m_publisher, &HostConnection::multicastJoined, this, &HostWidget::onMulticastJoined);
+    connect(m_publisher, &HostConnection::multicastNack, this, &HostWidget::onMulticastNack);
 }
 
 void HostWidget::setHost(Host *host)
@@ -136,7 +143,7 @@ void HostWidget::setHost(Host *host)
     connect(host, &Host::followTreeSelectionChanged, this, &HostWidget::updateFollowTreeSelection);
 
     connect(m_followTreeSelectionAction, &QAction::triggered, host, &Host::setFollowTreeSelection);
-    connect(&m_publisher, &RemotePublisher::activeDocumentChanged, host, &Host::setCurrentFile);
+    connect(m_publisher, &HostConnection::activeDocumentChanged, host, &Host::setCurrentFile);
 
     updateAvailableState(m_host->available());
     updateRemoteActions();
@@ -146,22 +153,25 @@ void HostWidget::setLiveHubEngine(LiveHubEngine *engine)
 {
     m_engine = engine;
 
-    m_publisher.setWorkspace(m_engine->workspace());
+    m_publisher->setWorkspace(m_engine->workspace());
+    m_publisher->setPayloadSource(m_engine);
 
-    connect(m_engine.data(), &LiveHubEngine::workspaceChanged, &m_publisher, &RemotePublisher::setWorkspace);
+    connect(m_engine.data(), &LiveHubEngine::workspaceChanged, m_publisher, &HostConnection::setWorkspace);
     connect(m_engine.data(), &LiveHubEngine::workspaceChanged, this, &HostWidget::refreshDocumentLabel);
     connect(m_engine.data(), &LiveHubEngine::fileChanged, this, &HostWidget::sendDocument);
-    connect(m_engine.data(), &LiveHubEngine::beginPublishWorkspace, &m_publisher, &RemotePublisher::beginBulkSend);
-    connect(m_engine.data(), &LiveHubEngine::endPublishWorkspace, &m_publisher, &RemotePublisher::endBulkSend);
-    connect(&m_publisher, &RemotePublisher::needsPublishWorkspace, this, &HostWidget::publishWorkspace);
+    connect(m_engine.data(), &LiveHubEngine::prefetchDocuments, this, &HostWidget::sendPrefetchHints);
+    connect(m_engine.data(), &LiveHubEngine::beginPublishWorkspace, m_publisher, &HostConnection::beginBulkSend);
+    connect(m_engine.data(), &LiveHubEngine::endPublishWorkspace, this, &HostWidget::onEndPublishWorkspace);
+    connect(m_publisher, &HostConnection::needsPublishWorkspace, this, &HostWidget::onNeedsPublishWorkspace);
+    connect(m_engine.data(), &LiveHubEngine::manifestHashReady, this, &HostWidget::onManifestHashReady);
 }
 
 void HostWidget::setCurrentFile(const LiveDocument &currentFile)
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         return;
 
-    m_publisher.activateDocument(currentFile);
+    m_publisher->activateDocument(currentFile);
 }
 
 bool HostWidget::followTreeSelection() const
@@ -169,6 +179,19 @@ bool HostWidget::followTreeSelection() const
     return m_followTreeSelectionAction->isChecked();
 }
 
+void HostWidget::setMulticastSender(MulticastSender *sender)
+{
+    m_multicastSender = sender;
+
+    if (m_publisher->state() == QAbstractSocket::ConnectedState)
+        joinMulticast();
+}
+
+bool HostWidget::isMulticastJoined() const
+{
+    return m_multicastJoined && m_multicastSender;
+}
+
 void HostWidget::updateTitle()
 {
     m_groupBox->setTitle(QString("%1 (%2:%3)")
@@ -185,7 +208,7 @@ void HostWidget::updateFile(const LiveDocument &file)
     QString toolTip;
 
     if (file.isNull()) {
-        if (m_publisher.state() != QAbstractSocket::ConnectedState) {
+        if (m_publisher->state() != QAbstractSocket::ConnectedState) {
             text = tr("Host offline");
         } else {
             text = tr("No active document");
@@ -212,8 +235,8 @@ void HostWidget::updateFile(const LiveDocument &file)
     m_documentLabel->setToolTip(toolTip);
 
     if (m_host->followTreeSelection() && !file.isNull() && file != m_engine->activePath()) {
-        if (m_publisher.state() == QAbstractSocket::ConnectedState)
-            m_publisher.activateDocument(m_engine->activePath());
+        if (m_publisher->state() == QAbstractSocket::ConnectedState)
+            m_publisher->activateDocument(m_engine->activePath());
     }
 
     updateRemoteActions();
@@ -238,17 +261,17 @@ void HostWidget::updateFollowTreeSelection(bool follow)
 {
     m_followTreeSelectionAction->setChecked(follow);
 
-    if (follow && m_publisher.state() == QAbstractSocket::ConnectedState
+    if (follow && m_publisher->state() == QAbstractSocket::ConnectedState
             && m_host->currentFile() != m_engine->activePath()) {
-        m_publisher.activateDocument(m_engine->activePath());
+        m_publisher->activateDocument(m_engine->activePath());
     }
 }
 
 void HostWidget::updateRemoteActions()
 {
-    m_refreshAction->setEnabled(m_publisher.state() == QAbstractSocket::ConnectedState
+    m_refreshAction->setEnabled(m_publisher->state() == QAbstractSocket::ConnectedState
                                 && !m_host->currentFile().isNull());
-    m_publishAction->setEnabled(m_publisher.state() == QAbstractSocket::ConnectedState);
+    m_publishAction->setEnabled(m_publisher->state() == QAbstractSocket::ConnectedState);
 }
 
 void HostWidget::scheduleConnectToServer()
@@ -261,13 +284,13 @@ void HostWidget::scheduleConnectToServer()
 void HostWidget::connectToServer()
 {
     qCDebug(csLog) << "connectToServer()" << m_host->name()
-                   << m_publisher.state() << "available:" << m_host->available();
+                   << m_publisher->state() << "available:" << m_host->available();
 
-    if (m_publisher.state() != QAbstractSocket::UnconnectedState)
+    if (m_publisher->state() != QAbstractSocket::UnconnectedState)
         return;
 
     if (m_host->available()) {
-        m_publisher.connectToServer(m_host->address(), m_host->port());
+        m_publisher->connectToServer(m_host->address(), m_host->port());
         m_activateId = QUuid();
         m_rotationId = QUuid();
         m_xOffsetId = QUuid();
@@ -292,7 +315,7 @@ void HostWidget::onConnected()
     sendRotation(m_host->rotation());
 
     disconnect(m_connectDisconnectAction, &QAction::triggered, 0, 0);
-    connect(m_connectDisconnectAction, &QAction::triggered, &m_publisher, &RemotePublisher::disconnectFromServer);
+    connect(m_connectDisconnectAction, &QAction::triggered, m_publisher, &HostConnection::disconnectFromServer);
 
     // Send .qrc files to let the node fill its resourceMap
     // TODO not using bulkSend as this could be misinterpreted as a response to
@@ -304,7 +327,9 @@ void HostWidget::onConnected()
         sendDocument(qrcFile);
     }
 
-    m_publisher.initComplete();
+    joinMulticast();
+
+    m_publisher->initComplete();
 }
 
 void HostWidget::onDisconnected()
@@ -319,6 +344,8 @@ void HostWidget::onDisconnected()
     m_host->setCurrentFile(LiveDocument());
     updateRemoteActions();
 
+    m_multicastJoined = false;
+
     disconnect(m_connectDisconnectAction, &QAction::triggered, 0, 0);
     connect(m_connectDisconnectAction, &QAction::triggered, this, &HostWidget::connectToServer);
 }
@@ -327,23 +354,27 @@ void HostWidget::onConnectionError(QAbstractSocket::SocketError error)
 {
     qCDebug(csLog) << "Host connection error:" << m_host->name() << error;
 
-    m_connectDisconnectAction->setToolTip(m_publisher.errorToString(error));
+    m_connectDisconnectAction->setToolTip(m_publisher->errorToString(error));
     m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
 
     if (error == QAbstractSocket::RemoteHostClosedError)
         m_host->setOnline(false);
 
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         onDisconnected();
 }
 
 void HostWidget::refresh()
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
+        return;
+
+    if (m_host->currentFile().isNull())
         return;
 
-    if (!m_host->currentFile().isNull())
-        m_publisher.activateDocument(m_host->currentFile());
+    // Runtimes skip activating the same unchanged document, older ones ignore the reload
+    m_publisher->activateDocument(m_host->currentFile());
+    m_publisher->reloadDocument();
 }
 
 void HostWidget::probe()
@@ -353,7 +384,7 @@ void HostWidget::probe()
 
 void HostWidget::publishWorkspace()
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         return;
 
     connect(m_engine.data(), &LiveHubEngine::publishFile, this, &HostWidget::sendDocument);
@@ -361,51 +392,97 @@ void HostWidget::publishWorkspace()
     disconnect(m_engine.data(), &LiveHubEngine::publishFile, this, &HostWidget::sendDocument);
 }
 
+void HostWidget::onNeedsPublishWorkspace(const QByteArray &manifestHash)
+{
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
+        return;
+
+    if (manifestHash.isEmpty()) {
+        publishWorkspace();
+        return;
+    }
+
+    // Compared once the hub computed its own, see onManifestHashReady()
+    m_hostManifestHash = manifestHash;
+    m_engine->requestManifestHash();
+}
+
+void HostWidget::onManifestHashReady(const QByteArray &hash)
+{
+    if (m_hostManifestHash.isEmpty())
+        return;
+
+    const bool upToDate = hash == m_hostManifestHash;
+    m_hostManifestHash.clear();
+
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
+        return;
+
+    // The runtime reported it has the same workspace content already
+    if (upToDate) {
+        qCDebug(csLog) << "Host workspace is up to date, skipping publishing:" << m_host->name();
+        m_publisher->beginBulkSend();
+        m_publisher->endBulkSend();
+        return;
+    }
+
+    publishWorkspace();
+}
+
 void HostWidget::sendDocument(const LiveDocument& document)
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         return;
 
     m_stackedLayout->setCurrentIndex(PROGRESS_STACK_INDEX);
-    m_changeIds.append(m_publisher.sendDocument(document));
+    m_changeIds.append(m_publisher->sendDocument(document));
     m_sendProgress->setMaximum(m_sendProgress->maximum() + 1);
 }
 
+void HostWidget::sendPrefetchHints(const QStringList &documents)
+{
+    // Hints are about the tree selection, which only following hosts activate
+    if (m_publisher->state() != QAbstractSocket::ConnectedState || !followTreeSelection())
+        return;
+
+    m_publisher->prefetchDocuments(documents);
+}
+
 void HostWidget::sendXOffset(int offset)
 {
-    m_xOffsetId = m_publisher.setXOffset(offset);
+    m_xOffsetId = m_publisher->setXOffset(offset);
 }
 
 void HostWidget::sendYOffset(int offset)
 {
-    m_yOffsetId = m_publisher.setYOffset(offset);
+    m_yOffsetId = m_publisher->setYOffset(offset);
 }
 
 void HostWidget::sendRotation(int rotation)
 {
-    m_rotationId = m_publisher.setRotation(rotation);
+    m_rotationId = m_publisher->setRotation(rotation);
 }
 
 void HostWidget::onSendingError(const QUuid &uuid, QAbstractSocket::SocketError socketError)
 {
     if (uuid == m_activateId) {
-        m_connectDisconnectAction->setToolTip(QString("Activating file failed: %1").arg(m_publisher.errorToString(socketError)));
+        m_connectDisconnectAction->setToolTip(QString("Activating file failed: %1").arg(m_publisher->errorToString(socketError)));
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_activateId = QUuid();
     } else if (uuid == m_xOffsetId) {
-        m_connectDisconnectAction->setToolTip(QString("Setting the X Offset failed: %1").arg(m_publisher.errorToString(socketError)));
+        m_connectDisconnectAction->setToolTip(QString("Setting the X Offset failed: %1").arg(m_publisher->errorToString(socketError)));
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_xOffsetId = QUuid();
     } else if (uuid == m_yOffsetId) {
-        m_connectDisconnectAction->setToolTip(QString("Setting the Y Offset failed: %1").arg(m_publisher.errorToString(socketError)));
+        m_connectDisconnectAction->setToolTip(QString("Setting the Y Offset failed: %1").arg(m_publisher->errorToString(socketError)));
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_yOffsetId = QUuid();
     } else if (uuid == m_rotationId) {
-        m_connectDisconnectAction->setToolTip(QString("Setting the Rotation failed: %1").arg(m_publisher.errorToString(socketError)));
+        m_connectDisconnectAction->setToolTip(QString("Setting the Rotation failed: %1").arg(m_publisher->errorToString(socketError)));
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_rotationId = QUuid();
     } else if (m_changeIds.contains(uuid)) {
-        m_connectDisconnectAction->setToolTip(QString("Not all files were synced successfully: %1").arg(m_publisher.errorToString(socketError)));
+        m_connectDisconnectAction->setToolTip(QString("Not all files were synced successfully: %1").arg(m_publisher->errorToString(socketError)));
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_changeIds.removeAll(uuid);
         resetProgressBar();
@@ -446,13 +523,65 @@ void HostWidget::resetProgressBar()
 void HostWidget::onPinOk(bool ok)
 {
     if (!ok) {
-        m_publisher.disconnectFromServer();
+        m_publisher->disconnectFromServer();
         m_connectDisconnectAction->setIcon(QIcon(":images/warning_ball.svg"));
         m_connectDisconnectAction->setToolTip("The Host didn't accept your pin");
         QMessageBox::warning(this, "Pin not accepted", "The Host didn't accept your pin");
     }
 }
 
+void HostWidget::joinMulticast()
+{
+    m_multicastJoined = false;
+
+    if (!m_multicastSender || !m_multicastSender->isActive())
+        return;
+
+    // Earlier datagrams will not be waited for
+    m_multicastSynced = m_multicastSender->nextSequence();
+    m_publisher->joinMulticast(m_multicastSender->group().toString(), m_multicastSender->port(),
+                               m_multicastSender->session(), m_multicastSender->key(), m_multicastSynced);
+}
+
+void HostWidget::syncMulticast()
+{
+    if (!isMulticastJoined() || m_multicastSender->nextSequence() == m_multicastSynced)
+        return;
+
+    m_multicastSynced = m_multicastSender->nextSequence();
+    m_publisher->multicastBarrier(m_multicastSynced - 1);
+}
+
+void HostWidget::onMulticastJoined(bool ok)
+{
+    qCDebug(csLog) << "Host joined multicast group:" << m_host->name() << ok;
+
+    m_multicastJoined = ok;
+}
+
+void HostWidget::onMulticastNack(const QList<quint32> &sequences)
+{
+    if (!isMulticastJoined())
+        return;
+
+    const QList<quint32> unavailable = m_multicastSender->resend(sequences);
+    if (unavailable.isEmpty())
+        return;
+
+    qCDebug(csLog) << "Multicast datagrams lost for good, publishing workspace directly:" << m_host->name();
+
+    m_multicastSynced = m_multicastSender->nextSequence();
+    m_publisher->abandonMulticast(m_multicastSynced - 1);
+    publishWorkspace();
+}
+
+void HostWidget::onEndPublishWorkspace()
+{
+    // Let the node receive all multicast documents before ending the bulk update
+    syncMulticast();
+    m_publisher->endBulkSend();
+}
+
 void HostWidget::publishAll()
 {
     if (QMessageBox::question(this, QString("Publish %1").arg(m_engine->workspace()),
@@ -479,14 +608,14 @@ void HostWidget::showPinDialog()
     int pin = QInputDialog::getInt(this, "The Host needs a Pin Authentication", "Pin", 0, 0, 9999, 1, &ok);
 
     if (!ok)
-        m_publisher.disconnectFromServer();
+        m_publisher->disconnectFromServer();
 
-    m_publisher.checkPin(QString::number(pin));
+    m_publisher->checkPin(QString::number(pin));
 }
 
 void HostWidget::dragEnterEvent(QDragEnterEvent *event)
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         return;
 
     if (event->mimeData()->hasUrls())
@@ -495,7 +624,7 @@ void HostWidget::dragEnterEvent(QDragEnterEvent *event)
 
 void HostWidget::dropEvent(QDropEvent *event)
 {
-    if (m_publisher.state() != QAbstractSocket::ConnectedState)
+    if (m_publisher->state() != QAbstractSocket::ConnectedState)
         return;
 
     event->acceptProposedAction();
@@ -506,7 +635,7 @@ void HostWidget::dropEvent(QDropEvent *event)
         if (!document.isNull() && document.isFileIn(m_engine->workspace())) {
             if (m_host->followTreeSelection() && document != m_engine->activePath())
                 m_host->setFollowTreeSelection(false);
-            m_publisher.activateDocument(document);
+            m_publisher->activateDocument(document);
         } else {
             QMessageBox::warning(this, tr("Not a workspace document"),
                     tr("The dropped document is not a file in the current workspace:<br/>%1")
@@ -32,22 +32,27 @@
 #pragma once
 
 #include <QtWidgets>
-#include <remotepublisher.h>
+#include <QAbstractSocket>
 
 class Host;
+class HostConnection;
 class LiveDocument;
+class LiveHubEngine;
+class MulticastSender;
 
 class HostWidget : public QWidget
 {
     Q_OBJECT
 public:
 
-    explicit HostWidget(QWidget *parent = 0);
+    explicit HostWidget(QThread *networkThread = 0, QWidget *parent = 0);
 
     void setHost(Host* host);
     void setLiveHubEngine(LiveHubEngine* engine);
     void setCurrentFile(const LiveDocument &currentFile);
     bool followTreeSelection() const;
+    void setMulticastSender(MulticastSender *sender);
+    bool isMulticastJoined() const;
 
 signals:
     void connected();
@@ -81,7 +86,10 @@ private slots:
     void onDisconnected();
     void onConnectionError(QAbstractSocket::SocketError error);
 
+    void onNeedsPublishWorkspace(const QByteArray &manifestHash);
+    void onManifestHashReady(const QByteArray &hash);
     void sendDocument(const LiveDocument &document);
+    void sendPrefetchHints(const QStringList &documents);
 
     void sendXOffset(int offset);
     void sendYOffset(int offset);
@@ -94,11 +102,18 @@ private slots:
     void showPinDialog();
     void onPinOk(bool ok);
 
+    void onMulticastJoined(bool ok);
+    void onMulticastNack(const QList<quint32> &sequences);
+    void onEndPublishWorkspace();
+
     void publishAll();
     void onEditHost();
 
     void resizeEvent( QResizeEvent * event );
 private:
+    void joinMulticast();
+    void syncMulticast();
+
     QStackedLayout *m_stackedLayout;
 
     QGroupBox* m_groupBox;
@@ -116,9 +131,13 @@ private:
 
     QPointer<Host> m_host;
 
-    RemotePublisher m_publisher;
+    HostConnection *m_publisher;
     QPointer<LiveHubEngine> m_engine;
     QBasicTimer m_connectToServerTimer;
+    QPointer<MulticastSender> m_multicastSender;
+    bool m_multicastJoined;
+    quint32 m_multicastSynced;
+    QByteArray m_hostManifestHash;
 
     QUuid m_activateId;
     QList<QUuid> m_changeIds;
@@ -33,6 +33,7 @@
 
 #include <QtGui>
 #include <QtWidgets>
+#include <QtNetwork/QHostAddress>
 
 #include "hostmanager.h"
 #include "hostmodel.h"
@@ -239,6 +240,9 @@ void Application::parseArguments(const QStringList &arguments, Options *options)
     parser.addOption(pingOption);
     QCommandLineOption maxWatchesOption("maxdirwatch", "limit the number of directories to watch for changes", "number", QString::number(options->maximumWatches()));
     parser.addOption(maxWatchesOption);
+    QCommandLineOption multicastOption("multicast", "publish the workspace to all hosts accepting multicast "
+                                       "at once using the given multicast group", "address:port");
+    parser.addOption(multicastOption);
 
     parser.process(arguments);
 
@@ -303,6 +307,19 @@ void Application::parseArguments(const QStringList &arguments, Options *options)
         }
     }
 
+    if (parser.isSet(multicastOption)) {
+        const QString value = parser.value(multicastOption);
+        const int colon = value.lastIndexOf(QLatin1Char(':'));
+        bool ok = false;
+        const int port = value.mid(colon + 1).toInt(&ok);
+        if (colon <= 0 || !ok || port <= 0 || port > 65535
+                || !QHostAddress(value.left(colon)).isMulticast()) {
+            qWarning() << "Invalid multicast group: " << value;
+            parser.showHelp(-1);
+        }
+        options->setMulticastGroup(value.left(colon), port);
+    }
+
     options->setHostsToRemove(parser.values(rmHostOption));
     options->setHostsToProbe(parser.values(probeHostOption));
 
@@ -478,6 +495,11 @@ void MasterApplication::applyOptions(const Options &options)
         m_window->setStaysOnTop(true);
     }
 
+    if (!options.multicastAddress().isEmpty()) {
+        m_window->hostManager()->setMulticastGroup(QHostAddress(options.multicastAddress()),
+                                                   options.multicastPort());
+    }
+
     auto withHostModel = [this](std::function<void(HostModel *)> f) {
         QSettings s;
         HostModel *hostModel;
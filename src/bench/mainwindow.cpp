@@ -116,6 +116,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     m_hub->setFilePublishingActive(true);
     m_node->setWorkspaceView(m_workspace);
+    m_workspace->setWorkspaceTree(m_hub->workspaceTree());
 
     connect(m_workspace, &WorkspaceView::pathActivated, m_hub, &LiveHubEngine::setActivePath);
     connect(m_workspace, &WorkspaceView::pathActivated, m_hostManager, &HostManager::followTreeSelection);
@@ -461,7 +462,6 @@ void MainWindow::slowDownAnimations(bool enable)
 void MainWindow::setWorkspace(const QString& path, bool activateRootPath)
 {
     m_workspacePath = path;
-    m_workspace->setRootPath(path);
     m_node->setWorkspace(path);
     m_hub->setWorkspace(path);
     m_allHosts->setWorkspace(path);
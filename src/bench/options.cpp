@@ -38,6 +38,7 @@ Options::Options(QObject *parent)
     , m_ping(false)
     , m_stayOnTop(false)
     , m_maximumWatches(100)
+    , m_multicastPort(0)
 {
 
 }
@@ -188,3 +189,19 @@ void Options::setMaximumWatches(int maximumWatches)
 {
     m_maximumWatches = maximumWatches;
 }
+
+QString Options::multicastAddress() const
+{
+    return m_multicastAddress;
+}
+
+int Options::multicastPort() const
+{
+    return m_multicastPort;
+}
+
+void Options::setMulticastGroup(const QString &address, int port)
+{
+    m_multicastAddress = address;
+    m_multicastPort = port;
+}
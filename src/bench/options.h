@@ -89,6 +89,10 @@ public:
     int maximumWatches() const;
     void setMaximumWatches(int maximumWatches);
 
+    QString multicastAddress() const;
+    int multicastPort() const;
+    void setMulticastGroup(const QString &address, int port);
+
 private:
     bool m_noRemote;
     bool m_remoteOnly;
@@ -102,5 +106,7 @@ private:
     QStringList m_hostsToRemove;
     QStringList m_hostsToProbe;
     int m_maximumWatches;
+    QString m_multicastAddress;
+    int m_multicastPort;
 };
 
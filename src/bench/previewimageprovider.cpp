@@ -30,6 +30,7 @@
 ****************************************************************************/
 
 #include "previewimageprovider.h"
+#include "previewscheduler.h"
 #include "contentadapterinterface.h"
 
 #include <QDebug>
@@ -37,43 +38,159 @@
 #include <QPainter>
 
 
-class CacheImage {
-public:
-    QImage image;
-    QDateTime time;
-};
-
-typedef QHash<QString, CacheImage> ImageHash;
 typedef QHash<QString, QImage> QImageHash;
 
-Q_GLOBAL_STATIC(ImageHash, imageCache)
 Q_GLOBAL_STATIC(QImageHash, iconCache)
 
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+class PreviewImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    PreviewImageResponse(PreviewImageProvider *provider, const QString &id, const QSize &requestedSize)
+        : m_provider(provider)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+        , m_canceled(0)
+        , m_done(0)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    void run()
+    {
+        if (m_canceled.load()) {
+            done(QImage());
+            return;
+        }
+
+        QImage image;
+        if (m_provider->cachedImage(m_id, m_requestedSize, &image)) {
+            done(image);
+            return;
+        }
+
+        PreviewScheduler *scheduler = m_provider->scheduler();
+        if (scheduler && scheduler->canPreview(m_id) && m_requestedSize.isValid()) {
+            PreviewRequestPtr request(new PreviewRequest(m_id, m_requestedSize));
+            connect(request.data(), &PreviewRequest::finished,
+                    this, &PreviewImageResponse::onPreviewFinished, Qt::DirectConnection);
+            bool canceled;
+            {
+                QMutexLocker m(&m_mutex);
+                m_scheduler = scheduler;
+                m_request = request;
+                canceled = m_canceled.load();
+            }
+            // Otherwise cancel() takes care of it
+            if (canceled)
+                scheduler->cancel(request);
+            // The response may be deleted as soon as the request finishes, so
+            // nothing may touch it from here on
+            scheduler->enqueue(request);
+            return;
+        }
+
+        QSize size;
+        done(m_provider->requestImage(m_id, &size, m_requestedSize));
+    }
+
+    void cancel()
+    {
+        m_canceled.store(1);
+
+        QMutexLocker m(&m_mutex);
+        if (m_request && m_scheduler)
+            m_scheduler->cancel(m_request);
+    }
+
+private:
+    void onPreviewFinished()
+    {
+        QImage image;
+        {
+            QMutexLocker m(&m_mutex);
+            image = m_request->image();
+        }
+
+        if (!image.isNull()) {
+            m_provider->cacheImage(m_id, m_requestedSize, image);
+        } else if (!m_canceled.load()) {
+            qWarning() << "Failed to generate Preview";
+            image = QImage("://livert/no.png");
+        }
+
+        done(image);
+    }
+
+    // The reader deletes the response once finished is emitted, which has to happen exactly once
+    void done(const QImage &image)
+    {
+        if (!m_done.testAndSetOrdered(0, 1))
+            return;
+
+        m_image = image;
+        emit finished();
+    }
+
+    PreviewImageProvider *m_provider;
+    const QString m_id;
+    const QSize m_requestedSize;
+    QAtomicInt m_canceled;
+    QAtomicInt m_done;
+    QImage m_image;
+
+    QMutex m_mutex;
+    QPointer<PreviewScheduler> m_scheduler;
+    PreviewRequestPtr m_request;
+};
+#endif
+
 PreviewImageProvider::PreviewImageProvider(QObject *engine)
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+    : QQuickAsyncImageProvider()
+#else
     : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
+#endif
     , m_engine(engine)
     , m_ignoreCache(false)
 {
 }
 
+PreviewImageProvider::~PreviewImageProvider()
+{
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+    m_pool.waitForDone();
+#endif
+}
+
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+QQuickImageResponse *PreviewImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    PreviewImageResponse *response = new PreviewImageResponse(this, id, requestedSize);
+    m_pool.start(response);
+    return response;
+}
+#endif
+
 QImage PreviewImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
     Q_ASSERT(size);
     QFileInfo info(id);
-    info.refresh();
     QList<ContentAdapterInterface*> plugins;
-    QString hashKey = id + QString("%1x%2").arg(QString::number(requestedSize.width())).arg(QString::number(requestedSize.height()));
+
+    QImage cached;
+    if (cachedImage(id, requestedSize, &cached)) {
+        *size = cached.size();
+        return cached;
+    }
 
     {
         QMutexLocker m(&m_mutex);
-        if (!m_ignoreCache && imageCache()->contains(hashKey)) {
-            CacheImage i = imageCache()->value(hashKey);
-            if (info.lastModified() <= i.time) {
-                *size = i.image.size();
-                return i.image;
-            }
-        }
-
         plugins = m_plugins;
     }
 
@@ -81,10 +198,7 @@ QImage PreviewImageProvider::requestImage(const QString &id, QSize *size, const
         if (plugin->canPreview(id)) {
             QImage img = plugin->preview(id, requestedSize);
             *size = img.size();
-            CacheImage i;
-            i.image = img;
-            i.time = info.lastModified();
-            imageCache()->insert(hashKey, i);
+            cacheImage(id, requestedSize, img);
 
             return img;
         }
@@ -97,8 +211,12 @@ QImage PreviewImageProvider::requestImage(const QString &id, QSize *size, const
     if (!iconSize.isValid() || iconSize.isNull())
         iconSize = QSize(512, 512);
 
-    if (iconCache()->contains(type)) {
+    {
+        QMutexLocker m(&m_mutex);
         img = iconCache()->value(type);
+    }
+
+    if (!img.isNull()) {
         *size = img.size();
     } else if (m_engine){
         QMetaObject::invokeMethod(m_engine, "convertIconToImage",
@@ -106,6 +224,7 @@ QImage PreviewImageProvider::requestImage(const QString &id, QSize *size, const
                                   Q_RETURN_ARG(QImage, img),
                                   Q_ARG(QFileInfo, info),
                                   Q_ARG(QSize, iconSize));
+        QMutexLocker m(&m_mutex);
         iconCache()->insert(type, img);
         *size = iconSize;
     }
@@ -119,6 +238,18 @@ void PreviewImageProvider::setPlugins(QList<ContentAdapterInterface *> plugins)
     m_plugins = plugins;
 }
 
+void PreviewImageProvider::setScheduler(PreviewScheduler *scheduler)
+{
+    QMutexLocker m(&m_mutex);
+    m_scheduler = scheduler;
+}
+
+PreviewScheduler *PreviewImageProvider::scheduler()
+{
+    QMutexLocker m(&m_mutex);
+    return m_scheduler;
+}
+
 void PreviewImageProvider::setIgnoreCache(bool enabled)
 {
     QMutexLocker m(&m_mutex);
@@ -130,3 +261,16 @@ bool PreviewImageProvider::ignoreCache()
     QMutexLocker m(&m_mutex);
     return m_ignoreCache;
 }
+
+bool PreviewImageProvider::cachedImage(const QString &id, const QSize &requestedSize, QImage *image)
+{
+    if (ignoreCache())
+        return false;
+
+    return m_cache.find(id, requestedSize, image);
+}
+
+void PreviewImageProvider::cacheImage(const QString &id, const QSize &requestedSize, const QImage &image)
+{
+    m_cache.insert(id, requestedSize, image);
+}
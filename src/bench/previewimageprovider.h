@@ -35,25 +35,54 @@
 #include <QMutex>
 #include <QHash>
 #include <QDateTime>
+#include <QPointer>
+#include <QThreadPool>
+
+#include "thumbnailcache.h"
+
+// Previews are generated concurrently and can be canceled once no longer needed
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+#define PREVIEW_IMAGE_PROVIDER_ASYNC
+#endif
 
 class ContentAdapterInterface;
-class PreviewImageProvider : public QObject, public QQuickImageProvider
+class PreviewScheduler;
+class PreviewImageProvider : public QObject,
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+        public QQuickAsyncImageProvider
+#else
+        public QQuickImageProvider
+#endif
 {
     Q_OBJECT
 
 public:
     explicit PreviewImageProvider(QObject *engine);
+    ~PreviewImageProvider();
 
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize);
+#endif
     QImage requestImage (const QString& id, QSize* size, const QSize& requestedSize);
 
     void setPlugins(QList<ContentAdapterInterface*> plugins);
+    void setScheduler(PreviewScheduler *scheduler);
+    PreviewScheduler *scheduler();
     void setIgnoreCache(bool enabled);
     bool ignoreCache();
 
+    bool cachedImage(const QString &id, const QSize &requestedSize, QImage *image);
+    void cacheImage(const QString &id, const QSize &requestedSize, const QImage &image);
+
 private:
 
     QList<ContentAdapterInterface*> m_plugins;
+    QPointer<PreviewScheduler> m_scheduler;
     QMutex m_mutex;
     QObject* m_engine;
     bool m_ignoreCache;
+    ThumbnailCache m_cache;
+#ifdef PREVIEW_IMAGE_PROVIDER_ASYNC
+    QThreadPool m_pool;
+#endif
 };
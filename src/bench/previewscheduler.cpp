@@ -0,0 +1,579 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "previewscheduler.h"
+#include "../previewGenerator/previewprotocol.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QSharedMemory>
+#include <QTimer>
+
+namespace {
+// A second request is queued in the generator while it grabs the first one
+const int MAX_REQUESTS_PER_WORKER = 2;
+// A generator not answering for this long is considered stuck and restarted
+const int REQUEST_TIMEOUT = 10000;
+// A worker is given up after its generator failed to start this many times in a row
+const int MAX_START_FAILURES = 3;
+// Shared memory segments are allocated in steps of this size to make reusing them likely
+const int SEGMENT_GRANULARITY = 64 * 1024;
+}
+
+class PreviewWorker;
+
+class PreviewDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    PreviewDispatcher();
+    ~PreviewDispatcher();
+
+    int workerCount() const;
+    void setWorkerCount(int count);
+    QProcessEnvironment environment() const;
+    void setEnvironment(const QProcessEnvironment &environment);
+
+    void enqueue(const PreviewRequestPtr &request);
+    void wake();
+
+public slots:
+    void dispatch();
+
+private:
+    mutable QMutex m_mutex;
+    QList<PreviewRequestPtr> m_pending;
+    int m_workerCount;
+    QProcessEnvironment m_environment;
+
+    // Accessed in the dispatcher thread only
+    QList<PreviewWorker *> m_workers;
+};
+
+class PreviewWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PreviewWorker(PreviewDispatcher *dispatcher);
+    ~PreviewWorker();
+
+    bool isRunning() const { return m_process->state() != QProcess::NotRunning; }
+    bool isReady() const { return m_socket->state() == QLocalSocket::ConnectedState; }
+    bool isDisabled() const { return m_startFailures >= MAX_START_FAILURES; }
+    int load() const { return m_requests.count(); }
+
+    void start(const QProcessEnvironment &environment);
+    void send(const PreviewRequestPtr &request);
+    void sendCancels();
+
+private slots:
+    void onReadyReadOutput();
+    void onConnected();
+    void onReadyRead();
+    void onProcessStateChanged(QProcess::ProcessState state);
+    void checkTimeout();
+
+private:
+    void failRequests();
+    QSharedMemory *acquireSegment(int size);
+    void releaseSegment(QSharedMemory *segment);
+
+    PreviewDispatcher *m_dispatcher;
+    QProcess *m_process;
+    QLocalSocket *m_socket;
+    QTimer *m_timeoutTimer;
+    QElapsedTimer m_lastProgress;
+    QByteArray m_output;
+    quint32 m_nextId;
+    QMap<quint32, PreviewRequestPtr> m_requests;
+    QSet<quint32> m_canceling;
+    // Segments the generator writes the previews of in-flight requests to
+    QHash<quint32, QSharedMemory *> m_segments;
+    QList<QSharedMemory *> m_freeSegments;
+    bool m_sharedMemoryAvailable;
+    bool m_connected;
+    int m_startFailures;
+};
+
+PreviewRequest::PreviewRequest(const QString &path, const QSize &requestedSize)
+    : m_path(path)
+    , m_requestedSize(requestedSize)
+    , m_canceled(0)
+    , m_finished(false)
+{
+}
+
+QString PreviewRequest::path() const
+{
+    return m_path;
+}
+
+QSize PreviewRequest::requestedSize() const
+{
+    return m_requestedSize;
+}
+
+QImage PreviewRequest::image() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_image;
+}
+
+bool PreviewRequest::isFinished() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_finished;
+}
+
+bool PreviewRequest::isCanceled() const
+{
+    return m_canceled.load() != 0;
+}
+
+bool PreviewRequest::waitForFinished(unsigned long msecs)
+{
+    QMutexLocker m(&m_mutex);
+    if (!m_finished)
+        m_finishedCondition.wait(&m_mutex, msecs);
+    return m_finished;
+}
+
+void PreviewRequest::finish(const QImage &image)
+{
+    {
+        QMutexLocker m(&m_mutex);
+        if (m_finished)
+            return;
+        m_image = image;
+        m_finished = true;
+        m_finishedCondition.wakeAll();
+    }
+
+    emit finished();
+}
+
+PreviewScheduler::PreviewScheduler(QObject *parent)
+    : QObject(parent)
+    , m_dispatcher(new PreviewDispatcher)
+{
+    m_dispatcher->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_dispatcher, &QObject::deleteLater);
+    m_thread.setObjectName(QStringLiteral("PreviewScheduler"));
+    m_thread.start();
+}
+
+PreviewScheduler::~PreviewScheduler()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool PreviewScheduler::canPreview(const QString &path) const
+{
+    return path.endsWith(".qml");
+}
+
+int PreviewScheduler::workerCount() const
+{
+    return m_dispatcher->workerCount();
+}
+
+void PreviewScheduler::setWorkerCount(int count)
+{
+    m_dispatcher->setWorkerCount(count);
+}
+
+void PreviewScheduler::setEnvironment(const QProcessEnvironment &environment)
+{
+    m_dispatcher->setEnvironment(environment);
+}
+
+PreviewRequestPtr PreviewScheduler::request(const QString &path, const QSize &requestedSize)
+{
+    PreviewRequestPtr request(new PreviewRequest(path, requestedSize));
+    enqueue(request);
+    return request;
+}
+
+void PreviewScheduler::enqueue(const PreviewRequestPtr &request)
+{
+    m_dispatcher->enqueue(request);
+}
+
+void PreviewScheduler::cancel(const PreviewRequestPtr &request)
+{
+    if (!request || request->isFinished())
+        return;
+
+    request->m_canceled.store(1);
+    m_dispatcher->wake();
+}
+
+PreviewDispatcher::PreviewDispatcher()
+    : m_workerCount(qBound(1, QThread::idealThreadCount() / 2, 4))
+    , m_environment(QProcessEnvironment::systemEnvironment())
+{
+}
+
+PreviewDispatcher::~PreviewDispatcher()
+{
+    qDeleteAll(m_workers);
+
+    foreach (const PreviewRequestPtr &request, m_pending)
+        request->finish(QImage());
+}
+
+int PreviewDispatcher::workerCount() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_workerCount;
+}
+
+void PreviewDispatcher::setWorkerCount(int count)
+{
+    QMutexLocker m(&m_mutex);
+    m_workerCount = qMax(1, count);
+}
+
+QProcessEnvironment PreviewDispatcher::environment() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_environment;
+}
+
+void PreviewDispatcher::setEnvironment(const QProcessEnvironment &environment)
+{
+    QMutexLocker m(&m_mutex);
+    m_environment = environment;
+}
+
+void PreviewDispatcher::enqueue(const PreviewRequestPtr &request)
+{
+    {
+        QMutexLocker m(&m_mutex);
+        m_pending.append(request);
+    }
+    wake();
+}
+
+void PreviewDispatcher::wake()
+{
+    QMetaObject::invokeMethod(this, "dispatch", Qt::QueuedConnection);
+}
+
+void PreviewDispatcher::dispatch()
+{
+    QList<PreviewRequestPtr> failed;
+
+    QMutexLocker m(&m_mutex);
+
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        if ((*it)->isCanceled()) {
+            failed.append(*it);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    while (m_workers.count() < m_workerCount)
+        m_workers.append(new PreviewWorker(this));
+    const QList<PreviewWorker *> workers = m_workers.mid(0, m_workerCount);
+
+    foreach (PreviewWorker *worker, m_workers)
+        worker->sendCancels();
+
+    while (!m_pending.isEmpty()) {
+        PreviewWorker *target = 0;
+        foreach (PreviewWorker *worker, workers) {
+            if (worker->isReady() && worker->load() < MAX_REQUESTS_PER_WORKER
+                    && (!target || worker->load() < target->load())) {
+                target = worker;
+            }
+        }
+        if (!target)
+            break;
+        target->send(m_pending.takeFirst());
+    }
+
+    // Start more generators while requests are left waiting
+    int waiting = m_pending.count();
+    bool usable = false;
+    foreach (PreviewWorker *worker, workers) {
+        if (worker->isDisabled())
+            continue;
+        usable = true;
+        if (waiting <= 0 || worker->isReady())
+            continue;
+        if (!worker->isRunning())
+            worker->start(m_environment);
+        waiting -= MAX_REQUESTS_PER_WORKER;
+    }
+
+    if (!usable) {
+        qWarning() << "previewGenerator cannot be started, no QML previews available";
+        failed.append(m_pending);
+        m_pending.clear();
+    }
+
+    m.unlock();
+
+    foreach (const PreviewRequestPtr &request, failed)
+        request->finish(QImage());
+}
+
+PreviewWorker::PreviewWorker(PreviewDispatcher *dispatcher)
+    : QObject(dispatcher)
+    , m_dispatcher(dispatcher)
+    , m_process(new QProcess(this))
+    , m_socket(new QLocalSocket(this))
+    , m_timeoutTimer(new QTimer(this))
+    , m_nextId(0)
+    , m_sharedMemoryAvailable(true)
+    , m_connected(false)
+    , m_startFailures(0)
+{
+    m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &PreviewWorker::onReadyReadOutput);
+    connect(m_process, &QProcess::stateChanged, this, &PreviewWorker::onProcessStateChanged);
+
+    connect(m_socket, &QLocalSocket::connected, this, &PreviewWorker::onConnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &PreviewWorker::onReadyRead);
+
+    m_timeoutTimer->setInterval(REQUEST_TIMEOUT / 4);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &PreviewWorker::checkTimeout);
+}
+
+PreviewWorker::~PreviewWorker()
+{
+    disconnect(m_process, 0, this, 0);
+    m_socket->abort();
+    m_process->kill();
+    m_process->waitForFinished();
+    failRequests();
+}
+
+void PreviewWorker::start(const QProcessEnvironment &environment)
+{
+    static const QString program = QCoreApplication::applicationDirPath() +
+#ifdef Q_OS_WIN
+        QStringLiteral("/previewGenerator.exe");
+#else
+        QStringLiteral("/../libexec/qmllive/previewGenerator");
+#endif
+    static const QStringList arguments("QmlLiveBench");
+
+    m_output.clear();
+    m_process->setProcessEnvironment(environment);
+    m_process->start(program, arguments);
+}
+
+void PreviewWorker::send(const PreviewRequestPtr &request)
+{
+    const quint32 id = m_nextId++;
+
+    const QSize size = request->requestedSize();
+    QSharedMemory *segment = acquireSegment(qMax(0, size.width()) * qMax(0, size.height()) * 4);
+    if (segment)
+        m_segments.insert(id, segment);
+
+    QByteArray frame;
+    QDataStream(&frame, QIODevice::WriteOnly) << quint8(PreviewProtocol::Preview) << id
+                                              << size << request->path()
+                                              << (segment ? segment->key() : QString());
+    PreviewProtocol::writeFrame(m_socket, frame);
+    m_socket->flush();
+
+    if (m_requests.isEmpty())
+        m_lastProgress.start();
+    m_requests.insert(id, request);
+}
+
+void PreviewWorker::sendCancels()
+{
+    for (auto it = m_requests.constBegin(); it != m_requests.constEnd(); ++it) {
+        if (!it.value()->isCanceled() || m_canceling.contains(it.key()))
+            continue;
+
+        QByteArray frame;
+        QDataStream(&frame, QIODevice::WriteOnly) << quint8(PreviewProtocol::Cancel) << it.key();
+        PreviewProtocol::writeFrame(m_socket, frame);
+        m_canceling.insert(it.key());
+    }
+    m_socket->flush();
+}
+
+void PreviewWorker::onReadyReadOutput()
+{
+    m_output += m_process->readAllStandardOutput();
+
+    const int end = m_output.indexOf('\n');
+    if (end == -1 || m_socket->state() != QLocalSocket::UnconnectedState)
+        return;
+
+    const QByteArray line = m_output.left(end).trimmed();
+    if (!line.startsWith("ready#")) {
+        qWarning() << "previewGenerator did not send the \"ready\" token";
+        m_process->kill();
+        return;
+    }
+
+    m_socket->connectToServer(QString::fromUtf8(QByteArray::fromHex(line.mid(6))));
+}
+
+void PreviewWorker::onConnected()
+{
+    m_connected = true;
+    m_startFailures = 0;
+    m_timeoutTimer->start();
+    m_dispatcher->wake();
+}
+
+void PreviewWorker::onReadyRead()
+{
+    QByteArray frame;
+    while (PreviewProtocol::readFrame(m_socket, &frame)) {
+        QDataStream ds(frame);
+        quint32 id;
+        quint8 transport;
+        ds >> id >> transport;
+
+        QImage image;
+        QSharedMemory *segment = m_segments.take(id);
+        if (transport == PreviewProtocol::SharedMemory && segment) {
+            QSize size;
+            qint32 bytesPerLine;
+            qint32 format;
+            ds >> size >> bytesPerLine >> format;
+            if (ds.status() == QDataStream::Ok && format > QImage::Format_Invalid
+                    && format < QImage::NImageFormats && bytesPerLine >= size.width() * 4
+                    && qint64(size.height()) * bytesPerLine <= segment->size()) {
+                image = QImage(static_cast<const uchar *>(segment->constData()), size.width(), size.height(),
+                               bytesPerLine, QImage::Format(format)).copy();
+            }
+        } else if (transport == PreviewProtocol::Inline) {
+            ds >> image;
+        }
+        if (segment)
+            releaseSegment(segment);
+
+        m_lastProgress.start();
+        m_canceling.remove(id);
+        if (PreviewRequestPtr request = m_requests.take(id))
+            request->finish(image);
+    }
+
+    m_dispatcher->wake();
+}
+
+void PreviewWorker::onProcessStateChanged(QProcess::ProcessState state)
+{
+    if (state != QProcess::NotRunning)
+        return;
+
+    if (!m_connected) {
+        ++m_startFailures;
+        qWarning() << "previewGenerator failed to start:" << m_process->errorString();
+    } else {
+        qWarning() << "previewGenerator stopped unexpectedly";
+    }
+
+    m_connected = false;
+    m_timeoutTimer->stop();
+    m_socket->abort();
+    failRequests();
+    m_dispatcher->wake();
+}
+
+void PreviewWorker::checkTimeout()
+{
+    if (m_requests.isEmpty() || m_lastProgress.elapsed() < REQUEST_TIMEOUT)
+        return;
+
+    qWarning() << "previewGenerator does not respond, restarting it";
+    m_process->kill();
+}
+
+void PreviewWorker::failRequests()
+{
+    const QList<PreviewRequestPtr> requests = m_requests.values();
+    m_requests.clear();
+    m_canceling.clear();
+
+    foreach (QSharedMemory *segment, m_segments)
+        releaseSegment(segment);
+    m_segments.clear();
+
+    foreach (const PreviewRequestPtr &request, requests)
+        request->finish(QImage());
+}
+
+QSharedMemory *PreviewWorker::acquireSegment(int size)
+{
+    if (size <= 0 || !m_sharedMemoryAvailable)
+        return 0;
+
+    for (int i = 0; i < m_freeSegments.count(); ++i) {
+        if (m_freeSegments.at(i)->size() >= size)
+            return m_freeSegments.takeAt(i);
+    }
+
+    static QAtomicInt counter;
+    const QString key = QString::fromLatin1("QmlLivePreview-%1-%2")
+            .arg(QCoreApplication::applicationPid()).arg(counter.fetchAndAddRelaxed(1));
+
+    QSharedMemory *segment = new QSharedMemory(key, this);
+    const int granularSize = (size + SEGMENT_GRANULARITY - 1) / SEGMENT_GRANULARITY * SEGMENT_GRANULARITY;
+    if (!segment->create(granularSize)) {
+        // The generator passes the preview through the socket instead
+        qWarning() << "Failed to create shared memory segment for previews:" << segment->errorString();
+        m_sharedMemoryAvailable = false;
+        delete segment;
+        return 0;
+    }
+
+    return segment;
+}
+
+void PreviewWorker::releaseSegment(QSharedMemory *segment)
+{
+    m_freeSegments.append(segment);
+
+    if (m_freeSegments.count() > MAX_REQUESTS_PER_WORKER)
+        delete m_freeSegments.takeFirst();
+}
+
+#include "previewscheduler.moc"
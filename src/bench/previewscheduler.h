@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QImage>
+#include <QMutex>
+#include <QProcessEnvironment>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+class PreviewDispatcher;
+
+class PreviewRequest : public QObject
+{
+    Q_OBJECT
+public:
+    PreviewRequest(const QString &path, const QSize &requestedSize);
+
+    QString path() const;
+    QSize requestedSize() const;
+
+    QImage image() const;
+    bool isFinished() const;
+    bool isCanceled() const;
+    bool waitForFinished(unsigned long msecs = ULONG_MAX);
+
+signals:
+    void finished();
+
+private:
+    friend class PreviewScheduler;
+    friend class PreviewDispatcher;
+    friend class PreviewWorker;
+
+    void finish(const QImage &image);
+
+    const QString m_path;
+    const QSize m_requestedSize;
+    QAtomicInt m_canceled;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_finishedCondition;
+    QImage m_image;
+    bool m_finished;
+};
+
+typedef QSharedPointer<PreviewRequest> PreviewRequestPtr;
+
+class PreviewScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PreviewScheduler(QObject *parent = 0);
+    ~PreviewScheduler();
+
+    bool canPreview(const QString &path) const;
+
+    int workerCount() const;
+    void setWorkerCount(int count);
+    void setEnvironment(const QProcessEnvironment &environment);
+
+    PreviewRequestPtr request(const QString &path, const QSize &requestedSize);
+    // Allows connecting to the request before it can finish
+    void enqueue(const PreviewRequestPtr &request);
+    void cancel(const PreviewRequestPtr &request);
+
+private:
+    QThread m_thread;
+    PreviewDispatcher *m_dispatcher;
+};
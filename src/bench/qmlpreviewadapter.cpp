@@ -30,120 +30,39 @@
 ****************************************************************************/
 
 #include "qmlpreviewadapter.h"
+#include "previewscheduler.h"
 #include <QFileInfo>
 #include <QDir>
 #include <QCoreApplication>
-#include <QLocalSocket>
 #include <QDebug>
-#include <QProcess>
+#include <QProcessEnvironment>
 
 
-Q_GLOBAL_STATIC(QProcess, proc)
-Q_GLOBAL_STATIC(QString, serverName)
-
-
-QmlPreviewAdapter::QmlPreviewAdapter(QObject *parent) :
-    QObject(parent)
+QmlPreviewAdapter::QmlPreviewAdapter(PreviewScheduler *scheduler, QObject *parent) :
+    QObject(parent),
+    m_scheduler(scheduler)
 {
 }
 
 bool QmlPreviewAdapter::canPreview(const QString &path) const
 {
-    return path.endsWith(".qml");
+    return m_scheduler && m_scheduler->canPreview(path);
 }
 
 QImage QmlPreviewAdapter::preview(const QString &path, const QSize &requestedSize)
 {
-    QImage img;
-
     if (!requestedSize.isValid()) {
         qWarning() << "preview for" << path << "with invalid size" << requestedSize << "requested";
         return QImage();
     }
 
-    static const QString program = QCoreApplication::applicationDirPath() +
-#ifdef Q_OS_WIN
-        QStringLiteral("/previewGenerator.exe");
-#else
-        QStringLiteral("/../libexec/qmllive/previewGenerator");
-#endif
-    static const QStringList arguments("QmlLiveBench");
-
-    if (proc()->state() != QProcess::Running) {
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-        {
-            QMutexLocker m(&m_mutex);
-            env.insert(QStringLiteral("QT_PLUGIN_PATH"), m_pluginPaths.join(QChar(':')));
-            env.insert(QStringLiteral("QML_IMPORT_PATH"), m_importPaths.join(QChar(':')));
-            env.insert(QStringLiteral("QML2_IMPORT_PATH"), m_importPaths.join(QChar(':')));
-        }
-        proc()->setProcessEnvironment(env);
-
-        proc()->setProcessChannelMode(QProcess::ForwardedErrorChannel);
-
-        proc()->start(program, arguments);
-        if (!proc()->waitForStarted()) {
-            qWarning() << "Failed to start" << program;
-            return QImage();
-        }
-
-        proc()->waitForReadyRead();
-        QByteArray data = proc()->readAll();
-        if (!data.startsWith("ready#")) {
-            qWarning() << "previewGenerator did not send the \"ready\" token";
-            return QImage();
-        }
-        QString server = QString::fromUtf8(QByteArray::fromHex(data.mid(6)));
-        *serverName() = server;
-    }
-
-    QLocalSocket socket;
-
-    socket.connectToServer(*serverName());
-    if (!socket.waitForConnected(3000)) {
-        qWarning() << "Could not connect to PreviewGenerator";
+    if (!m_scheduler)
         return QImage();
-    }
-
-    //qWarning() << "QL: sending request [" << requestedSize << "]" << path;
-
-    {
-        QDataStream ds(&socket);
-        ds << requestedSize << path;
-    }
-    socket.waitForBytesWritten();
-
-    //qWarning() << "QL: sent";
-
-    QByteArray data;
-    bool allData = false;
-    while (!allData) {
-        int bytes = socket.bytesAvailable();
-        //qWarning() << "QL: can read" << bytes << "bytes";
-
-        if (proc()->state() != QProcess::Running) {
-            qWarning() << "previewGenerator stopped unexpectedly";
-            break;
-        }
-
-        if (!bytes) {
-            //qWarning() << "QL: waiting for more data (have" << data.size() << "already)";
-            socket.waitForReadyRead(5000);
-            continue;
-        }
-
-        data += socket.read(bytes);
-
-        if (data.endsWith("\nEND")) {
-            allData = true;
-            data.chop(4);
-            //qWarning() << "QL: received end marker after"  << data.size() << "bytes";
-        }
-    }
-    socket.close();
 
-    img.loadFromData(data, "PNG");
+    PreviewRequestPtr request = m_scheduler->request(path, requestedSize);
+    request->waitForFinished();
 
+    QImage img = request->image();
     if (img.size().isNull()) {
         qWarning() << "Failed to generate Preview";
 
@@ -170,12 +89,34 @@ QUrl QmlPreviewAdapter::adapt(const QUrl &url, QQmlContext *context)
 
 void QmlPreviewAdapter::setImportPaths(QStringList importPaths)
 {
-    QMutexLocker m(&m_mutex);
-    m_importPaths = importPaths;
+    {
+        QMutexLocker m(&m_mutex);
+        m_importPaths = importPaths;
+    }
+    updateEnvironment();
 }
 
 void QmlPreviewAdapter::setPluginPaths(QStringList pluginPaths)
 {
-    QMutexLocker m(&m_mutex);
-    m_importPaths = pluginPaths;
+    {
+        QMutexLocker m(&m_mutex);
+        m_pluginPaths = pluginPaths;
+    }
+    updateEnvironment();
+}
+
+void QmlPreviewAdapter::updateEnvironment()
+{
+    if (!m_scheduler)
+        return;
+
+    // Applies to generators started from now on
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    {
+        QMutexLocker m(&m_mutex);
+        env.insert(QStringLiteral("QT_PLUGIN_PATH"), m_pluginPaths.join(QChar(':')));
+        env.insert(QStringLiteral("QML_IMPORT_PATH"), m_importPaths.join(QChar(':')));
+        env.insert(QStringLiteral("QML2_IMPORT_PATH"), m_importPaths.join(QChar(':')));
+    }
+    m_scheduler->setEnvironment(env);
 }
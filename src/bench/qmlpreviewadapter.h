@@ -34,16 +34,17 @@
 #include "contentadapterinterface.h"
 #include <QMutex>
 #include <QStringList>
-#include <QProcess>
+#include <QPointer>
 
 QT_FORWARD_DECLARE_CLASS(QmlContext);
 QT_FORWARD_DECLARE_CLASS(QDeclarativeContext);
+class PreviewScheduler;
 class QmlPreviewAdapter : public QObject, public ContentAdapterInterface
 {
     Q_OBJECT
     Q_INTERFACES(ContentAdapterInterface)
 public:
-    explicit QmlPreviewAdapter(QObject *parent = 0);
+    explicit QmlPreviewAdapter(PreviewScheduler *scheduler, QObject *parent = 0);
 
     bool canPreview(const QString& path) const;
     QImage preview(const QString& path, const QSize &requestedSize);
@@ -55,7 +56,9 @@ public:
     void setPluginPaths(QStringList pluginPaths);
 
 private:
+    void updateEnvironment();
 
+    QPointer<PreviewScheduler> m_scheduler;
     QStringList m_pluginPaths;
     QStringList m_importPaths;
     QMutex m_mutex;
@@ -0,0 +1,265 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "thumbnailcache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+const int DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+const qint64 DEFAULT_DISK_LIMIT = 256 * 1024 * 1024;
+// Content hashes are remembered for this many documents at most
+const int MAX_REMEMBERED_HASHES = 10000;
+}
+
+// Thumbnails are kept in memory as long as the document does not change on
+// disk, with the least recently used ones dropped first. Thumbnails of files
+// are also stored on disk keyed by the file path, the file content and the
+// requested size, so that they survive restarts. QML previews are not stored on
+// disk: they depend on imported components and images, which the key does not
+// cover.
+ThumbnailCache::ThumbnailCache()
+    : m_memory(DEFAULT_MEMORY_LIMIT)
+    , m_diskPath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/previews"))
+    , m_diskLimit(DEFAULT_DISK_LIMIT)
+    , m_diskUsage(-1)
+{
+}
+
+int ThumbnailCache::memoryLimit() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_memory.maxCost();
+}
+
+void ThumbnailCache::setMemoryLimit(int bytes)
+{
+    QMutexLocker m(&m_mutex);
+    m_memory.setMaxCost(bytes);
+}
+
+QString ThumbnailCache::diskPath() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_diskPath;
+}
+
+void ThumbnailCache::setDiskPath(const QString &path)
+{
+    QMutexLocker m(&m_mutex);
+    m_diskPath = path;
+    m_diskUsage = -1;
+}
+
+qint64 ThumbnailCache::diskLimit() const
+{
+    QMutexLocker m(&m_mutex);
+    return m_diskLimit;
+}
+
+void ThumbnailCache::setDiskLimit(qint64 bytes)
+{
+    QMutexLocker m(&m_mutex);
+    m_diskLimit = bytes;
+}
+
+bool ThumbnailCache::find(const QString &path, const QSize &requestedSize, QImage *image)
+{
+    const QFileInfo info(path);
+    const QString memoryKey = key(path, requestedSize);
+
+    {
+        QMutexLocker m(&m_mutex);
+        if (Entry *entry = m_memory.object(memoryKey)) {
+            if (entry->lastModified == info.lastModified() && entry->fileSize == info.size()) {
+                *image = entry->image;
+                return true;
+            }
+            m_memory.remove(memoryKey);
+        }
+    }
+
+    if (!isPersistent(info))
+        return false;
+
+    const QString fileName = diskFileName(info, requestedSize);
+    if (fileName.isEmpty() || !QFile::exists(fileName))
+        return false;
+
+    QImage stored(fileName, "PNG");
+    if (stored.isNull())
+        return false;
+
+    Entry *entry = new Entry;
+    entry->image = stored;
+    entry->lastModified = info.lastModified();
+    entry->fileSize = info.size();
+
+    QMutexLocker m(&m_mutex);
+    m_memory.insert(memoryKey, entry, stored.bytesPerLine() * stored.height());
+
+    *image = stored;
+    return true;
+}
+
+void ThumbnailCache::insert(const QString &path, const QSize &requestedSize, const QImage &image)
+{
+    if (image.isNull())
+        return;
+
+    const QFileInfo info(path);
+
+    Entry *entry = new Entry;
+    entry->image = image;
+    entry->lastModified = info.lastModified();
+    entry->fileSize = info.size();
+
+    {
+        QMutexLocker m(&m_mutex);
+        m_memory.insert(key(path, requestedSize), entry, image.bytesPerLine() * image.height());
+    }
+
+    if (!isPersistent(info))
+        return;
+
+    const QString fileName = diskFileName(info, requestedSize);
+    if (fileName.isEmpty() || QFile::exists(fileName))
+        return;
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+        qWarning() << "Failed to store preview in" << fileName << file.errorString();
+        return;
+    }
+
+    QMutexLocker m(&m_mutex);
+    if (m_diskUsage >= 0)
+        m_diskUsage += QFileInfo(fileName).size();
+    if (m_diskUsage < 0 || m_diskUsage > m_diskLimit)
+        trimDisk();
+}
+
+QString ThumbnailCache::key(const QString &path, const QSize &requestedSize)
+{
+    return path + QString("%1x%2").arg(QString::number(requestedSize.width())).arg(QString::number(requestedSize.height()));
+}
+
+bool ThumbnailCache::isPersistent(const QFileInfo &info)
+{
+    if (!info.isFile())
+        return false;
+
+    const QString suffix = info.suffix();
+    return suffix != QLatin1String("qml") && suffix != QLatin1String("qmlc");
+}
+
+QByteArray ThumbnailCache::contentHash(const QFileInfo &info)
+{
+    const QString path = info.absoluteFilePath();
+
+    {
+        QMutexLocker m(&m_mutex);
+        auto it = m_hashes.constFind(path);
+        if (it != m_hashes.constEnd() && it->lastModified == info.lastModified() && it->fileSize == info.size())
+            return it->hash;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+
+    Hash entry;
+    entry.hash = hash.result();
+    entry.lastModified = info.lastModified();
+    entry.fileSize = info.size();
+
+    QMutexLocker m(&m_mutex);
+    if (m_hashes.size() >= MAX_REMEMBERED_HASHES)
+        m_hashes.clear();
+    m_hashes.insert(path, entry);
+
+    return entry.hash;
+}
+
+QString ThumbnailCache::diskFileName(const QFileInfo &info, const QSize &requestedSize)
+{
+    {
+        QMutexLocker m(&m_mutex);
+        if (m_diskPath.isEmpty() || m_diskLimit <= 0)
+            return QString();
+    }
+
+    const QByteArray content = contentHash(info);
+    if (content.isEmpty())
+        return QString();
+
+    // Content adapters may resolve sibling files relative to the document, so
+    // equal content alone does not make equal previews
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(content);
+
+    QMutexLocker m(&m_mutex);
+    return QString::fromLatin1("%1/%2-%3x%4.png").arg(m_diskPath)
+            .arg(QString::fromLatin1(hash.result().toHex()))
+            .arg(requestedSize.width()).arg(requestedSize.height());
+}
+
+// Called with m_mutex locked
+void ThumbnailCache::trimDisk()
+{
+    QDir dir(m_diskPath);
+    const QFileInfoList files = dir.entryInfoList(QStringList("*.png"), QDir::Files, QDir::Time | QDir::Reversed);
+
+    qint64 usage = 0;
+    foreach (const QFileInfo &file, files)
+        usage += file.size();
+
+    // Oldest first, keep some headroom so that trimming does not happen on every insert
+    const qint64 target = m_diskLimit - m_diskLimit / 10;
+    foreach (const QFileInfo &file, files) {
+        if (usage <= target)
+            break;
+        if (QFile::remove(file.absoluteFilePath()))
+            usage -= file.size();
+    }
+
+    m_diskUsage = usage;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+
+class ThumbnailCache
+{
+public:
+    ThumbnailCache();
+
+    int memoryLimit() const;
+    void setMemoryLimit(int bytes);
+
+    QString diskPath() const;
+    void setDiskPath(const QString &path);
+    qint64 diskLimit() const;
+    void setDiskLimit(qint64 bytes);
+
+    bool find(const QString &path, const QSize &requestedSize, QImage *image);
+    void insert(const QString &path, const QSize &requestedSize, const QImage &image);
+
+private:
+    struct Entry
+    {
+        QImage image;
+        QDateTime lastModified;
+        qint64 fileSize;
+    };
+
+    struct Hash
+    {
+        QByteArray hash;
+        QDateTime lastModified;
+        qint64 fileSize;
+    };
+
+    static QString key(const QString &path, const QSize &requestedSize);
+    static bool isPersistent(const QFileInfo &info);
+    QByteArray contentHash(const QFileInfo &info);
+    QString diskFileName(const QFileInfo &info, const QSize &requestedSize);
+    void trimDisk();
+
+    mutable QMutex m_mutex;
+    QCache<QString, Entry> m_memory;
+    QHash<QString, Hash> m_hashes;
+    QString m_diskPath;
+    qint64 m_diskLimit;
+    qint64 m_diskUsage;
+};
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "contentadapterregistry.h"
+#include "contentadapterinterface.h"
+#include "livedocument.h"
+
+#ifdef QMLLIVE_DEBUG
+#define DEBUG qDebug()
+#else
+#define DEBUG if (0) qDebug()
+#endif
+
+/*
+ * Selects the content adapter for a document.
+ *
+ * Adapters which claimed a set of suffixes are only asked about documents with
+ * one of those suffixes, adapters without claims are asked about everything,
+ * in the order the adapters were registered. Only if no adapter accepts a
+ * document, adapters are asked about suffixes they did not claim, so that
+ * e.g. images with an unusual suffix can still be detected by content. The
+ * result of this fallback is cached per path and modification time.
+ *
+ * QML documents are never passed to the fallback.
+ */
+
+ContentAdapterRegistry::ContentAdapterRegistry()
+{
+}
+
+void ContentAdapterRegistry::setAdapters(const QList<ContentAdapterInterface *> &adapters)
+{
+    if (adapters == m_adapters)
+        return;
+
+    m_adapters = adapters;
+    invalidate();
+}
+
+void ContentAdapterRegistry::setClaimedSuffixes(ContentAdapterInterface *adapter, const QStringList &suffixes)
+{
+    QSet<QString> claims;
+    foreach (const QString &suffix, suffixes)
+        claims.insert(suffix.toLower());
+
+    if (claims.isEmpty())
+        m_claims.remove(adapter);
+    else
+        m_claims.insert(adapter, claims);
+
+    invalidate();
+}
+
+ContentAdapterInterface *ContentAdapterRegistry::find(const QUrl &url)
+{
+    const QString path = LiveDocument::toFilePath(url);
+    const QString suffix = QFileInfo(path.isEmpty() ? url.path() : path).suffix().toLower();
+
+    foreach (ContentAdapterInterface *adapter, candidates(suffix)) {
+        if (adapter->canAdapt(url))
+            return adapter;
+    }
+
+    if (path.isEmpty() || suffix == QLatin1String("qml"))
+        return 0;
+
+    const QDateTime lastModified = QFileInfo(path).lastModified();
+    auto it = m_sniffed.constFind(path);
+    if (it != m_sniffed.constEnd() && it->lastModified == lastModified)
+        return it->adapter;
+
+    DEBUG << "Sniffing content of" << path;
+
+    ContentAdapterInterface *found = 0;
+    foreach (ContentAdapterInterface *adapter, m_adapters) {
+        auto claims = m_claims.constFind(adapter);
+        if (claims == m_claims.constEnd() || claims->contains(suffix))
+            continue; // asked already
+        if (adapter->canAdapt(url)) {
+            found = adapter;
+            break;
+        }
+    }
+
+    m_sniffed.insert(path, Sniffed{lastModified, found});
+    return found;
+}
+
+const QList<ContentAdapterInterface *> &ContentAdapterRegistry::candidates(const QString &suffix)
+{
+    auto it = m_candidatesBySuffix.constFind(suffix);
+    if (it != m_candidatesBySuffix.constEnd())
+        return *it;
+
+    QList<ContentAdapterInterface *> candidates;
+    foreach (ContentAdapterInterface *adapter, m_adapters) {
+        auto claims = m_claims.constFind(adapter);
+        if (claims == m_claims.constEnd() || claims->contains(suffix))
+            candidates.append(adapter);
+    }
+
+    return *m_candidatesBySuffix.insert(suffix, candidates);
+}
+
+void ContentAdapterRegistry::invalidate()
+{
+    m_candidatesBySuffix.clear();
+    m_sniffed.clear();
+}
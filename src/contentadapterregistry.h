@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2016 Pelagicore AG
+** Copyright (C) 2018 Jolla Ltd
 ** Contact: https://www.qt.io/licensing/
 **
 ** This file is part of the QmlLive tool.
@@ -33,39 +33,31 @@
 
 #include <QtCore>
 
-class Watcher : public QObject
+class ContentAdapterInterface;
+
+class ContentAdapterRegistry
 {
-    Q_OBJECT
 public:
-    enum Error {
-        NoError,
-        MaximumReached,
-        SystemError,
-    };
+    ContentAdapterRegistry();
+
+    void setAdapters(const QList<ContentAdapterInterface *> &adapters);
+    void setClaimedSuffixes(ContentAdapterInterface *adapter, const QStringList &suffixes);
+
+    ContentAdapterInterface *find(const QUrl &url);
 
-    explicit Watcher(QObject *parent = 0);
-    void setDirectory(const QString& path);
-    QString directory() const;
-    bool hasError() const { return m_error != NoError; }
-    Error error() const { return m_error; }
-    static int maximumWatches() { return s_maximumWatches; }
-    static void setMaximumWatches(int maximumWatches);
-private Q_SLOTS:
-    void recordChange(const QString &path);
-    void notifyChanges();
-Q_SIGNALS:
-    void directoriesChanged(const QStringList& changes);
-    void errorChanged();
 private:
-    void addDirectoriesRecursively(const QString& path);
-    void addDirectory(const QString &path);
-    void removeAllPaths();
-    void setError(Error error);
-    static int s_maximumWatches;
-    QFileSystemWatcher *m_watcher;
-    QDir m_rootDir;
-    QTimer *m_waitTimer;
-    QStringList m_changes;
-    Error m_error = NoError;
-};
+    const QList<ContentAdapterInterface *> &candidates(const QString &suffix);
+    void invalidate();
 
+private:
+    struct Sniffed
+    {
+        QDateTime lastModified;
+        ContentAdapterInterface *adapter;
+    };
+
+    QList<ContentAdapterInterface *> m_adapters;
+    QHash<ContentAdapterInterface *, QSet<QString>> m_claims;
+    QHash<QString, QList<ContentAdapterInterface *>> m_candidatesBySuffix;
+    QHash<QString, Sniffed> m_sniffed;
+};
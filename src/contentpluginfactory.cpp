@@ -33,6 +33,9 @@
 #include "contentadapterinterface.h"
 
 #include <QPluginLoader>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMimeDatabase>
 #include <QDirIterator>
 #include <QDebug>
 
@@ -59,6 +62,19 @@ QList<ContentAdapterInterface *> ContentPluginFactory::plugins()
     return m_plugins;
 }
 
+/*
+ * Returns the file suffixes \a plugin declared in its metadata.
+ *
+ * A plugin may restrict the documents it is asked about by listing "suffixes"
+ * and/or "mimeTypes" in the metadata JSON file passed to
+ * Q_PLUGIN_METADATA. An empty list means the plugin is asked about any
+ * document.
+ */
+QStringList ContentPluginFactory::suffixes(ContentAdapterInterface *plugin) const
+{
+    return m_suffixes.value(plugin);
+}
+
 bool ContentPluginFactory::isLoaded()
 {
     return m_loaded;
@@ -88,6 +104,24 @@ void ContentPluginFactory::load()
         if (plugin) {
             loader.instance()->setParent(this);
             m_plugins.append(plugin);
+
+            const QJsonObject metaData = loader.metaData().value(QLatin1String("MetaData")).toObject();
+            QStringList suffixes;
+            foreach (const QJsonValue &suffix, metaData.value(QLatin1String("suffixes")).toArray())
+                suffixes.append(suffix.toString().toLower());
+            QMimeDatabase mimeDatabase;
+            foreach (const QJsonValue &name, metaData.value(QLatin1String("mimeTypes")).toArray()) {
+                const QMimeType mimeType = mimeDatabase.mimeTypeForName(name.toString());
+                if (!mimeType.isValid()) {
+                    qWarning() << "Unknown MIME type" << name.toString() << "declared by" << path;
+                    continue;
+                }
+                suffixes.append(mimeType.suffixes());
+            }
+            suffixes.removeDuplicates();
+            suffixes.removeAll(QString());
+            if (!suffixes.isEmpty())
+                m_suffixes.insert(plugin, suffixes);
         } else {
             qWarning() << "Error while trying to load" <<path << ": Unsupported root component type"
                        << loader.instance()->metaObject()->className();
@@ -32,6 +32,8 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
+#include <QStringList>
 
 class ContentAdapterInterface;
 class ContentPluginFactory : public QObject
@@ -44,6 +46,7 @@ public:
     QString pluginPath();
 
     QList<ContentAdapterInterface*> plugins();
+    QStringList suffixes(ContentAdapterInterface *plugin) const;
     bool isLoaded();
 
 public Q_SLOTS:
@@ -53,5 +56,6 @@ public Q_SLOTS:
 private:
     QString m_pluginPath;
     QList<ContentAdapterInterface*> m_plugins;
+    QHash<ContentAdapterInterface*, QStringList> m_suffixes;
     bool m_loaded;
 };
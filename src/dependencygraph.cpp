@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "dependencygraph.h"
+#include "importpathindex.h"
+#include "workspacetree.h"
+
+namespace {
+
+QString resolvePath(const QString &directory, const QString &path)
+{
+    if (directory == QLatin1String("."))
+        return QDir::cleanPath(path);
+    return QDir::cleanPath(directory + QLatin1Char('/') + path);
+}
+
+bool isOutside(const QString &path)
+{
+    return path == QLatin1String("..") || path.startsWith(QLatin1String("../"))
+            || QDir::isAbsolutePath(path);
+}
+
+// Comment markers within string literals, like in "images/*.png", are kept
+QString stripComments(const QByteArray &content)
+{
+    const QString source = QString::fromUtf8(content);
+
+    QString result;
+    result.reserve(source.size());
+
+    QChar quote; // of the string literal being copied, if any
+    for (int i = 0; i < source.size(); ++i) {
+        const QChar c = source.at(i);
+
+        if (!quote.isNull()) {
+            result.append(c);
+            if (c == QLatin1Char('\\') && i + 1 < source.size())
+                result.append(source.at(++i));
+            else if (c == quote || c == QLatin1Char('\n'))
+                quote = QChar();
+            continue;
+        }
+
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            quote = c;
+        } else if (c == QLatin1Char('/') && i + 1 < source.size()) {
+            const QChar next = source.at(i + 1);
+            if (next == QLatin1Char('/')) {
+                // Keep the line break, imports are matched by line
+                i = source.indexOf(QLatin1Char('\n'), i);
+                if (i < 0)
+                    break;
+            } else if (next == QLatin1Char('*')) {
+                i = source.indexOf(QLatin1String("*/"), i + 2);
+                if (i < 0)
+                    break;
+                ++i;
+                continue;
+            }
+        }
+
+        result.append(source.at(i));
+    }
+
+    return result;
+}
+
+/*
+ * Relative URLs given as string literals, which covers image and font sources,
+ * Qt.resolvedUrl() and url() arguments as well as JavaScript .import and
+ * Qt.include().
+ */
+void scanUrls(const QString &directory, const QString &source, QSet<QString> *dependencies)
+{
+    static const QRegularExpression urls(QStringLiteral("[\"']([^\"'\\n:]+\\.\\w+)[\"']"));
+
+    QRegularExpressionMatchIterator it = urls.globalMatch(source);
+    while (it.hasNext()) {
+        const QString path = resolvePath(directory, it.next().captured(1));
+        if (!isOutside(path))
+            dependencies->insert(path);
+    }
+}
+
+QStringList sorted(QSet<QString> dependencies, const QString &document)
+{
+    dependencies.remove(document);
+
+    QStringList result = dependencies.toList();
+    result.sort();
+    return result;
+}
+
+} // namespace
+
+/*!
+ * \class DependencyGraph
+ * \brief The DependencyGraph class tells which workspace documents a QML document uses
+ * \inmodule qmllive
+ *
+ * The graph is built by a lightweight static scan of the QML and JavaScript documents
+ * and the \c qmldir files in the workspace. It records
+ *
+ * \list
+ * \li JavaScript files and directories imported with a relative \c import statement,
+ * \li modules imported by their URI, when found in the workspace relative to its
+ *     root directory,
+ * \li QML documents instantiated by their type name from the directory of the
+ *     document or from an imported directory,
+ * \li the documents listed in \c qmldir files,
+ * \li relative URLs given as string literals, like image sources or JavaScript
+ *     \c .import statements.
+ * \endlist
+ *
+ * Documents are identified by their path relative to the workspace. Dependencies may
+ * name documents which do not exist, e.g. where a type name is looked up in several
+ * directories.
+ *
+ * The scan does not evaluate any code, so dependencies constructed at run time are
+ * not known.
+ */
+
+/*!
+ * Constructs an empty graph
+ */
+DependencyGraph::DependencyGraph()
+{
+}
+
+/*!
+ * Returns true if no document was scanned
+ */
+bool DependencyGraph::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+/*!
+ * Updates the graph to all documents in \a tree. Only documents changed since the
+ * last update, judging by their size and modification time, are scanned again.
+ */
+void DependencyGraph::update(const WorkspaceTree &tree)
+{
+    const QDir dir(tree.rootPath());
+
+    QHash<QString, Entry> entries;
+    foreach (const WorkspaceTree::Node *node, tree.fileNodes()) {
+        if (!isScanned(node->name))
+            continue;
+
+        const QString filePath = tree.filePath(node);
+        const QString document = dir.relativeFilePath(filePath);
+
+        Entry entry;
+        if (scanDocument(document, filePath, node->size, node->lastModified, &entry))
+            entries.insert(document, entry);
+    }
+
+    m_entries.swap(entries);
+}
+
+/*!
+ * Updates the graph for the changed \a documents in \a tree only, i.e. the documents
+ * added, modified or removed since the last update.
+ */
+void DependencyGraph::update(const WorkspaceTree &tree, const QStringList &documents)
+{
+    const QDir dir(tree.rootPath());
+
+    foreach (const QString &document, documents) {
+        if (!isScanned(QFileInfo(document).fileName()))
+            continue;
+
+        const QString filePath = dir.absoluteFilePath(document);
+        const WorkspaceTree::Node *node = tree.find(filePath);
+
+        Entry entry;
+        if (node && !node->isDir
+                && scanDocument(document, filePath, node->size, node->lastModified, &entry)) {
+            m_entries.insert(document, entry);
+        } else {
+            m_entries.remove(document);
+        }
+    }
+}
+
+/*!
+ * Removes all documents from the graph
+ */
+void DependencyGraph::clear()
+{
+    m_entries.clear();
+}
+
+/*!
+ * Returns the documents used directly by \a document
+ */
+QStringList DependencyGraph::dependencies(const QString &document) const
+{
+    return m_entries.value(document).dependencies;
+}
+
+/*!
+ * Returns \a document together with all documents it uses directly or indirectly
+ */
+QSet<QString> DependencyGraph::closure(const QString &document) const
+{
+    QSet<QString> closure;
+    QStringList pending(document);
+    while (!pending.isEmpty()) {
+        const QString current = pending.takeLast();
+        if (closure.contains(current))
+            continue;
+        closure.insert(current);
+        pending.append(dependencies(current));
+    }
+    return closure;
+}
+
+/*!
+ * Returns the closure() of \a document ordered so that documents come after the
+ * documents they use, where dependencies are not circular. \a document comes last.
+ */
+QStringList DependencyGraph::closureOrder(const QString &document) const
+{
+    QStringList order;
+    QSet<QString> visited;
+
+    // Iterative depth-first search, a document is listed once all its dependencies are
+    QVector<QPair<QString, int> > stack;
+    stack.append(qMakePair(document, 0));
+    visited.insert(document);
+    while (!stack.isEmpty()) {
+        QPair<QString, int> &top = stack.last();
+        const QStringList deps = dependencies(top.first);
+        if (top.second < deps.count()) {
+            const QString next = deps.at(top.second++);
+            if (!visited.contains(next)) {
+                visited.insert(next);
+                stack.append(qMakePair(next, 0));
+            }
+        } else {
+            order.append(top.first);
+            stack.removeLast();
+        }
+    }
+
+    return order;
+}
+
+/*!
+ * Returns the documents used directly by any document in the graph. Other documents
+ * are either not used at all or only through URLs constructed at run time.
+ */
+QSet<QString> DependencyGraph::referencedDocuments() const
+{
+    QSet<QString> referenced;
+    foreach (const Entry &entry, m_entries)
+        referenced += entry.dependencies.toSet();
+    return referenced;
+}
+
+/*!
+ * Returns true for the names of the files scanned for dependencies, i.e. QML and
+ * JavaScript documents and \c qmldir files.
+ */
+bool DependencyGraph::isScanned(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(".qml"), Qt::CaseInsensitive)
+            || fileName.endsWith(QLatin1String(".js"), Qt::CaseInsensitive)
+            || fileName == QLatin1String("qmldir");
+}
+
+/*!
+ * Returns the documents used by the QML \a document with the given \a content.
+ */
+QStringList DependencyGraph::scanQml(const QString &document, const QByteArray &content)
+{
+    static const QRegularExpression imports(QStringLiteral(
+            "^\\s*import\\s+\"([^\"]+)\"(?:\\s+as\\s+(\\w+))?"),
+            QRegularExpression::MultilineOption);
+    static const QRegularExpression moduleImports(QStringLiteral(
+            "^\\s*import\\s+([A-Za-z_][\\w.]*)\\s+\\d"),
+            QRegularExpression::MultilineOption);
+    static const QRegularExpression types(QStringLiteral("(?:\\b(\\w+)\\.)?\\b([A-Z]\\w*)\\s*\\{"));
+
+    const QString source = stripComments(content);
+    const QString directory = QFileInfo(document).path();
+
+    QSet<QString> dependencies;
+
+    // qualifier -> imported directories, the empty qualifier for unqualified imports
+    QMultiHash<QString, QString> typeDirectories;
+    typeDirectories.insert(QString(), directory);
+
+    QRegularExpressionMatchIterator it = imports.globalMatch(source);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        const QString path = resolvePath(directory, match.captured(1));
+        if (isOutside(path))
+            continue;
+        if (path.endsWith(QLatin1String(".js"), Qt::CaseInsensitive)) {
+            dependencies.insert(path);
+        } else {
+            dependencies.insert(resolvePath(path, QStringLiteral("qmldir")));
+            typeDirectories.insert(match.captured(2), path);
+        }
+    }
+
+    // Modules in the workspace, assuming the workspace is an import path
+    it = moduleImports.globalMatch(source);
+    while (it.hasNext()) {
+        QString path = it.next().captured(1);
+        path.replace(QLatin1Char('.'), QLatin1Char('/'));
+        dependencies.insert(resolvePath(path, QStringLiteral("qmldir")));
+    }
+
+    it = types.globalMatch(source);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        const QString fileName = match.captured(2) + QLatin1String(".qml");
+        foreach (const QString &typeDirectory, typeDirectories.values(match.captured(1)))
+            dependencies.insert(resolvePath(typeDirectory, fileName));
+    }
+
+    scanUrls(directory, source, &dependencies);
+
+    return sorted(dependencies, document);
+}
+
+/*!
+ * Returns the documents used by the JavaScript \a document with the given \a content.
+ */
+QStringList DependencyGraph::scanJavaScript(const QString &document, const QByteArray &content)
+{
+    QSet<QString> dependencies;
+    scanUrls(QFileInfo(document).path(), stripComments(content), &dependencies);
+    return sorted(dependencies, document);
+}
+
+/*!
+ * Returns the documents listed by the qmldir \a document, found in the absolute
+ * \a directory.
+ */
+QStringList DependencyGraph::scanQmldir(const QString &document, const QString &directory)
+{
+    const ImportPathIndex::Module module = ImportPathIndex::readQmldir(directory);
+    const QString documentDirectory = QFileInfo(document).path();
+
+    QSet<QString> dependencies;
+    foreach (const QString &fileName, module.components.values() + module.scripts.values()) {
+        const QString path = resolvePath(documentDirectory, fileName);
+        if (!isOutside(path))
+            dependencies.insert(path);
+    }
+
+    return sorted(dependencies, document);
+}
+
+/*!
+ * Fills \a entry for \a document, reading the file at \a filePath unless its
+ * \a size and \a lastModified time match the entry listed already.
+ */
+bool DependencyGraph::scanDocument(const QString &document, const QString &filePath, qint64 size,
+                                   const QDateTime &lastModified, Entry *entry) const
+{
+    *entry = m_entries.value(document);
+    if (entry->size == size && entry->lastModified == lastModified)
+        return true;
+
+    if (QFileInfo(filePath).fileName() == QLatin1String("qmldir")) {
+        entry->dependencies = scanQmldir(document, QFileInfo(filePath).absolutePath());
+    } else {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        if (filePath.endsWith(QLatin1String(".js"), Qt::CaseInsensitive))
+            entry->dependencies = scanJavaScript(document, file.readAll());
+        else
+            entry->dependencies = scanQml(document, file.readAll());
+    }
+
+    entry->size = size;
+    entry->lastModified = lastModified;
+    return true;
+}
@@ -0,0 +1,346 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "discoveryannouncer.h"
+#include "ipc/discoverydatagram.h"
+#include "livedocument.h"
+#include "qmllive_version.h"
+
+#include <QUdpSocket>
+
+#ifdef QMLLIVE_DEBUG
+#define DEBUG qDebug()
+#else
+#define DEBUG if (0) qDebug()
+#endif
+
+namespace {
+const int DEFAULT_ANNOUNCE_INTERVAL = 2000;
+// An announcement stays valid for this many intervals, so single lost datagrams are tolerated
+const int ANNOUNCEMENTS_PER_TTL = 3;
+// Minimum delay between announcements caused by document updates
+const int MINIMUM_ANNOUNCE_DELAY = 500;
+// Replies to a query are spread over this period to not flood the bench
+const int QUERY_REPLY_SPREAD = 250;
+}
+
+/*!
+ * \class DiscoveryAnnouncer
+ * \brief Announces a runtime to benches on the local network
+ * \inmodule qmllive
+ *
+ * The announcer periodically sends a small UDP multicast datagram carrying
+ * the runtime id(), the IPC port a RemoteReceiver listens on, the QmlLive
+ * version, the systemName() and the hash of the workspace manifest(). Benches
+ * use it to list runtimes they can connect to.
+ *
+ * The manifest should follow the documents the node actually stored, see
+ * LiveNodeEngine::documentUpdated(). Passed to
+ * RemoteReceiver::setWorkspaceManifest(), it lets benches skip publishing a
+ * workspace the runtime already has.
+ *
+ * Announcements are repeated every interval() and sent early, yet at most
+ * every 500 milliseconds, when a document is updated. Benches joining the
+ * network query all runtimes, which answer within a short random delay.
+ */
+
+/*!
+ * Standard constructor using \a parent as parent
+ */
+DiscoveryAnnouncer::DiscoveryAnnouncer(QObject *parent)
+    : QObject(parent)
+    , m_socket(0)
+    , m_announceTimer(new QTimer(this))
+    , m_pendingTimer(new QTimer(this))
+    , m_port(0)
+    , m_ipcPort(10234)
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+    , m_systemName(QSysInfo::prettyProductName())
+#endif
+{
+    m_announceTimer->setInterval(DEFAULT_ANNOUNCE_INTERVAL);
+    connect(m_announceTimer, &QTimer::timeout, this, &DiscoveryAnnouncer::announce);
+
+    m_pendingTimer->setSingleShot(true);
+    connect(m_pendingTimer, &QTimer::timeout, this, &DiscoveryAnnouncer::announce);
+}
+
+/*!
+ * Destroys the announcer, telling benches the runtime is gone if active.
+ */
+DiscoveryAnnouncer::~DiscoveryAnnouncer()
+{
+    stop();
+}
+
+/*!
+ * Returns the id announced.
+ *
+ * Unless set with setId(), start() picks an id which is kept in the
+ * application settings for the IPC port, so that benches recognize the
+ * runtime after it restarts.
+ */
+QUuid DiscoveryAnnouncer::id() const
+{
+    return m_id;
+}
+
+/*!
+ * Sets the id announced to \a id.
+ */
+void DiscoveryAnnouncer::setId(const QUuid &id)
+{
+    m_id = id;
+}
+
+/*!
+ * Returns the IPC port announced.
+ */
+quint16 DiscoveryAnnouncer::ipcPort() const
+{
+    return m_ipcPort;
+}
+
+/*!
+ * Sets the IPC port announced to \a port.
+ */
+void DiscoveryAnnouncer::setIpcPort(quint16 port)
+{
+    m_ipcPort = port;
+}
+
+/*!
+ * Returns the system name announced. Defaults to the name of the operating system.
+ */
+QString DiscoveryAnnouncer::systemName() const
+{
+    return m_systemName;
+}
+
+/*!
+ * Sets the system name announced to \a name.
+ */
+void DiscoveryAnnouncer::setSystemName(const QString &name)
+{
+    m_systemName = name;
+}
+
+/*!
+ * Returns the interval in milliseconds between announcements.
+ */
+int DiscoveryAnnouncer::interval() const
+{
+    return m_announceTimer->interval();
+}
+
+/*!
+ * Sets the interval in milliseconds between announcements to \a msec.
+ */
+void DiscoveryAnnouncer::setInterval(int msec)
+{
+    m_announceTimer->setInterval(msec);
+}
+
+/*!
+ * Builds the manifest of the workspace at \a path. This reads all workspace documents.
+ */
+void DiscoveryAnnouncer::setWorkspace(const QString &path)
+{
+    m_manifest.clear();
+    if (!path.isEmpty())
+        m_manifest.scan(path);
+
+    if (isActive())
+        scheduleAnnounce(0);
+}
+
+/*!
+ * Returns the manifest of the workspace as currently known to the runtime.
+ */
+const WorkspaceManifest &DiscoveryAnnouncer::manifest() const
+{
+    return m_manifest;
+}
+
+/*!
+ * Starts announcing on the default multicast group and port.
+ */
+bool DiscoveryAnnouncer::start()
+{
+    return start(DiscoveryDatagram::defaultGroup(), DiscoveryDatagram::DefaultPort);
+}
+
+/*!
+ * Starts announcing on the multicast \a group and \a port.
+ *
+ * Returns \c false and sets errorString() if the group cannot be joined.
+ */
+bool DiscoveryAnnouncer::start(const QHostAddress &group, quint16 port)
+{
+    stop();
+
+    if (m_id.isNull()) {
+        QSettings s;
+        s.beginGroup(QStringLiteral("Discovery"));
+        const QString key = QString::number(m_ipcPort);
+        m_id = QUuid(s.value(key).toString());
+        if (m_id.isNull()) {
+            m_id = QUuid::createUuid();
+            s.setValue(key, m_id.toString());
+        }
+    }
+
+    m_socket = new QUdpSocket(this);
+    const QHostAddress any = group.protocol() == QAbstractSocket::IPv6Protocol
+            ? QHostAddress(QHostAddress::AnyIPv6) : QHostAddress(QHostAddress::AnyIPv4);
+    if (!m_socket->bind(any, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)
+            || !m_socket->joinMulticastGroup(group)) {
+        m_errorString = m_socket->errorString();
+        delete m_socket;
+        m_socket = 0;
+        return false;
+    }
+    connect(m_socket, &QUdpSocket::readyRead, this, &DiscoveryAnnouncer::readDatagrams);
+
+    m_group = group;
+    m_port = port;
+    m_errorString.clear();
+
+    announce();
+    return true;
+}
+
+/*!
+ * Stops announcing and tells benches the runtime is gone.
+ */
+void DiscoveryAnnouncer::stop()
+{
+    if (!m_socket)
+        return;
+
+    DiscoveryDatagram datagram;
+    datagram.type = DiscoveryDatagram::Leave;
+    datagram.id = m_id;
+    send(datagram);
+
+    m_announceTimer->stop();
+    m_pendingTimer->stop();
+    delete m_socket;
+    m_socket = 0;
+}
+
+/*!
+ * Returns \c true if announcing.
+ */
+bool DiscoveryAnnouncer::isActive() const
+{
+    return m_socket != 0;
+}
+
+/*!
+ * Returns a description of the last error start() failed with.
+ */
+QString DiscoveryAnnouncer::errorString() const
+{
+    return m_errorString;
+}
+
+/*!
+ * Announces the runtime immediately.
+ */
+void DiscoveryAnnouncer::announce()
+{
+    if (!m_socket)
+        return;
+
+    DiscoveryDatagram datagram;
+    datagram.type = DiscoveryDatagram::Announce;
+    datagram.id = m_id;
+    datagram.port = m_ipcPort;
+    datagram.ttl = m_announceTimer->interval() * ANNOUNCEMENTS_PER_TTL;
+    datagram.productVersion = QString::fromLatin1(QMLLIVE_VERSION_STR);
+    datagram.systemName = m_systemName;
+    datagram.manifestHash = m_manifest.hash();
+    send(datagram);
+
+    m_lastAnnounced.start();
+    m_pendingTimer->stop();
+    m_announceTimer->start();
+}
+
+/*!
+ * Records that \a document was updated to \a content and announces the new
+ * manifest hash soon.
+ */
+void DiscoveryAnnouncer::updateDocument(const LiveDocument &document, const QByteArray &content)
+{
+    m_manifest.update(document.relativeFilePath(), content);
+
+    if (isActive())
+        scheduleAnnounce(MINIMUM_ANNOUNCE_DELAY - m_lastAnnounced.elapsed());
+}
+
+/*!
+ * Answers queries from benches.
+ */
+void DiscoveryAnnouncer::readDatagrams()
+{
+    while (m_socket && m_socket->hasPendingDatagrams()) {
+        QByteArray data;
+        data.resize(int(m_socket->pendingDatagramSize()));
+        if (m_socket->readDatagram(data.data(), data.size()) < 0)
+            continue;
+
+        DiscoveryDatagram datagram;
+        if (!datagram.decode(data) || datagram.type != DiscoveryDatagram::Query)
+            continue;
+
+        DEBUG << "Discovery query received";
+
+        // The id is random, use it to spread the replies of many runtimes
+        scheduleAnnounce(m_id.data1 % QUERY_REPLY_SPREAD);
+    }
+}
+
+void DiscoveryAnnouncer::scheduleAnnounce(int delay)
+{
+    if (m_pendingTimer->isActive() && m_pendingTimer->remainingTime() <= delay)
+        return;
+
+    m_pendingTimer->start(qMax(0, delay));
+}
+
+void DiscoveryAnnouncer::send(const DiscoveryDatagram &datagram)
+{
+    const QByteArray data = datagram.encode();
+    if (m_socket->writeDatagram(data, m_group, m_port) != data.size())
+        DEBUG << "Failed to send discovery datagram:" << m_socket->errorString();
+}
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+#include <QHostAddress>
+
+#include "workspacemanifest.h"
+#include "qmllive_global.h"
+
+class LiveDocument;
+struct DiscoveryDatagram;
+QT_FORWARD_DECLARE_CLASS(QUdpSocket)
+
+class QMLLIVESHARED_EXPORT DiscoveryAnnouncer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DiscoveryAnnouncer(QObject *parent = 0);
+    ~DiscoveryAnnouncer();
+
+    QUuid id() const;
+    void setId(const QUuid &id);
+    quint16 ipcPort() const;
+    void setIpcPort(quint16 port);
+    QString systemName() const;
+    void setSystemName(const QString &name);
+    int interval() const;
+    void setInterval(int msec);
+
+    void setWorkspace(const QString &path);
+    const WorkspaceManifest &manifest() const;
+
+    bool start();
+    bool start(const QHostAddress &group, quint16 port);
+    void stop();
+    bool isActive() const;
+    QString errorString() const;
+
+public Q_SLOTS:
+    void announce();
+    void updateDocument(const LiveDocument &document, const QByteArray &content);
+
+private Q_SLOTS:
+    void readDatagrams();
+
+private:
+    void scheduleAnnounce(int delay);
+    void send(const DiscoveryDatagram &datagram);
+
+private:
+    QUdpSocket *m_socket;
+    QTimer *m_announceTimer;
+    QTimer *m_pendingTimer;
+    QElapsedTimer m_lastAnnounced;
+    QHostAddress m_group;
+    quint16 m_port;
+    QString m_errorString;
+
+    QUuid m_id;
+    quint16 m_ipcPort;
+    QString m_systemName;
+    WorkspaceManifest m_manifest;
+};
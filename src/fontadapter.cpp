@@ -42,6 +42,11 @@ FontAdapter::FontAdapter(QObject *parent) :
     fontExtensions.append(".otf");
 }
 
+QStringList FontAdapter::supportedSuffixes()
+{
+    return QStringList() << QStringLiteral("ttf") << QStringLiteral("otf");
+}
+
 void FontAdapter::cleanUp()
 {
     base.removeAllApplicationFonts();
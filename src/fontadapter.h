@@ -43,6 +43,8 @@ class FontAdapter : public QObject, public ContentAdapterInterface
 public:
     explicit FontAdapter(QObject *parent = 0);
 
+    static QStringList supportedSuffixes();
+
     void cleanUp();
 
     bool canPreview(const QString& path) const;
@@ -31,16 +31,36 @@
 
 #include "imageadapter.h"
 #include "livedocument.h"
+#include "tileimageprovider.h"
 #include <QImageReader>
 #include <QDebug>
 #include <QFileInfo>
 #include <QQmlContext>
+#include <QQmlEngine>
+
+namespace {
+const char TILE_PROVIDER[] = "qmlLiveTiles";
+// Images larger than this in any dimension are viewed tile by tile
+const int TILED_VIEW_THRESHOLD = 4096;
+}
 
 ImageAdapter::ImageAdapter(QObject *parent) :
     QObject(parent)
 {
 }
 
+QStringList ImageAdapter::supportedSuffixes()
+{
+    static const QStringList suffixes = [] {
+        QStringList suffixes;
+        foreach (const QByteArray &format, QImageReader::supportedImageFormats())
+            suffixes.append(QString::fromLatin1(format).toLower());
+        suffixes.removeDuplicates();
+        return suffixes;
+    }();
+    return suffixes;
+}
+
 bool ImageAdapter::canPreview(const QString &path) const
 {
     QString format = QImageReader::imageFormat(path);
@@ -58,16 +78,35 @@ bool ImageAdapter::canPreview(const QString &path) const
 
 QImage ImageAdapter::preview(const QString &path, const QSize &requestedSize)
 {
-    QImage img(path);
+    QImageReader reader(path);
+
+    // Let the decoder downscale, so that huge images are not decoded in full by
+    // formats able to, like JPEG. Others, like PNG, decode in full and scale then.
+    const QSize size = reader.size();
+    if (requestedSize.isValid() && size.isValid()) {
+        reader.setScaledSize(size.scaled(requestedSize, Qt::KeepAspectRatio));
+        QImage img = reader.read();
+        if (!img.isNull())
+            return img;
+        reader.setFileName(path);
+        reader.setScaledSize(QSize());
+    }
 
-    if (requestedSize.isValid())
-        return img.scaled(requestedSize, Qt::KeepAspectRatio);
+    QImage img = reader.read();
+    if (requestedSize.isValid() && !img.isNull())
+        return img.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     return img;
 }
 
 bool ImageAdapter::canAdapt(const QUrl &url) const
 {
-    return !QImageReader::imageFormat(LiveDocument::toFilePath(url)).isEmpty();
+    const QString path = LiveDocument::toFilePath(url);
+
+    // Trust the suffix when it names a known format to avoid opening the file
+    if (supportedSuffixes().contains(QFileInfo(path).suffix().toLower()))
+        return true;
+
+    return !QImageReader::imageFormat(path).isEmpty();
 }
 
 QUrl ImageAdapter::adapt(const QUrl &url, QQmlContext *context)
@@ -75,6 +114,21 @@ QUrl ImageAdapter::adapt(const QUrl &url, QQmlContext *context)
     context->setContextProperty("imageViewerBackgroundColor", "black");
     context->setContextProperty("imageViewerSource", url);
 
+    const QString path = LiveDocument::toFilePath(url);
+    const QSize size = QImageReader(path).size();
+    const bool tiled = size.isValid()
+            && (size.width() > TILED_VIEW_THRESHOLD || size.height() > TILED_VIEW_THRESHOLD);
+
+    if (tiled && !context->engine()->imageProvider(TILE_PROVIDER))
+        context->engine()->addImageProvider(TILE_PROVIDER, new TileImageProvider);
+
+    context->setContextProperty("imageViewerTiled", tiled);
+    context->setContextProperty("imageViewerSize", size);
+    context->setContextProperty("imageViewerPath", path);
+    context->setContextProperty("imageViewerTileSize", TileImageProvider::TileSize);
+    context->setContextProperty("imageViewerLevelCount", TileImageProvider::levelCount(size));
+    context->setContextProperty("imageViewerFirstLevel", tiled ? TileImageProvider::firstLevel(path) : 0);
+
     return QUrl("qrc:/livert/imageviewer_qt5.qml");
 }
 
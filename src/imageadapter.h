@@ -41,6 +41,8 @@ class ImageAdapter : public QObject, public ContentAdapterInterface
 public:
     explicit ImageAdapter(QObject *parent = 0);
 
+    static QStringList supportedSuffixes();
+
     bool canPreview(const QString& path) const;
     QImage preview(const QString& path, const QSize &requestedSize);
 
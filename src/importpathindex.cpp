@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "importpathindex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ipiLog)
+Q_LOGGING_CATEGORY(ipiLog, "QmlLive.ImportPathIndex", QtInfoMsg)
+
+/*!
+ * \class ImportPathIndex
+ * \brief Locates QML modules under a list of import paths
+ * \inmodule qmllive
+ *
+ * Modules are looked up on first use and remembered together with the parsed
+ * content of their \c qmldir file, so that repeated queries do not touch the
+ * file system. The index is invalidated when the import paths change.
+ *
+ * \sa QQmlEngine::importPathList()
+ */
+
+/*!
+ * \class ImportPathIndex::Module
+ * \brief Describes a QML module found under an import path
+ * \inmodule qmllive
+ */
+
+/*!
+ * Constructs an empty index.
+ */
+ImportPathIndex::ImportPathIndex()
+{
+}
+
+/*!
+ * Returns the import paths searched for modules.
+ */
+QStringList ImportPathIndex::importPaths() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_importPaths;
+}
+
+/*!
+ * Sets the import paths searched for modules to \a importPaths.
+ *
+ * Returns \c true and drops all cached lookups if \a importPaths differ from
+ * the current ones. Returns \c false otherwise.
+ */
+bool ImportPathIndex::setImportPaths(const QStringList &importPaths)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (importPaths == m_importPaths)
+        return false;
+
+    qCDebug(ipiLog) << "Import paths changed:" << importPaths;
+
+    m_importPaths = importPaths;
+    m_modules.clear();
+    return true;
+}
+
+/*!
+ * Returns the module identified by \a uri, e.g. \c QtQuick.Controls, or an
+ * invalid module if not found. With \a majorVersion given, a versioned module
+ * directory like \c QtQuick/Controls.2 is preferred.
+ */
+ImportPathIndex::Module ImportPathIndex::module(const QString &uri, int majorVersion) const
+{
+    const QString key = majorVersion < 0 ? uri : uri + QLatin1Char('.') + QString::number(majorVersion);
+
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_modules.constFind(key);
+    if (it != m_modules.constEnd())
+        return *it;
+
+    const QString relativePath = QString(uri).replace(QLatin1Char('.'), QLatin1Char('/'));
+    QStringList candidates;
+    if (majorVersion >= 0)
+        candidates << relativePath + QLatin1Char('.') + QString::number(majorVersion);
+    candidates << relativePath;
+
+    Module module;
+    foreach (const QString &importPath, m_importPaths) {
+        const QDir dir(importPath);
+        foreach (const QString &candidate, candidates) {
+            if (QFileInfo(dir.filePath(candidate + QLatin1String("/qmldir"))).isFile()) {
+                module = readQmldir(dir.filePath(candidate));
+                break;
+            }
+        }
+        if (module.isValid())
+            break;
+    }
+
+    qCDebug(ipiLog) << "Module" << key << "found at" << module.directory;
+
+    m_modules.insert(key, module);
+    return module;
+}
+
+/*!
+ * Returns \c true if the module identified by \a uri and optionally
+ * \a majorVersion exists under any of the import paths.
+ *
+ * \sa module()
+ */
+bool ImportPathIndex::hasModule(const QString &uri, int majorVersion) const
+{
+    return module(uri, majorVersion).isValid();
+}
+
+/*!
+ * Parses the \c qmldir file found in \a directory.
+ *
+ * Returns an invalid module if the file cannot be read.
+ */
+ImportPathIndex::Module ImportPathIndex::readQmldir(const QString &directory)
+{
+    Module module;
+
+    QFile file(QDir(directory).filePath(QStringLiteral("qmldir")));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCWarning(ipiLog) << "Failed to read" << file.fileName() << ":" << file.errorString();
+        return module;
+    }
+
+    module.directory = directory;
+
+    auto versionLessThan = [](const QString &v1, const QString &v2) {
+        const int major1 = v1.section(QLatin1Char('.'), 0, 0).toInt();
+        const int major2 = v2.section(QLatin1Char('.'), 0, 0).toInt();
+        if (major1 != major2)
+            return major1 < major2;
+        return v1.section(QLatin1Char('.'), 1, 1).toInt() < v2.section(QLatin1Char('.'), 1, 1).toInt();
+    };
+
+    QHash<QString, QString> componentVersions;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        QStringList fields = line.split(QLatin1Char(' '), QString::SkipEmptyParts);
+        if (fields.first() == QLatin1String("singleton") || fields.first() == QLatin1String("internal"))
+            fields.removeFirst();
+        if (fields.isEmpty())
+            continue;
+
+        const QString &command = fields.first();
+        if (command == QLatin1String("module") && fields.size() > 1) {
+            module.name = fields.at(1);
+        } else if (command == QLatin1String("plugin") && fields.size() > 1) {
+            module.plugins.append(fields.at(1));
+        } else if (fields.size() == 3) {
+            // <TypeName> <Version> <File>
+            const QString &version = fields.at(1);
+            const QString &fileName = fields.at(2);
+            QHash<QString, QString> &target = fileName.endsWith(QLatin1String(".js"))
+                    ? module.scripts : module.components;
+            if (!target.contains(command)
+                    || versionLessThan(componentVersions.value(command), version)) {
+                target.insert(command, fileName);
+                componentVersions.insert(command, version);
+            }
+        }
+    }
+
+    return module;
+}
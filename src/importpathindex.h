@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2016 Pelagicore AG
+** Copyright (C) 2018 Jolla Ltd
 ** Contact: https://www.qt.io/licensing/
 **
 ** This file is part of the QmlLive tool.
@@ -29,54 +29,40 @@
 **
 ****************************************************************************/
 
-#include "filesystemmodel.h"
+#pragma once
 
-FileSystemModel::FileSystemModel(QObject *parent) :
-    QFileSystemModel(parent) ,
-    m_dirSelectable(true)
-{
-}
-
-void FileSystemModel::setAllowedTypesFilter(QStringList allowed)
-{
-    m_allowedTypes = allowed;
-}
-
-QStringList FileSystemModel::allowedTypesFilter() const
-{
-    return m_allowedTypes;
-}
-
-void FileSystemModel::setDirectoriesSelectable(bool enabled)
-{
-    m_dirSelectable = enabled;
-}
+#include <QtCore>
 
-bool FileSystemModel::directoriesSelectable() const
-{
-    return m_dirSelectable;
-}
+#include "qmllive_global.h"
 
-Qt::ItemFlags FileSystemModel::flags(const QModelIndex &index) const
+class QMLLIVESHARED_EXPORT ImportPathIndex
 {
-    Qt::ItemFlags f = QFileSystemModel::flags(index);
+public:
+    struct Module
+    {
+        bool isValid() const { return !directory.isEmpty(); }
 
-    if (isDir(index)) {
-        f &= ~Qt::ItemIsDragEnabled;
-        if (m_dirSelectable)
-            return f;
-        else
-            return f & ~Qt::ItemIsSelectable;
-    }
+        QString directory;
+        QString name;
+        QStringList plugins;
+        // type name -> file name, for the highest version listed
+        QHash<QString, QString> components;
+        QHash<QString, QString> scripts;
+    };
 
-    QString path = filePath(index);
+    ImportPathIndex();
 
-    foreach (QString type, m_allowedTypes) {
-        if (path.contains(QRegExp(type, Qt::CaseInsensitive, QRegExp::Wildcard)))
-            return f;
-    }
+    QStringList importPaths() const;
+    bool setImportPaths(const QStringList &importPaths);
 
-    return f & ~Qt::ItemIsSelectable;
-}
+    Module module(const QString &uri, int majorVersion = -1) const;
+    bool hasModule(const QString &uri, int majorVersion = -1) const;
 
+    static Module readQmldir(const QString &directory);
 
+private:
+    mutable QMutex m_mutex;
+    QStringList m_importPaths;
+    // uri[.major] -> module, invalid if not found
+    mutable QHash<QString, Module> m_modules;
+};
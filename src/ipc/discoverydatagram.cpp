@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "discoverydatagram.h"
+
+/*
+ * Datagram layout, all numbers in network byte order:
+ *
+ *   quint32 magic, quint8 version, quint8 type
+ *
+ * followed for Leave datagrams by
+ *
+ *   QUuid id
+ *
+ * and for Announce datagrams by
+ *
+ *   QUuid id, quint16 port, quint32 ttl (msec), QString productVersion,
+ *   QString systemName, QByteArray manifestHash
+ *
+ * Query datagrams carry no payload, every runtime receiving one announces itself.
+ */
+
+QHostAddress DiscoveryDatagram::defaultGroup()
+{
+    return QHostAddress(QStringLiteral("239.255.43.22"));
+}
+
+QByteArray DiscoveryDatagram::encode() const
+{
+    QByteArray datagram;
+
+    QDataStream out(&datagram, QIODevice::WriteOnly);
+    out << Magic << Version << type;
+    if (type == Announce || type == Leave)
+        out << id;
+    if (type == Announce)
+        out << port << ttl << productVersion << systemName << manifestHash;
+
+    return datagram;
+}
+
+bool DiscoveryDatagram::decode(const QByteArray &datagram)
+{
+    QDataStream in(datagram);
+    quint32 magic;
+    quint8 version;
+    in >> magic >> version >> type;
+    if (in.status() != QDataStream::Ok || magic != Magic || version != Version)
+        return false;
+
+    switch (type) {
+    case Announce:
+        in >> id >> port >> ttl >> productVersion >> systemName >> manifestHash;
+        return in.status() == QDataStream::Ok && !id.isNull() && port != 0;
+    case Leave:
+        in >> id;
+        return in.status() == QDataStream::Ok && !id.isNull();
+    case Query:
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+#include <QtNetwork>
+
+#include "qmllive_global.h"
+
+struct QMLLIVESHARED_EXPORT DiscoveryDatagram
+{
+    enum Type {
+        Announce = 0,
+        Query = 1,
+        Leave = 2
+    };
+
+    static const quint32 Magic = 0x514c4441; // "QLDA"
+    static const quint8 Version = 1;
+    static const quint16 DefaultPort = 10236;
+
+    static QHostAddress defaultGroup();
+
+    quint8 type = Announce;
+    QUuid id;
+    // Announce: the IPC port of the runtime and how long the announcement stays valid
+    quint16 port = 0;
+    quint32 ttl = 0;
+    QString productVersion;
+    QString systemName;
+    QByteArray manifestHash;
+
+    QByteArray encode() const;
+    bool decode(const QByteArray &datagram);
+};
@@ -3,9 +3,19 @@ QT += network
 SOURCES += \
     $$PWD/ipcserver.cpp \
     $$PWD/ipcconnection.cpp \
-    $$PWD/ipcclient.cpp
+    $$PWD/ipcclient.cpp \
+    $$PWD/multicastdatagram.cpp \
+    $$PWD/multicastsender.cpp \
+    $$PWD/multicastreceiver.cpp \
+    $$PWD/discoverydatagram.cpp \
+    $$PWD/logdatagram.cpp
 
 HEADERS += \
     $$PWD/ipcserver.h \
     $$PWD/ipcconnection.h \
-    $$PWD/ipcclient.h
+    $$PWD/ipcclient.h \
+    $$PWD/multicastdatagram.h \
+    $$PWD/multicastsender.h \
+    $$PWD/multicastreceiver.h \
+    $$PWD/discoverydatagram.h \
+    $$PWD/logdatagram.h
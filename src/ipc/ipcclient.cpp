@@ -82,7 +82,7 @@ IpcClient::IpcClient(QObject *parent)
     , m_socket(new QTcpSocket(this))
     , m_current(0)
     , m_written(0)
-    , m_connection(new IpcConnection(m_socket))
+    , m_connection(new IpcConnection(m_socket, this))
 {
     connect(m_socket, &QAbstractSocket::connected, this, &IpcClient::connected);
     connect(m_socket, &QAbstractSocket::connected, this, &IpcClient::processQueue);
@@ -53,7 +53,7 @@ public:
     bool waitForDisconnected(int msecs = 30000);
     bool waitForSent(const QUuid uuid, int msecs = 30000);
 
-    QString errorToString(QAbstractSocket::SocketError error);
+    static QString errorToString(QAbstractSocket::SocketError error);
 
 Q_SIGNALS:
     void connected();
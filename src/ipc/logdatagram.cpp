@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "logdatagram.h"
+
+/*
+ * Datagram layout, all numbers in network byte order:
+ *
+ *   quint32 magic, quint8 version, quint32 session, quint32 sequence, quint16 count
+ *
+ * followed by count records
+ *
+ *   qint8 type, QString message, QString url, qint32 line, qint32 column
+ *
+ * The session is chosen randomly by each sender, the sequence number increases by
+ * one with each datagram of a session.
+ */
+
+int LogDatagram::headerSize()
+{
+    return 4 + 1 + 4 + 4 + 2;
+}
+
+int LogDatagram::recordSize(const Record &record)
+{
+    // Strings are serialized as a quint32 byte count followed by UTF-16 data
+    return 1 + 4 + 2 * record.message.size() + 4 + 2 * record.url.toString().size() + 4 + 4;
+}
+
+QByteArray LogDatagram::encode() const
+{
+    QByteArray datagram;
+
+    QDataStream out(&datagram, QIODevice::WriteOnly);
+    out << Magic << Version << session << sequence << quint16(records.count());
+    foreach (const Record &record, records) {
+        out << qint8(record.type) << record.message << record.url.toString()
+            << qint32(record.line) << qint32(record.column);
+    }
+
+    return datagram;
+}
+
+bool LogDatagram::decode(const QByteArray &datagram)
+{
+    QDataStream in(datagram);
+    quint32 magic;
+    quint8 version;
+    quint16 count;
+    in >> magic >> version >> session >> sequence >> count;
+    if (in.status() != QDataStream::Ok || magic != Magic || version != Version)
+        return false;
+
+    records.clear();
+    for (int i = 0; i < count; ++i) {
+        qint8 type;
+        QString url;
+        qint32 line;
+        qint32 column;
+        Record record;
+        in >> type >> record.message >> url >> line >> column;
+        if (in.status() != QDataStream::Ok)
+            return false;
+        record.type = type;
+        record.url = QUrl(url);
+        record.line = line;
+        record.column = column;
+        records.append(record);
+    }
+
+    return true;
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+
+#include "qmllive_global.h"
+
+struct QMLLIVESHARED_EXPORT LogDatagram
+{
+    static const quint32 Magic = 0x514c4c47; // "QLLG"
+    static const quint8 Version = 1;
+    // Batches are closed before exceeding this size to avoid IP fragmentation
+    static const int MaximumSize = 1400;
+
+    struct Record
+    {
+        int type = QtDebugMsg;
+        QString message;
+        QUrl url;
+        int line = -1;
+        int column = -1;
+    };
+
+    quint32 session = 0;
+    quint32 sequence = 0;
+    QList<Record> records;
+
+    static int headerSize();
+    static int recordSize(const Record &record);
+
+    QByteArray encode() const;
+    bool decode(const QByteArray &datagram);
+};
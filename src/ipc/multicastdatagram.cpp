@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "multicastdatagram.h"
+
+/*
+ * Datagram layout, all numbers in network byte order:
+ *
+ *   quint32 magic, quint8 version, quint8 type, quint32 session, quint32 sequence
+ *
+ * followed for Data datagrams by
+ *
+ *   quint32 transfer, quint32 fragment, quint32 fragmentCount, raw chunk
+ *
+ * and finally by the first MacSize bytes of the HMAC-SHA256 of all the preceding
+ * bytes, keyed with the session key.
+ *
+ * Sequence numbers are assigned per datagram and let receivers detect losses.
+ * A transfer is one published document split into fragmentCount chunks.
+ *
+ * The session identifier travels in clear, the key does not travel with the
+ * datagrams. Receivers get it through the PIN authenticated IPC connection,
+ * so that other hosts on the network cannot inject documents.
+ */
+
+namespace {
+QByteArray mac(const QByteArray &data, const QByteArray &key)
+{
+    return QMessageAuthenticationCode::hash(data, key, QCryptographicHash::Sha256)
+            .left(MulticastDatagram::MacSize);
+}
+
+// Compares in constant time, not to reveal how many leading bytes match
+bool isEqual(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size())
+        return false;
+    char difference = 0;
+    for (int i = 0; i < a.size(); ++i)
+        difference |= a.at(i) ^ b.at(i);
+    return difference == 0;
+}
+}
+
+QByteArray MulticastDatagram::encode(const QByteArray &key) const
+{
+    QByteArray datagram;
+    datagram.reserve(DataHeaderSize + chunk.size() + MacSize);
+
+    QDataStream out(&datagram, QIODevice::WriteOnly);
+    out << Magic << Version << type << session << sequence;
+    if (type == Data) {
+        out << transfer << fragment << fragmentCount;
+        out.writeRawData(chunk.constData(), chunk.size());
+    }
+
+    datagram.append(mac(datagram, key));
+
+    return datagram;
+}
+
+bool MulticastDatagram::decode(const QByteArray &bytes, const QByteArray &key)
+{
+    if (bytes.size() < HeaderSize + MacSize)
+        return false;
+
+    const QByteArray datagram = bytes.left(bytes.size() - MacSize);
+    if (!isEqual(mac(datagram, key), bytes.right(MacSize)))
+        return false;
+
+    QDataStream in(datagram);
+    quint32 magic;
+    quint8 version;
+    in >> magic >> version >> type >> session >> sequence;
+    if (magic != Magic || version != Version)
+        return false;
+
+    if (type == Heartbeat)
+        return true;
+
+    if (type != Data || datagram.size() < DataHeaderSize)
+        return false;
+
+    in >> transfer >> fragment >> fragmentCount;
+    if (fragment >= fragmentCount || fragmentCount > MaxFragmentCount)
+        return false;
+
+    chunk = datagram.mid(DataHeaderSize);
+    return in.status() == QDataStream::Ok;
+}
+
+/*
+ * Returns a new random session key of KeySize bytes.
+ */
+QByteArray MulticastDatagram::createKey()
+{
+    QByteArray key;
+    while (key.size() < KeySize)
+        key += QUuid::createUuid().toRfc4122();
+    return key.left(KeySize);
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+
+struct MulticastDatagram
+{
+    enum Type {
+        Data = 0,
+        Heartbeat = 1
+    };
+
+    static const quint32 Magic = 0x514c4d43; // "QLMC"
+    static const quint8 Version = 2;
+    static const int HeaderSize = 4 + 1 + 1 + 4 + 4;
+    static const int DataHeaderSize = HeaderSize + 4 + 4 + 4;
+    static const int MacSize = 16;
+    static const int MaxChunkSize = 1200;
+    static const int MaxPayloadSize = 64 * 1024 * 1024;
+    static const quint32 MaxFragmentCount = (MaxPayloadSize + MaxChunkSize - 1) / MaxChunkSize;
+    static const int KeySize = 32;
+
+    quint8 type = Data;
+    quint32 session = 0;
+    // Data: sequence number of this datagram, Heartbeat: last sequence number sent
+    quint32 sequence = 0;
+    quint32 transfer = 0;
+    quint32 fragment = 0;
+    quint32 fragmentCount = 0;
+    QByteArray chunk;
+
+    QByteArray encode(const QByteArray &key) const;
+    bool decode(const QByteArray &datagram, const QByteArray &key);
+
+    static QByteArray createKey();
+};
@@ -0,0 +1,299 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "multicastreceiver.h"
+#include "multicastdatagram.h"
+
+#ifdef QMLLIVE_IPC_DEBUG
+#define DEBUG qDebug()
+#else
+#define DEBUG if (0) qDebug()
+#endif
+
+namespace {
+// Give reordered datagrams a chance before asking for them
+const int NACK_DELAY = 20;
+const int NACK_INTERVAL = 200;
+const int MAX_NACK_COUNT = 512;
+}
+
+/*!
+ * \class MulticastReceiver
+ * \brief The MulticastReceiver receives payloads sent by a MulticastSender.
+ * \inmodule ipc
+ *
+ * The receiver joins a multicast group and reassembles the payloads of one sender
+ * session, starting with a given sequence number. Every payload is reported with the
+ * received() signal as soon as all of its datagrams arrived, which is not necessarily
+ * in the order the payloads were sent.
+ *
+ * Only datagrams authenticated with the session key are accepted, see
+ * MulticastSender::key().
+ *
+ * Missing datagrams are reported with the nack() signal, repeatedly until they arrive.
+ * It is up to the user to forward these to the sender, usually through some reliable
+ * channel. nextSequence() tells up to which point everything has been received.
+ *
+ * \sa MulticastSender
+ */
+
+/*!
+ * \brief Standard constructor using \a parent as parent object
+ */
+MulticastReceiver::MulticastReceiver(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QUdpSocket(this))
+    , m_session(0)
+    , m_nextSequence(0)
+    , m_highestSequence(0)
+    , m_nackTimer(new QTimer(this))
+{
+    m_nackTimer->setSingleShot(true);
+    connect(m_nackTimer, &QTimer::timeout, this, &MulticastReceiver::sendNack);
+    connect(m_socket, &QUdpSocket::readyRead, this, &MulticastReceiver::readDatagrams);
+}
+
+/*!
+ * \brief Joins the multicast \a group on \a port
+ *
+ * Receives datagrams of the sender \a session authenticated with \a key, with
+ * sequence numbers starting at \a firstSequence. Returns false on failure, see
+ * errorString().
+ */
+bool MulticastReceiver::join(const QHostAddress &group, quint16 port, quint32 session,
+                             const QByteArray &key, quint32 firstSequence)
+{
+    leave();
+
+    const QHostAddress any = group.protocol() == QAbstractSocket::IPv6Protocol
+            ? QHostAddress::AnyIPv6 : QHostAddress::AnyIPv4;
+    if (!m_socket->bind(any, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        m_errorString = m_socket->errorString();
+        return false;
+    }
+
+    if (!m_socket->joinMulticastGroup(group)) {
+        m_errorString = m_socket->errorString();
+        m_socket->close();
+        return false;
+    }
+
+    m_group = group;
+    m_session = session;
+    m_key = key;
+    m_nextSequence = firstSequence;
+    m_highestSequence = firstSequence - 1;
+    m_errorString.clear();
+
+    return true;
+}
+
+/*!
+ * \brief Leaves the multicast group and drops incomplete payloads
+ */
+void MulticastReceiver::leave()
+{
+    m_nackTimer->stop();
+
+    if (m_socket->state() == QAbstractSocket::BoundState)
+        m_socket->leaveMulticastGroup(m_group);
+    m_socket->close();
+
+    m_receivedAhead.clear();
+    m_transfers.clear();
+}
+
+/*!
+ * \brief Returns true if the receiver has joined a group successfully
+ */
+bool MulticastReceiver::isJoined() const
+{
+    return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+/*!
+ * \brief Returns a description of the last error
+ */
+QString MulticastReceiver::errorString() const
+{
+    return m_errorString;
+}
+
+/*!
+ * \brief Returns the sequence number of the first datagram not received yet
+ *
+ * All datagrams with lower sequence numbers have been received or skipped.
+ */
+quint32 MulticastReceiver::nextSequence() const
+{
+    return m_nextSequence;
+}
+
+/*!
+ * \brief Gives up waiting for datagrams with sequence numbers below \a sequence
+ *
+ * Payloads affected by the skipped datagrams are dropped.
+ */
+void MulticastReceiver::skipTo(quint32 sequence)
+{
+    if (sequence <= m_nextSequence)
+        return;
+
+    for (auto it = m_transfers.begin(); it != m_transfers.end(); ) {
+        if (it->firstSequence < sequence)
+            it = m_transfers.erase(it);
+        else
+            ++it;
+    }
+
+    m_nextSequence = sequence;
+    m_highestSequence = qMax(m_highestSequence, sequence - 1);
+    advance();
+}
+
+void MulticastReceiver::readDatagrams()
+{
+    while (m_socket->hasPendingDatagrams()) {
+        QByteArray bytes;
+        bytes.resize(int(m_socket->pendingDatagramSize()));
+        if (m_socket->readDatagram(bytes.data(), bytes.size()) < 0)
+            continue;
+
+        // Datagrams of other sessions fail authentication too
+        MulticastDatagram datagram;
+        if (!datagram.decode(bytes, m_key) || datagram.session != m_session) {
+            DEBUG << "MulticastReceiver: ignoring invalid datagram";
+            continue;
+        }
+
+        process(datagram);
+    }
+}
+
+void MulticastReceiver::process(const MulticastDatagram &datagram)
+{
+    if (datagram.type == MulticastDatagram::Heartbeat) {
+        m_highestSequence = qMax(m_highestSequence, datagram.sequence);
+    } else {
+        // Duplicates and datagrams sent before we joined
+        if (datagram.sequence < m_nextSequence || m_receivedAhead.contains(datagram.sequence))
+            return;
+
+        m_receivedAhead.insert(datagram.sequence);
+        m_highestSequence = qMax(m_highestSequence, datagram.sequence);
+
+        const quint32 firstSequence = datagram.sequence - datagram.fragment;
+        if (firstSequence >= m_nextSequence || m_transfers.contains(datagram.transfer)) {
+            Transfer &transfer = m_transfers[datagram.transfer];
+            if (transfer.fragments.isEmpty()) {
+                transfer.firstSequence = firstSequence;
+                transfer.fragments.resize(datagram.fragmentCount);
+                transfer.remaining = datagram.fragmentCount;
+            }
+
+            if (int(datagram.fragment) < transfer.fragments.count()
+                    && transfer.fragments.at(datagram.fragment).isNull()) {
+                transfer.fragments[datagram.fragment] = datagram.chunk.isNull()
+                        ? QByteArray("") : datagram.chunk;
+                if (--transfer.remaining == 0) {
+                    QByteArray payload;
+                    foreach (const QByteArray &fragment, transfer.fragments)
+                        payload.append(fragment);
+                    m_transfers.remove(datagram.transfer);
+                    emit received(payload);
+                }
+            }
+        }
+    }
+
+    advance();
+}
+
+void MulticastReceiver::advance()
+{
+    const quint32 previousNext = m_nextSequence;
+
+    while (m_receivedAhead.remove(m_nextSequence))
+        ++m_nextSequence;
+
+    if (m_nextSequence <= m_highestSequence) {
+        if (!m_nackTimer->isActive())
+            m_nackTimer->start(NACK_DELAY);
+    } else {
+        m_nackTimer->stop();
+    }
+
+    if (m_nextSequence != previousNext)
+        emit progress(m_nextSequence);
+}
+
+QList<quint32> MulticastReceiver::missing() const
+{
+    QList<quint32> sequences;
+    for (quint32 sequence = m_nextSequence;
+         sequence <= m_highestSequence && sequences.count() < MAX_NACK_COUNT; ++sequence) {
+        if (!m_receivedAhead.contains(sequence))
+            sequences.append(sequence);
+    }
+    return sequences;
+}
+
+void MulticastReceiver::sendNack()
+{
+    const QList<quint32> sequences = missing();
+    if (sequences.isEmpty())
+        return;
+
+    DEBUG << "MulticastReceiver: missing" << sequences.count() << "datagrams from" << sequences.first();
+
+    emit nack(sequences);
+    m_nackTimer->start(NACK_INTERVAL);
+}
+
+/*!
+ * \fn void MulticastReceiver::received(const QByteArray &payload)
+ *
+ * This signal is emitted when all datagrams of a \a payload have been received.
+ */
+
+/*!
+ * \fn void MulticastReceiver::progress(quint32 nextSequence)
+ *
+ * This signal is emitted when all datagrams before \a nextSequence have been
+ * received or skipped.
+ */
+
+/*!
+ * \fn void MulticastReceiver::nack(const QList<quint32> &sequences)
+ *
+ * This signal is emitted regularly while the datagrams identified by \a sequences
+ * are missing.
+ */
@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+#include <QtNetwork>
+
+struct MulticastDatagram;
+
+class MulticastReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MulticastReceiver(QObject *parent = 0);
+
+    bool join(const QHostAddress &group, quint16 port, quint32 session, const QByteArray &key,
+              quint32 firstSequence);
+    void leave();
+    bool isJoined() const;
+    QString errorString() const;
+
+    quint32 nextSequence() const;
+    void skipTo(quint32 sequence);
+
+Q_SIGNALS:
+    void received(const QByteArray &payload);
+    void progress(quint32 nextSequence);
+    void nack(const QList<quint32> &sequences);
+
+private Q_SLOTS:
+    void readDatagrams();
+    void sendNack();
+
+private:
+    void process(const MulticastDatagram &datagram);
+    void advance();
+    QList<quint32> missing() const;
+
+private:
+    struct Transfer
+    {
+        quint32 firstSequence;
+        QVector<QByteArray> fragments;
+        quint32 remaining;
+    };
+
+    QUdpSocket *m_socket;
+    QHostAddress m_group;
+    QString m_errorString;
+
+    quint32 m_session;
+    QByteArray m_key;
+    quint32 m_nextSequence;
+    quint32 m_highestSequence;
+    QSet<quint32> m_receivedAhead;
+    QHash<quint32, Transfer> m_transfers;
+
+    QTimer *m_nackTimer;
+};
@@ -0,0 +1,383 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "multicastsender.h"
+#include "multicastdatagram.h"
+
+#ifdef QMLLIVE_IPC_DEBUG
+#define DEBUG qDebug()
+#else
+#define DEBUG if (0) qDebug()
+#endif
+
+namespace {
+const qint64 DEFAULT_RATE = 8 * 1024 * 1024;
+const qint64 DEFAULT_HISTORY_LIMIT = 32 * 1024 * 1024;
+const int FLUSH_INTERVAL = 5;
+const int HEARTBEAT_INTERVAL = 250;
+}
+
+/*!
+ * \class MulticastSender
+ * \brief The MulticastSender distributes payloads to many receivers at once using
+ * UDP multicast.
+ * \inmodule ipc
+ *
+ * Each payload passed to send() is split into datagrams small enough to avoid IP
+ * fragmentation. The datagrams are numbered and sent to the multicast group at a
+ * limited rate. Receivers detect gaps in the numbering and ask for the missing
+ * datagrams through some other channel, which are then passed to resend().
+ *
+ * Recently sent datagrams are kept for this purpose, up to historyLimit() bytes.
+ * While active, a heartbeat announcing the last sequence number is sent regularly so
+ * that receivers notice losses at the end of a transmission too.
+ *
+ * \sa MulticastReceiver
+ */
+
+/*!
+ * \brief Standard constructor using \a parent as parent object
+ */
+MulticastSender::MulticastSender(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QUdpSocket(this))
+    , m_port(0)
+    , m_session(0)
+    , m_nextSequence(1)
+    , m_nextTransfer(1)
+    , m_historySize(0)
+    , m_historyLimit(DEFAULT_HISTORY_LIMIT)
+    , m_rate(DEFAULT_RATE)
+    , m_lastFlush(0)
+    , m_budget(0)
+    , m_flushTimer(new QTimer(this))
+    , m_heartbeatTimer(new QTimer(this))
+{
+    m_flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(m_flushTimer, &QTimer::timeout, this, &MulticastSender::flush);
+
+    m_heartbeatTimer->setInterval(HEARTBEAT_INTERVAL);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &MulticastSender::sendHeartbeat);
+}
+
+/*!
+ * \brief Starts sending to the multicast \a group on \a port
+ *
+ * A new random session identifier is chosen, so that receivers can tell this
+ * transmission from earlier ones, together with a new session key. Returns false
+ * on failure, see errorString().
+ */
+bool MulticastSender::start(const QHostAddress &group, quint16 port)
+{
+    stop();
+
+    if (!group.isMulticast()) {
+        m_errorString = tr("Not a multicast address: %1").arg(group.toString());
+        return false;
+    }
+
+    const QHostAddress any = group.protocol() == QAbstractSocket::IPv6Protocol
+            ? QHostAddress::AnyIPv6 : QHostAddress::AnyIPv4;
+    if (!m_socket->bind(any, 0)) {
+        m_errorString = m_socket->errorString();
+        return false;
+    }
+
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+
+    m_group = group;
+    m_port = port;
+    m_errorString.clear();
+
+    m_session = QUuid::createUuid().data1;
+    m_key = MulticastDatagram::createKey();
+
+    m_clock.start();
+    m_lastFlush = 0;
+    m_budget = 0;
+    m_heartbeatTimer->start();
+
+    return true;
+}
+
+/*!
+ * \brief Stops sending and forgets all pending and sent datagrams
+ */
+void MulticastSender::stop()
+{
+    m_flushTimer->stop();
+    m_heartbeatTimer->stop();
+    m_socket->close();
+
+    m_history.clear();
+    m_historyOrder.clear();
+    m_historySize = 0;
+    m_retransmitQueue.clear();
+    m_sendQueue.clear();
+    m_nextSequence = 1;
+    m_nextTransfer = 1;
+}
+
+/*!
+ * \brief Returns true if the sender was started successfully
+ */
+bool MulticastSender::isActive() const
+{
+    return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+/*!
+ * \brief Returns a description of the last error
+ */
+QString MulticastSender::errorString() const
+{
+    return m_errorString;
+}
+
+/*!
+ * \brief Returns the multicast group address
+ */
+QHostAddress MulticastSender::group() const
+{
+    return m_group;
+}
+
+/*!
+ * \brief Returns the multicast port
+ */
+quint16 MulticastSender::port() const
+{
+    return m_port;
+}
+
+/*!
+ * \brief Returns the identifier of the current session
+ */
+quint32 MulticastSender::session() const
+{
+    return m_session;
+}
+
+/*!
+ * \brief Returns the key the datagrams of the current session are authenticated with
+ *
+ * Receivers need the key to accept the datagrams. It must only be passed to them
+ * through an authenticated channel.
+ */
+QByteArray MulticastSender::key() const
+{
+    return m_key;
+}
+
+/*!
+ * \brief Returns the sequence number the next datagram passed to send() will get
+ *
+ * All datagrams with lower sequence numbers have been queued already.
+ */
+quint32 MulticastSender::nextSequence() const
+{
+    return m_nextSequence;
+}
+
+/*!
+ * \brief Returns the maximum number of bytes sent per second
+ */
+qint64 MulticastSender::rate() const
+{
+    return m_rate;
+}
+
+/*!
+ * \brief Sets the maximum number of bytes sent per second to \a bytesPerSecond
+ */
+void MulticastSender::setRate(qint64 bytesPerSecond)
+{
+    m_rate = qMax<qint64>(bytesPerSecond, 64 * 1024);
+}
+
+/*!
+ * \brief Returns the maximum size of sent datagrams kept for retransmission
+ */
+qint64 MulticastSender::historyLimit() const
+{
+    return m_historyLimit;
+}
+
+/*!
+ * \brief Sets the maximum size of sent datagrams kept for retransmission to \a bytes
+ */
+void MulticastSender::setHistoryLimit(qint64 bytes)
+{
+    m_historyLimit = bytes;
+    trimHistory();
+}
+
+/*!
+ * \brief Queues \a payload for sending
+ *
+ * Returns false if the sender is not active or the payload is larger than receivers
+ * accept.
+ */
+bool MulticastSender::send(const QByteArray &payload)
+{
+    if (!isActive())
+        return false;
+
+    if (payload.size() > MulticastDatagram::MaxPayloadSize) {
+        qWarning() << "Payload too large to be sent by multicast:" << payload.size();
+        return false;
+    }
+
+    MulticastDatagram datagram;
+    datagram.type = MulticastDatagram::Data;
+    datagram.session = m_session;
+    datagram.transfer = m_nextTransfer++;
+    datagram.fragmentCount = qMax(1, (payload.size() + MulticastDatagram::MaxChunkSize - 1)
+                                  / MulticastDatagram::MaxChunkSize);
+
+    for (quint32 fragment = 0; fragment < datagram.fragmentCount; ++fragment) {
+        datagram.sequence = m_nextSequence++;
+        datagram.fragment = fragment;
+        datagram.chunk = payload.mid(fragment * MulticastDatagram::MaxChunkSize,
+                                     MulticastDatagram::MaxChunkSize);
+
+        const QByteArray encoded = datagram.encode(m_key);
+        m_history.insert(datagram.sequence, encoded);
+        m_historyOrder.enqueue(datagram.sequence);
+        m_historySize += encoded.size();
+        m_sendQueue.enqueue(datagram.sequence);
+    }
+
+    trimHistory();
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+        flush();
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Queues the datagrams identified by \a sequences for sending again
+ *
+ * Returns the sequence numbers which are not available anymore. Receivers missing
+ * these need to be updated some other way.
+ */
+QList<quint32> MulticastSender::resend(const QList<quint32> &sequences)
+{
+    QList<quint32> unavailable;
+
+    foreach (quint32 sequence, sequences) {
+        if (!m_history.contains(sequence)) {
+            if (sequence < m_nextSequence)
+                unavailable.append(sequence);
+            continue;
+        }
+        if (!m_retransmitQueue.contains(sequence))
+            m_retransmitQueue.enqueue(sequence);
+    }
+
+    DEBUG << "MulticastSender::resend" << sequences.count() << "requested,"
+          << unavailable.count() << "unavailable";
+
+    if (!m_retransmitQueue.isEmpty() && isActive() && !m_flushTimer->isActive()) {
+        m_flushTimer->start();
+        flush();
+    }
+
+    return unavailable;
+}
+
+void MulticastSender::flush()
+{
+    const qint64 now = m_clock.elapsed();
+    // Do not let idle time accumulate into a burst
+    m_budget = qMin(m_budget + (now - m_lastFlush) * m_rate / 1000,
+                    m_rate * FLUSH_INTERVAL * 4 / 1000);
+    m_lastFlush = now;
+
+    while (m_budget > 0 && (!m_retransmitQueue.isEmpty() || !m_sendQueue.isEmpty())) {
+        const quint32 sequence = !m_retransmitQueue.isEmpty()
+                ? m_retransmitQueue.dequeue() : m_sendQueue.dequeue();
+
+        const QByteArray datagram = m_history.value(sequence);
+        if (datagram.isEmpty())
+            continue; // dropped from history meanwhile
+
+        if (m_socket->writeDatagram(datagram, m_group, m_port) < 0) {
+            qWarning() << "Failed to send multicast datagram:" << m_socket->errorString();
+            // Try again later, e.g. on ENOBUFS
+            m_retransmitQueue.prepend(sequence);
+            break;
+        }
+
+        m_budget -= datagram.size();
+    }
+
+    if (m_retransmitQueue.isEmpty() && m_sendQueue.isEmpty()) {
+        m_flushTimer->stop();
+        sendHeartbeat();
+        emit idle();
+    }
+}
+
+void MulticastSender::sendHeartbeat()
+{
+    if (!isActive() || m_nextSequence == 1)
+        return;
+
+    MulticastDatagram datagram;
+    datagram.type = MulticastDatagram::Heartbeat;
+    datagram.session = m_session;
+    datagram.sequence = m_nextSequence - 1;
+
+    m_socket->writeDatagram(datagram.encode(m_key), m_group, m_port);
+}
+
+void MulticastSender::trimHistory()
+{
+    // Never drop datagrams not sent yet
+    const quint32 firstUnsent = !m_sendQueue.isEmpty() ? m_sendQueue.head() : m_nextSequence;
+
+    while (m_historySize > m_historyLimit && !m_historyOrder.isEmpty()
+           && m_historyOrder.head() < firstUnsent) {
+        const quint32 sequence = m_historyOrder.dequeue();
+        m_historySize -= m_history.take(sequence).size();
+    }
+}
+
+/*!
+ * \fn void MulticastSender::idle()
+ *
+ * This signal is emitted when all queued datagrams have been sent.
+ */
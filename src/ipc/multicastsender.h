@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+#include <QtNetwork>
+
+#include "qmllive_global.h"
+
+class QMLLIVESHARED_EXPORT MulticastSender : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MulticastSender(QObject *parent = 0);
+
+    bool start(const QHostAddress &group, quint16 port);
+    void stop();
+    bool isActive() const;
+    QString errorString() const;
+
+    QHostAddress group() const;
+    quint16 port() const;
+    quint32 session() const;
+    QByteArray key() const;
+    quint32 nextSequence() const;
+
+    qint64 rate() const;
+    void setRate(qint64 bytesPerSecond);
+    qint64 historyLimit() const;
+    void setHistoryLimit(qint64 bytes);
+
+public Q_SLOTS:
+    bool send(const QByteArray &payload);
+    QList<quint32> resend(const QList<quint32> &sequences);
+
+Q_SIGNALS:
+    void idle();
+
+private Q_SLOTS:
+    void flush();
+    void sendHeartbeat();
+
+private:
+    void trimHistory();
+
+private:
+    QUdpSocket *m_socket;
+    QHostAddress m_group;
+    quint16 m_port;
+    QString m_errorString;
+
+    quint32 m_session;
+    QByteArray m_key;
+    quint32 m_nextSequence;
+    quint32 m_nextTransfer;
+
+    // Encoded datagrams by sequence number, kept for retransmission
+    QHash<quint32, QByteArray> m_history;
+    QQueue<quint32> m_historyOrder;
+    qint64 m_historySize;
+    qint64 m_historyLimit;
+
+    // Sequence numbers waiting to be sent, retransmissions first
+    QQueue<quint32> m_retransmitQueue;
+    QQueue<quint32> m_sendQueue;
+
+    qint64 m_rate;
+    QElapsedTimer m_clock;
+    qint64 m_lastFlush;
+    qint64 m_budget;
+    QTimer *m_flushTimer;
+    QTimer *m_heartbeatTimer;
+};
@@ -259,7 +259,7 @@ LiveDocument LiveDocument::resolve(const QDir &workspace, const ResourceMap &res
     }
 
     if (filePath.startsWith(":/")) {
-        LiveDocument retv = resourceMap.toDocument(filePath);
+        LiveDocument retv = resourceMap.toDocument(QStringRef(&filePath));
         if (retv.isNull()) {
             retv.m_errorString = tr("No mapping exists for resource: '%1'").arg(filePath);
         }
@@ -290,7 +290,9 @@ LiveDocument LiveDocument::resolve(const QDir &workspace, const ResourceMap &res
     }
 
     if (fileUrl.scheme() == QLatin1String("qrc")) {
-        LiveDocument retv = resourceMap.toDocument(QLatin1String(":") + fileUrl.path());
+        // Looks up ":/path" right in "qrc:/path"
+        const QString url = fileUrl.toString(QUrl::RemoveAuthority | QUrl::RemoveQuery | QUrl::RemoveFragment);
+        LiveDocument retv = resourceMap.toDocument(url.midRef(3));
         if (retv.isNull()) {
             retv.m_errorString = tr("No mapping exists for resource: '%1'").arg(fileUrl.toString());
         }
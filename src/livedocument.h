@@ -75,4 +75,6 @@ private:
     mutable QString m_errorString;
 };
 
+Q_DECLARE_METATYPE(LiveDocument)
+
 QDebug QMLLIVESHARED_EXPORT operator<<(QDebug dbg, const LiveDocument &document);
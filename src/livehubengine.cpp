@@ -30,7 +30,8 @@
 ****************************************************************************/
 
 #include "livehubengine.h"
-#include "watcher.h"
+#include "workspacemanifest.h"
+#include "workspacetree.h"
 
 #ifdef QMLLIVE_DEBUG
 #define DEBUG qDebug()
@@ -38,6 +39,44 @@
 #define DEBUG if (0) qDebug()
 #endif
 
+namespace {
+const int DEFAULT_PAYLOAD_CACHE_LIMIT = 32 * 1024 * 1024;
+const int DEFAULT_CHANGE_STORM_THRESHOLD = 200;
+const int CHANGE_RATE_INTERVAL = 1000;
+const int CHANGE_STORM_QUIET_PERIOD = 500;
+const int MAXIMUM_PREFETCH_SIBLINGS = 8;
+const int MAXIMUM_PREFETCH_CANDIDATES = 16;
+}
+
+/*
+ * Keeps the manifest of a workspace up to date in a background thread. Documents
+ * whose size and modification time did not change are not read again.
+ */
+class ManifestScanner : public QObject
+{
+    Q_OBJECT
+public:
+    ManifestScanner() {}
+
+public Q_SLOTS:
+    void scan(const QString &workspace, int generation)
+    {
+        if (workspace != m_workspace) {
+            m_workspace = workspace;
+            m_manifest.clear();
+        }
+        m_manifest.scan(workspace);
+        emit finished(generation, m_manifest.hash());
+    }
+
+Q_SIGNALS:
+    void finished(int generation, const QByteArray &hash);
+
+private:
+    QString m_workspace;
+    WorkspaceManifest m_manifest;
+};
+
 /*!
  * \class LiveHubEngine
  * \brief The LiveHubEngine class watches over a workspace and notifies a node on changes
@@ -45,6 +84,26 @@
  *
  * The live hub watches over a workspace and notifies a live node about changed files. A
  * node can run on the same device or even on a remote device using a RemotePublisher.
+ *
+ * When many remote publishers are connected to the same hub, each changed document is
+ * read and serialized only once. See documentPayload().
+ *
+ * The workspace is scanned and watched by a WorkspaceTree, which can be shared with
+ * views of the workspace, see workspaceTree().
+ *
+ * When more documents change at once than set with setChangeStormThreshold(), e.g. on
+ * a checkout or a build step writing into the workspace, the hub stops publishing
+ * changed documents one by one. Once the workspace did not change for a while, only
+ * the documents whose content changed in the meantime are published in a single bulk
+ * update, followed by a single activateDocument() signal.
+ *
+ * On workspace changes, activateDocument() is only emitted again if a document used by
+ * the active document changed, as far as a DependencyGraph of the workspace can tell,
+ * or a document no other document refers to, which may still be used through a URL
+ * constructed at run time. A node with AllowUpdates reloads only if it used the changed
+ * documents, see LiveNodeEngine::updateDocument(). When publishing, the documents used
+ * by the active document are published first, so that a node can show it before the
+ * rest of the workspace arrived.
  */
 
 /*!
@@ -64,11 +123,35 @@
  */
 LiveHubEngine::LiveHubEngine(QObject *parent)
     : QObject(parent)
-    , m_watcher(new Watcher(this))
+    , m_tree(new WorkspaceTree(this))
     , m_filePublishingActive(false)
+    , m_payloadCache(DEFAULT_PAYLOAD_CACHE_LIMIT)
+    , m_changeStormThreshold(DEFAULT_CHANGE_STORM_THRESHOLD)
+    , m_changeStormTimer(new QTimer(this))
+    , m_manifestScanner(new ManifestScanner)
 {
-    connect(m_watcher, &Watcher::directoriesChanged, this, &LiveHubEngine::directoriesChanged);
-    connect(m_watcher, &Watcher::errorChanged, this, &LiveHubEngine::watcherErrorChanged);
+    connect(m_tree, &WorkspaceTree::filesChanged, this, &LiveHubEngine::filesChanged);
+    connect(m_tree, &WorkspaceTree::directoriesChanged, this, &LiveHubEngine::directoriesChanged);
+    connect(m_tree, &WorkspaceTree::errorChanged, this, &LiveHubEngine::treeErrorChanged);
+
+    m_changeStormTimer->setInterval(CHANGE_STORM_QUIET_PERIOD);
+    m_changeStormTimer->setSingleShot(true);
+    connect(m_changeStormTimer, &QTimer::timeout, this, &LiveHubEngine::endChangeStorm);
+
+    m_manifestScanner->moveToThread(&m_manifestThread);
+    connect(&m_manifestThread, &QThread::finished, m_manifestScanner, &QObject::deleteLater);
+    connect(m_manifestScanner, &ManifestScanner::finished, this, &LiveHubEngine::onManifestScanned);
+    m_manifestThread.setObjectName(QStringLiteral("LiveHubEngine manifest"));
+    m_manifestThread.start();
+}
+
+/*!
+ * Destructor
+ */
+LiveHubEngine::~LiveHubEngine()
+{
+    m_manifestThread.quit();
+    m_manifestThread.wait();
 }
 
 /*!
@@ -76,7 +159,23 @@ LiveHubEngine::LiveHubEngine(QObject *parent)
  */
 void LiveHubEngine::setWorkspace(const QString &path)
 {
-    m_watcher->setDirectory(path);
+    m_tree->setRootPath(path);
+
+    {
+        QMutexLocker locker(&m_payloadMutex);
+        m_payloadWorkspace = m_tree->rootPath();
+        m_payloadCache.clear();
+        m_publishedHashes.clear();
+    }
+    ++m_manifestGeneration;
+    m_manifestHash.clear();
+    m_manifestHashValid = false;
+    resetChangeStorm();
+    m_lastChanges.clear();
+    m_dependencies.clear();
+    m_dependenciesDirty = true;
+    m_dependencyChanges.clear();
+    m_pendingChanges.clear();
 
     emit workspaceChanged(path);
 }
@@ -86,17 +185,32 @@ void LiveHubEngine::setWorkspace(const QString &path)
  */
 QString LiveHubEngine::workspace() const
 {
-    return m_watcher->directory();
+    return m_tree->rootPath();
+}
+
+/*!
+ * Returns the tree of the workspace contents, kept up to date with the changes
+ * watched
+ */
+WorkspaceTree *LiveHubEngine::workspaceTree() const
+{
+    return m_tree;
 }
 
 /*!
  * Sets the active document path to \a path.
- * Emits activateDocument() with this path.
+ * Emits activateDocument() with this path, followed by prefetchDocuments() with the
+ * prefetchCandidates() for it.
  */
 void LiveHubEngine::setActivePath(const LiveDocument &path)
 {
     m_activePath = path;
+    m_pendingChanges.clear();
     emit activateDocument(m_activePath);
+
+    const QStringList candidates = prefetchCandidates(m_activePath);
+    if (!candidates.isEmpty())
+        emit prefetchDocuments(candidates);
 }
 
 /*!
@@ -128,7 +242,7 @@ LiveHubEngine::Error LiveHubEngine::error()
  */
 int LiveHubEngine::maximumWatches()
 {
-    return Watcher::maximumWatches();
+    return WorkspaceTree::maximumWatches();
 }
 
 /*!
@@ -136,38 +250,431 @@ int LiveHubEngine::maximumWatches()
  */
 void LiveHubEngine::setMaximumWatches(int maximumWatches)
 {
-    Watcher::setMaximumWatches(maximumWatches);
+    WorkspaceTree::setMaximumWatches(maximumWatches);
+}
+
+/*!
+ * Returns the serialized arguments of the "sendDocument(QString,QByteArray)" IPC call
+ * for \a document, i.e. its relative path followed by its content.
+ *
+ * The payload is read from the workspace on first use and shared by all callers until
+ * the document changes, so that connected publishers do not need to read and
+ * serialize the same document each. A cached payload is only used while the size and
+ * modification time of the file match, as changes are notified with a delay. Returns
+ * an empty byte array if the document cannot be read.
+ *
+ * This function is thread-safe.
+ *
+ * \sa setPayloadCacheLimit()
+ */
+QByteArray LiveHubEngine::documentPayload(const LiveDocument &document)
+{
+    const QString key = document.relativeFilePath();
+
+    QString workspace;
+    {
+        QMutexLocker locker(&m_payloadMutex);
+        workspace = m_payloadWorkspace;
+    }
+
+    const QFileInfo info(document.absoluteFilePathIn(QDir(workspace)));
+    const qint64 fileSize = info.size();
+    const QDateTime modified = info.lastModified();
+    {
+        QMutexLocker locker(&m_payloadMutex);
+        if (Payload *payload = m_payloadCache.object(key)) {
+            if (payload->fileSize == fileSize && payload->modified == modified)
+                return payload->data;
+        }
+    }
+
+    // Read without holding the lock, a concurrent read of the same document is harmless
+    QFile file(info.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "ERROR: can't open file: " << document;
+        return QByteArray();
+    }
+
+    const QByteArray content = file.readAll();
+    const QByteArray hash = WorkspaceManifest::contentHash(content);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << key;
+    out << content;
+
+    QMutexLocker locker(&m_payloadMutex);
+    if (workspace == m_payloadWorkspace) {
+        m_publishedHashes.insert(key, hash);
+        if (payload.size() <= m_payloadCache.maxCost())
+            m_payloadCache.insert(key, new Payload{payload, fileSize, modified}, payload.size());
+    }
+
+    return payload;
+}
+
+/*!
+ * Returns the maximum total size in bytes of the payloads kept by documentPayload()
+ */
+int LiveHubEngine::payloadCacheLimit() const
+{
+    QMutexLocker locker(&m_payloadMutex);
+    return m_payloadCache.maxCost();
+}
+
+/*!
+ * Sets the maximum total size in bytes of the payloads kept by documentPayload() to
+ * \a bytes. Documents larger than this are read again for each publisher.
+ */
+void LiveHubEngine::setPayloadCacheLimit(int bytes)
+{
+    QMutexLocker locker(&m_payloadMutex);
+    m_payloadCache.setMaxCost(bytes);
+}
+
+/*!
+ * Requests the hash of the workspace manifest, see WorkspaceManifest::hash(). The
+ * hash is passed to the manifestHashReady() signal, right away if the workspace did
+ * not change since it was computed last.
+ *
+ * A node reporting the same hash already has all workspace documents, so that
+ * publishing the workspace to it can be skipped. The manifest is updated in a
+ * background thread, reading only the documents changed.
+ */
+void LiveHubEngine::requestManifestHash()
+{
+    if (m_manifestHashValid && !m_manifestScanning) {
+        emit manifestHashReady(m_manifestHash);
+        return;
+    }
+
+    m_manifestHashRequested = true;
+    if (m_manifestScanning)
+        return;
+
+    m_manifestScanning = true;
+    m_manifestHashValid = true; // unless the workspace changes during the scan
+    QMetaObject::invokeMethod(m_manifestScanner, "scan", Qt::QueuedConnection,
+                              Q_ARG(QString, workspace()), Q_ARG(int, m_manifestGeneration));
+}
+
+void LiveHubEngine::onManifestScanned(int generation, const QByteArray &hash)
+{
+    m_manifestScanning = false;
+
+    if (generation != m_manifestGeneration) {
+        // Scanned a previous workspace
+        m_manifestHashValid = false;
+        if (m_manifestHashRequested)
+            requestManifestHash();
+        return;
+    }
+
+    // Documents changed during the scan are published as changes anyway
+    m_manifestHash = hash;
+    m_manifestHashRequested = false;
+    emit manifestHashReady(hash);
 }
 
 /*!
- * Handles watcher changes signals.
+ * Returns the QML documents likely to be activated after \a document, most likely
+ * first: the documents next to it in its directory, as when stepping through the
+ * workspace, and the documents it uses.
+ */
+QStringList LiveHubEngine::prefetchCandidates(const LiveDocument &document)
+{
+    QStringList candidates;
+
+    const QDir workspace(m_tree->rootPath());
+    if (document.isNull() || !document.isFileIn(workspace))
+        return candidates;
+
+    auto isQml = [](const QString &path) {
+        return path.endsWith(QLatin1String(".qml"), Qt::CaseInsensitive);
+    };
+
+    const QString active = document.relativeFilePath();
+
+    const QString directory = QFileInfo(document.absoluteFilePathIn(workspace)).absolutePath();
+
+    QStringList siblings;
+    foreach (const QString &path, directoryDocuments(directory)) {
+        if (isQml(path))
+            siblings.append(path);
+    }
+
+    // Nearest first, alternating between next and previous
+    const int index = siblings.indexOf(active);
+    for (int distance = 1; index >= 0 && distance < siblings.count()
+            && candidates.count() < MAXIMUM_PREFETCH_SIBLINGS; ++distance) {
+        if (index + distance < siblings.count())
+            candidates.append(siblings.at(index + distance));
+        if (index - distance >= 0 && candidates.count() < MAXIMUM_PREFETCH_SIBLINGS)
+            candidates.append(siblings.at(index - distance));
+    }
+
+    updateDependencies();
+
+    foreach (const QString &path, m_dependencies.dependencies(active)) {
+        if (candidates.count() >= MAXIMUM_PREFETCH_CANDIDATES)
+            break;
+        const WorkspaceTree::Node *node = m_tree->find(workspace.absoluteFilePath(path));
+        if (isQml(path) && node && !node->isDir && !candidates.contains(path))
+            candidates.append(path);
+    }
+
+    return candidates;
+}
+
+/*!
+ * Returns the number of documents changing within a second above which the hub
+ * switches to publishing changes in bulk.
+ *
+ * \sa setChangeStormThreshold()
+ */
+int LiveHubEngine::changeStormThreshold() const
+{
+    return m_changeStormThreshold;
+}
+
+/*!
+ * Sets the number of documents changing within a second above which the hub switches
+ * to publishing changes in bulk to \a documentsPerSecond. A value of 0 disables bulk
+ * publishing of changes.
+ */
+void LiveHubEngine::setChangeStormThreshold(int documentsPerSecond)
+{
+    m_changeStormThreshold = documentsPerSecond;
+}
+
+/*!
+ * Returns true while changes are collected to be published in bulk.
+ */
+bool LiveHubEngine::isChangeStormActive() const
+{
+    return m_changeStorm;
+}
+
+/*!
+ * Drops the cached payload of \a document so that it is read again on next use.
+ */
+void LiveHubEngine::invalidatePayload(const LiveDocument &document)
+{
+    QMutexLocker locker(&m_payloadMutex);
+    m_payloadCache.remove(document.relativeFilePath());
+}
+
+/*!
+ * Records the \a files changed, to be checked against the active document and counted
+ * towards the change rate, and drops their cached payloads.
+ */
+void LiveHubEngine::filesChanged(const QStringList &files)
+{
+    const QDir dir(m_tree->rootPath());
+    foreach (const QString &file, files) {
+        const QString document = dir.relativeFilePath(file);
+        m_lastChanges.append(document);
+        invalidatePayload(LiveDocument(document));
+        m_pendingChanges.insert(document);
+        if (!m_dependenciesDirty)
+            m_dependencyChanges.insert(document);
+    }
+}
+
+/*!
+ * Handles workspace tree changes signals.
  */
 void LiveHubEngine::directoriesChanged(const QStringList &changes)
 {
     DEBUG << "LiveHubEngine::workspaceChanged: " << changes;
+    m_manifestHashValid = false;
+
+    // An edit keeping the size within the resolution of modification times is not
+    // reported by filesChanged(), it may have been an edit of the active document
+    bool unreportedActiveChange = false;
+    if (m_lastChanges.isEmpty() && !m_activePath.isNull()) {
+        const QString active = m_activePath.absoluteFilePathIn(QDir(m_tree->rootPath()));
+        foreach (const QString &change, changes) {
+            if (active.startsWith(change + QLatin1Char('/')))
+                unreportedActiveChange = true;
+        }
+    }
+
+    const bool storm = detectChangeStorm();
+    m_lastChanges.clear();
+    if (storm) {
+        m_changeStormTimer->start();
+        return;
+    }
+
     if (m_filePublishingActive) {
-        foreach (const QString& change, changes) {
-            publishDirectory(change, true);
+        QStringList documents;
+        foreach (const QString& change, changes)
+            documents += directoryDocuments(change);
+        publishDocuments(prioritized(documents), true);
+    }
+
+    if (activeDocumentAffected() || unreportedActiveChange)
+        emit activateDocument(m_activePath);
+}
+
+/*!
+ * Returns true if the documents changed last should not be published right away,
+ * because too many documents are changing at once. During a change storm they are
+ * collected to be published once it is over.
+ */
+bool LiveHubEngine::detectChangeStorm()
+{
+    if (m_changeStorm) {
+        m_stormChanges += m_lastChanges.toSet();
+        return true;
+    }
+
+    if (m_changeStormThreshold <= 0)
+        return false;
+
+    if (!m_changeRateTimer.isValid() || m_changeRateTimer.elapsed() > CHANGE_RATE_INTERVAL) {
+        m_changeRateTimer.start();
+        m_changeRateCount = 0;
+    }
+
+    m_changeRateCount += m_lastChanges.count();
+
+    if (m_changeRateCount <= m_changeStormThreshold)
+        return false;
+
+    DEBUG << "LiveHubEngine: change storm detected, publishing changes in bulk";
+
+    m_changeStorm = true;
+    m_stormChanges = m_lastChanges.toSet();
+    return true;
+}
+
+/*!
+ * Publishes the documents changed during a change storm in a single bulk update and
+ * activates the active document again. Documents rewritten with the content published
+ * last, e.g. by a checkout or a build step, are not published again.
+ */
+void LiveHubEngine::endChangeStorm()
+{
+    DEBUG << "LiveHubEngine: change storm over";
+
+    const QSet<QString> changes = m_stormChanges;
+    resetChangeStorm();
+
+    if (m_filePublishingActive) {
+        // Removed documents are not published, nor the ones nodes have already
+        const QDir workspace(m_tree->rootPath());
+        QStringList documents;
+        foreach (const QString &path, changes) {
+            const WorkspaceTree::Node *node = m_tree->find(workspace.absoluteFilePath(path));
+            if (!node || node->isDir)
+                continue;
+            if (isContentPublished(LiveDocument(path)))
+                m_pendingChanges.remove(path);
+            else
+                documents.append(path);
         }
+        documents.sort();
+
+        emit beginPublishWorkspace();
+        publishDocuments(prioritized(documents), true);
+        emit endPublishWorkspace();
     }
 
-    emit activateDocument(m_activePath);
+    if (activeDocumentAffected())
+        emit activateDocument(m_activePath);
 }
 
 /*!
- * Handles watcher error signals
+ * Returns true if \a document holds the content read by documentPayload() last.
  */
-void LiveHubEngine::watcherErrorChanged()
+bool LiveHubEngine::isContentPublished(const LiveDocument &document)
+{
+    QByteArray published;
+    QString workspace;
+    {
+        QMutexLocker locker(&m_payloadMutex);
+        published = m_publishedHashes.value(document.relativeFilePath());
+        workspace = m_payloadWorkspace;
+    }
+    if (published.isEmpty())
+        return false;
+
+    QFile file(document.absoluteFilePathIn(QDir(workspace)));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    return WorkspaceManifest::contentHash(file.readAll()) == published;
+}
+
+/*!
+ * Returns true if any of the documents changed since last call is used by the active
+ * document, i.e. it needs to be activated again.
+ */
+bool LiveHubEngine::activeDocumentAffected()
+{
+    const QSet<QString> changes = m_pendingChanges;
+    m_pendingChanges.clear();
+
+    if (m_activePath.isNull() || changes.isEmpty())
+        return false;
+
+    const QString active = m_activePath.relativeFilePath();
+
+    // Directory previews show the files directly in the directory
+    const QDir workspace(m_tree->rootPath());
+    if (m_activePath.existsIn(workspace) && !m_activePath.isFileIn(workspace)) {
+        foreach (const QString &change, changes) {
+            if (QFileInfo(change).path() == active)
+                return true;
+        }
+        return false;
+    }
+
+    updateDependencies();
+
+    foreach (const QString &document, m_dependencies.closure(active)) {
+        if (changes.contains(document))
+            return true;
+    }
+
+    // The static scan cannot tell whether a document nothing refers to is loaded
+    // through a URL constructed at run time
+    const QSet<QString> referenced = m_dependencies.referencedDocuments();
+    foreach (const QString &change, changes) {
+        if (!referenced.contains(change))
+            return true;
+    }
+
+    return false;
+}
+
+/*!
+ * Leaves the change storm mode without publishing anything.
+ */
+void LiveHubEngine::resetChangeStorm()
+{
+    m_changeStormTimer->stop();
+    m_changeRateTimer.invalidate();
+    m_changeRateCount = 0;
+    m_changeStorm = false;
+    m_stormChanges.clear();
+}
+
+/*!
+ * Handles workspace tree error signals
+ */
+void LiveHubEngine::treeErrorChanged()
 {
     Error newError = NoError;
-    switch (m_watcher->error()) {
-        case Watcher::NoError:
+    switch (m_tree->error()) {
+        case WorkspaceTree::NoError:
             newError = NoError;
             break;
-        case Watcher::MaximumReached:
+        case WorkspaceTree::MaximumReached:
             newError = WatcherMaximumReached;
             break;
-        case Watcher::SystemError:
+        case WorkspaceTree::SystemError:
             newError = WatcherSystemError;
             break;
     }
@@ -185,31 +692,94 @@ void LiveHubEngine::watcherErrorChanged()
 void LiveHubEngine::publishWorkspace()
 {
     if (!m_filePublishingActive) { return; }
+
+    QStringList documents;
+    foreach (const QString &directory, m_tree->directories())
+        documents += directoryDocuments(directory);
+
     emit beginPublishWorkspace();
-    QDirIterator iter(m_watcher->directory(), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
-    publishDirectory(m_watcher->directory(), false);
-    while (iter.hasNext()) {
-        publishDirectory(iter.next(), false);
-    }
+    publishDocuments(prioritized(documents), false);
     emit endPublishWorkspace();
 }
 
 /*!
- * Publish the directory \a dirPath to a connected node.
+ * Returns the workspace relative paths of the files in the directory \a dirPath.
  */
-void LiveHubEngine::publishDirectory(const QString& dirPath, bool fileChange)
+QStringList LiveHubEngine::directoryDocuments(const QString &dirPath) const
+{
+    const QDir dir(m_tree->rootPath());
+
+    QStringList documents;
+    foreach (const QString &file, m_tree->files(dirPath))
+        documents.append(dir.relativeFilePath(file));
+    return documents;
+}
+
+/*!
+ * Publish the \a documents to a connected node, as changed if \a fileChange is true.
+ */
+void LiveHubEngine::publishDocuments(const QStringList &documents, bool fileChange)
 {
     if (!m_filePublishingActive) { return; }
-    QDirIterator iter(dirPath, QDir::Files);
-    while (iter.hasNext()) {
-        LiveDocument document = LiveDocument::resolve(m_watcher->directory(), iter.next());
-        if (fileChange)
+    foreach (const QString &path, documents) {
+        LiveDocument document(path);
+        if (fileChange) {
             emit fileChanged(document);
-        else
+        } else {
             emit publishFile(document);
+        }
     }
 }
 
+/*!
+ * Returns \a documents reordered so that the documents used by the active document
+ * come first, each after the documents it uses. The order of the other documents is
+ * kept.
+ */
+QStringList LiveHubEngine::prioritized(const QStringList &documents)
+{
+    if (m_activePath.isNull() || documents.count() < 2)
+        return documents;
+
+    updateDependencies();
+
+    const QSet<QString> available = documents.toSet();
+
+    QStringList result;
+    QSet<QString> listed;
+    foreach (const QString &document, m_dependencies.closureOrder(m_activePath.relativeFilePath())) {
+        if (available.contains(document)) {
+            result.append(document);
+            listed.insert(document);
+        }
+    }
+
+    if (listed.isEmpty())
+        return documents;
+
+    foreach (const QString &document, documents) {
+        if (!listed.contains(document))
+            result.append(document);
+    }
+
+    return result;
+}
+
+/*!
+ * Brings the dependency graph up to date with the workspace, scanning only the
+ * documents changed since last update.
+ */
+void LiveHubEngine::updateDependencies()
+{
+    if (m_dependenciesDirty) {
+        m_dependencies.update(*m_tree);
+        m_dependenciesDirty = false;
+    } else if (!m_dependencyChanges.isEmpty()) {
+        m_dependencies.update(*m_tree, m_dependencyChanges.toList());
+    }
+    m_dependencyChanges.clear();
+}
+
 /*!
  * Sets the file publishing to \a on
  */
@@ -251,6 +821,17 @@ void LiveHubEngine::setFilePublishingActive(bool on)
  * The signal is emitted when the document identified by \a document has been activated
  */
 
+/*!
+ * \fn void LiveHubEngine::prefetchDocuments(const QStringList &documents)
+ * The signal is emitted after activating a document, with the \a documents likely to be
+ * activated next
+ */
+
+/*!
+ * \fn void LiveHubEngine::manifestHashReady(const QByteArray &hash)
+ * Answers requestManifestHash() with the \a hash of the workspace manifest.
+ */
+
 /*!
  * \fn void LiveHubEngine::workspaceChanged(const QString& workspace)
  * The signal is emitted when the workspace identified by \a workspace has changed
@@ -260,3 +841,5 @@ void LiveHubEngine::setFilePublishingActive(bool on)
  * \fn void LiveHubEngine::errorChanged()
  * The signal is emitted when the error state desctibed by error() changed
  */
+
+#include "livehubengine.moc"
@@ -33,11 +33,13 @@
 
 #include <QtCore>
 
+#include "dependencygraph.h"
 #include "livedocument.h"
 #include "qmllive_global.h"
 
-class Watcher;
+class WorkspaceTree;
 class ContentPluginFactory;
+class ManifestScanner;
 
 class QMLLIVESHARED_EXPORT LiveHubEngine : public QObject
 {
@@ -50,8 +52,10 @@ public:
     };
 
     explicit LiveHubEngine(QObject *parent = 0);
+    ~LiveHubEngine();
     void setWorkspace(const QString& path);
     QString workspace() const;
+    WorkspaceTree *workspaceTree() const;
 
     LiveDocument activePath() const;
 
@@ -60,6 +64,18 @@ public:
 
     static int maximumWatches();
     static void setMaximumWatches(int maximumWatches);
+
+    QByteArray documentPayload(const LiveDocument &document);
+    int payloadCacheLimit() const;
+    void setPayloadCacheLimit(int bytes);
+
+    void requestManifestHash();
+
+    QStringList prefetchCandidates(const LiveDocument &document);
+
+    int changeStormThreshold() const;
+    void setChangeStormThreshold(int documentsPerSecond);
+    bool isChangeStormActive() const;
 public Q_SLOTS:
     void setActivePath(const LiveDocument& path);
     void setFilePublishingActive(bool on);
@@ -70,17 +86,66 @@ Q_SIGNALS:
     void publishFile(const LiveDocument& document);
     void fileChanged(const LiveDocument& document);
     void activateDocument(const LiveDocument& document);
+    void prefetchDocuments(const QStringList &documents);
+    void manifestHashReady(const QByteArray &hash);
     void workspaceChanged(const QString& workspace);
     void errorChanged();
 private Q_SLOTS:
+    void filesChanged(const QStringList& files);
     void directoriesChanged(const QStringList& changes);
-    void watcherErrorChanged();
+    void treeErrorChanged();
+    void endChangeStorm();
+    void onManifestScanned(int generation, const QByteArray &hash);
 private:
-    void publishDirectory(const QString& dirPath, bool fileChange);
+    QStringList directoryDocuments(const QString &dirPath) const;
+    void publishDocuments(const QStringList &documents, bool fileChange);
+    QStringList prioritized(const QStringList &documents);
+    void updateDependencies();
+    void invalidatePayload(const LiveDocument &document);
+    bool isContentPublished(const LiveDocument &document);
+    bool detectChangeStorm();
+    bool activeDocumentAffected();
+    void resetChangeStorm();
 private:
-    Watcher *m_watcher;
+    WorkspaceTree *m_tree;
     bool m_filePublishingActive;
     LiveDocument m_activePath;
     Error m_error = NoError;
+
+    struct Payload
+    {
+        QByteArray data;
+        qint64 fileSize;
+        QDateTime modified;
+    };
+    mutable QMutex m_payloadMutex;
+    QString m_payloadWorkspace;
+    QCache<QString, Payload> m_payloadCache;
+    // content hashes of the documents read by documentPayload()
+    QHash<QString, QByteArray> m_publishedHashes;
+
+    int m_changeStormThreshold;
+    QElapsedTimer m_changeRateTimer;
+    int m_changeRateCount = 0;
+    bool m_changeStorm = false;
+    QTimer *m_changeStormTimer;
+    // documents reported by the last filesChanged()
+    QStringList m_lastChanges;
+    // documents changed since the change storm started
+    QSet<QString> m_stormChanges;
+
+    QThread m_manifestThread;
+    ManifestScanner *m_manifestScanner;
+    int m_manifestGeneration = 0;
+    bool m_manifestScanning = false;
+    bool m_manifestHashRequested = false;
+    bool m_manifestHashValid = false;
+    QByteArray m_manifestHash;
+
+    DependencyGraph m_dependencies;
+    bool m_dependenciesDirty = true;
+    QSet<QString> m_dependencyChanges;
+    // documents changed since the active document was last activated
+    QSet<QString> m_pendingChanges;
 };
 
@@ -33,12 +33,15 @@
 #include "liveruntime.h"
 #include "qmlhelper.h"
 #include "resourcemap.h"
+#include "contentadapterregistry.h"
 #include "contentpluginfactory.h"
 #include "imageadapter.h"
 #include "fontadapter.h"
 
 #include "QtQml/qqml.h"
 #include "QtQuick/private/qquickpixmapcache_p.h"
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
 
 // TODO: create proxy configuration settings, controlled by command line and ui
 
@@ -51,6 +54,25 @@
 namespace {
 const char *const OVERLAY_PATH_PREFIX = "qml-live-overlay--";
 const char OVERLAY_PATH_SEPARATOR = '-';
+const char *const OVERLAY_URL_SCHEME = "qmllive-overlay";
+const qint64 DEFAULT_OVERLAY_MEMORY_LIMIT = 64 * 1024 * 1024;
+const int PREFETCH_IDLE_DELAY = 200;
+const int PREFETCH_TIME_BUDGET = 10;
+const int MAXIMUM_PREFETCHED = 16;
+const int MAXIMUM_OVERLAY_SLOTS = 4;
+const qint64 OVERLAY_DISK_LIMIT = 256 * 1024 * 1024;
+const int STANDBY_WARM_DELAY = 500;
+// Coarsest resolution of file modification times expected, e.g. FAT
+const int MODIFICATION_TIME_RESOLUTION = 2000;
+
+// Avoids touching files with unchanged content, so their compiled form stays valid
+bool hasContent(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    if (file.size() != content.size() || !file.open(QIODevice::ReadOnly))
+        return false;
+    return file.readAll() == content;
+}
 }
 
 /*!
@@ -69,6 +91,10 @@ const char OVERLAY_PATH_SEPARATOR = '-';
  * One need to set the Plugin path to the right destination and the LiveNodeEngine will load all the plugins
  * it finds there.
  *
+ * With AllowUpdates, documents likely to be activated next can be compiled ahead of
+ * time, see prefetchDocuments(). Switching to such a document then only costs
+ * creating its objects.
+ *
  * \sa {Custom Runtime}, {ContentPlugin Example}
  */
 
@@ -95,56 +121,330 @@ const char OVERLAY_PATH_SEPARATOR = '-';
  *   \value AllowCreateMissing
  *          Without this option enabled, updates are only accepted for existing
  *          workspace documents. Requires \l AllowUpdates.
+ *   \value UpdatesInMemory
+ *          Keeps the overlay in memory instead of a temporary directory, so
+ *          receiving updates does not write to the storage. Documents are
+ *          served to the QML engine through a custom URL scheme handled by a
+ *          QQmlNetworkAccessManagerFactory installed by this class. Once the
+ *          limit set with setOverlayMemoryLimit() is reached, further
+ *          documents are stored on disk. Implies \l UpdatesAsOverlay.
  *
  * \sa {QmlLive Runtime}
  */
 
-// Overlay uses temporary directory to allow parallel execution
+// Overlay uses temporary directory to allow parallel execution. With a non-zero
+// memory limit documents are kept in memory and only spill to the temporary
+// directory once the limit would be exceeded.
 class Overlay : public QObject
 {
     Q_OBJECT
 
 public:
-    Overlay(const QString &basePath, QObject *parent)
+    Overlay(const QString &basePath, qint64 memoryLimit, QObject *parent)
         : QObject(parent)
         , m_basePath(basePath)
-        , m_overlay(overlayTemplatePath())
+        , m_memoryLimit(memoryLimit)
+        , m_memoryUsage(0)
     {
-        if (!m_overlay.isValid())
-#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
-            qFatal("Failed to create overlay directory: %s", qPrintable(m_overlay.errorString()));
-#else
+        // Without in-memory storage the directory is needed right away - fail early
+        if (m_memoryLimit <= 0 && !ensureDirectory())
             qFatal("Failed to create overlay directory");
-#endif
-
     }
 
     ~Overlay()
     {
     }
 
-    QString reserve(const LiveDocument &document, bool existing)
+    void setMemoryLimit(qint64 memoryLimit)
+    {
+        QWriteLocker locker(&m_lock);
+        m_memoryLimit = memoryLimit;
+    }
+
+    // Sets *changed to false if the document was stored with the same content already
+    bool store(const LiveDocument &document, bool existing, const QByteArray &content, bool *changed)
     {
         QWriteLocker locker(&m_lock);
 
-        QString overlayingPath = document.absoluteFilePathIn(m_overlay.path());
-        m_mappings.insert(document.absoluteFilePathIn(m_basePath), qMakePair(overlayingPath, existing));
-        return overlayingPath;
+        *changed = true;
+        m_generation.ref();
+
+        const QString key = document.absoluteFilePathIn(m_basePath);
+        const bool mapped = m_mappings.contains(key);
+        Entry &entry = m_mappings[key];
+        entry.existing = existing;
+
+        const qint64 previousSize = entry.content.size();
+        if (m_memoryLimit > 0 && m_memoryUsage - previousSize + content.size() <= m_memoryLimit) {
+            if (mapped && entry.overlayingPath.isEmpty() && entry.content == content)
+                *changed = false;
+            m_memoryUsage += content.size() - previousSize;
+            entry.content = content;
+            entry.overlayingPath.clear();
+            return true;
+        }
+
+        m_memoryUsage -= previousSize;
+        entry.content.clear();
+
+        if (!ensureDirectory()) {
+            m_mappings.remove(document.absoluteFilePathIn(m_basePath));
+            return false;
+        }
+
+        if (m_memoryLimit > 0)
+            DEBUG << "Overlay memory limit reached, spilling to disk:" << document;
+
+        const QString overlayingPath = document.absoluteFilePathIn(m_directoryPath);
+        if (hasContent(overlayingPath, content)) {
+            if (mapped && entry.overlayingPath == overlayingPath)
+                *changed = false;
+            entry.overlayingPath = overlayingPath;
+            return true;
+        }
+
+        entry.overlayingPath = overlayingPath;
+        if (unstash(document, content))
+            return true;
+
+        QDir().mkpath(QFileInfo(entry.overlayingPath).absolutePath());
+        QFile file(entry.overlayingPath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Unable to save file: " << file.errorString();
+            m_mappings.remove(document.absoluteFilePathIn(m_basePath));
+            return false;
+        }
+        file.write(content);
+        return true;
     }
 
-    QString map(const QString &file, bool existingOnly) const
+    bool contains(const LiveDocument &document) const
+    {
+        QReadLocker locker(&m_lock);
+        return m_mappings.contains(document.absoluteFilePathIn(m_basePath));
+    }
+
+    // Changes whenever the result of map() may change
+    int generation() const
+    {
+        return m_generation.load();
+    }
+
+    QUrl map(const QString &file, bool existingOnly) const
     {
         QReadLocker locker(&m_lock);
 
         auto it = m_mappings.find(file);
         if (it == m_mappings.end())
-            return file;
-        if (existingOnly && !it->second)
-            return file;
-        return it->first;
+            return QUrl::fromLocalFile(file);
+        if (existingOnly && !it->existing)
+            return QUrl::fromLocalFile(file);
+        if (!it->overlayingPath.isEmpty())
+            return QUrl::fromLocalFile(it->overlayingPath);
+
+        QUrl url = QUrl::fromLocalFile(file);
+        url.setScheme(QLatin1String(OVERLAY_URL_SCHEME));
+        return url;
+    }
+
+    // Serves URLs produced by map() for in-memory documents. Anything not
+    // stored in the overlay is read from the base path, so that relative
+    // references from in-memory documents keep working.
+    bool read(const QUrl &url, QByteArray *content) const
+    {
+        QUrl fileUrl(url);
+        fileUrl.setScheme(QLatin1String("file"));
+        const QString file = fileUrl.toLocalFile();
+
+        QString path = file;
+        {
+            QReadLocker locker(&m_lock);
+            auto it = m_mappings.find(file);
+            if (it != m_mappings.end()) {
+                if (it->overlayingPath.isEmpty()) {
+                    *content = it->content;
+                    return true;
+                }
+                path = it->overlayingPath;
+            }
+        }
+
+        QFile f(path);
+        if (f.open(QIODevice::ReadOnly)) {
+            *content = f.readAll();
+            return true;
+        }
+
+        if (QFileInfo(file).fileName() == QLatin1String("qmldir")) {
+            *content = implicitQmldir(QFileInfo(file).absolutePath());
+            return true;
+        }
+
+        return false;
     }
 
 private:
+    struct Entry
+    {
+        Entry() : existing(false) {}
+        // overlaying path, empty while the content is held in memory
+        QString overlayingPath;
+        QByteArray content;
+        // file exists at base path
+        bool existing;
+    };
+
+    bool ensureDirectory()
+    {
+        if (!m_directoryPath.isEmpty())
+            return true;
+
+        // Documents stored under the same path with unchanged modification time
+        // let the QML engine reuse their compiled form from its disk cache, across
+        // reloads and runs. Each workspace has its own slots, concurrent runtimes
+        // each take their own slot.
+        for (int slot = 0; slot < MAXIMUM_OVERLAY_SLOTS; ++slot) {
+            const QString path = overlaySlotPath(slot);
+            if (!QDir().mkpath(path))
+                break;
+
+            QScopedPointer<QLockFile> lock(new QLockFile(path + QLatin1String(".lock")));
+            if (!lock->tryLock(0))
+                continue;
+
+            m_slotLock.swap(lock);
+            m_directoryPath = path;
+            m_stashPath = path + QLatin1String(".stash");
+            stash(path, m_stashPath);
+            evict(m_stashPath, OVERLAY_DISK_LIMIT);
+            DEBUG << "Using overlay directory" << path;
+            return true;
+        }
+
+        qWarning() << "No persistent overlay directory available, compiled documents will not be reused";
+
+        QScopedPointer<QTemporaryDir> directory(new QTemporaryDir(overlayTemplatePath()));
+        if (!directory->isValid()) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+            qWarning() << "Failed to create overlay directory:" << directory->errorString();
+#else
+            qWarning() << "Failed to create overlay directory";
+#endif
+            return false;
+        }
+
+        m_temporaryDirectory.swap(directory);
+        m_directoryPath = m_temporaryDirectory->path();
+        return true;
+    }
+
+    // Moves the documents stored by an earlier run aside. Left in place they would
+    // be found by the QML engine when listing directories of the overlay.
+    static void stash(const QString &path, const QString &stashPath)
+    {
+        const QDir dir(path);
+        QDirIterator it(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QString target = stashPath + QLatin1Char('/') + dir.relativeFilePath(it.filePath());
+            QDir().mkpath(QFileInfo(target).absolutePath());
+            QFile::remove(target);
+            QFile::rename(it.filePath(), target);
+        }
+        QDir(path).removeRecursively();
+        QDir().mkpath(path);
+    }
+
+    // Moves a stashed document back if it has the content. Renaming keeps the
+    // modification time, so its compiled form stays valid - both the one cached
+    // by the QML engine and the one stored next to the document, if any.
+    bool unstash(const LiveDocument &document, const QByteArray &content)
+    {
+        if (m_stashPath.isEmpty())
+            return false;
+
+        const QString stashedPath = document.absoluteFilePathIn(m_stashPath);
+        if (!hasContent(stashedPath, content))
+            return false;
+
+        const QString overlayingPath = document.absoluteFilePathIn(m_directoryPath);
+        QDir().mkpath(QFileInfo(overlayingPath).absolutePath());
+        QFile::remove(overlayingPath);
+        if (!QFile::rename(stashedPath, overlayingPath))
+            return false;
+
+        const QString compiledSuffix = QStringLiteral("c");
+        QFile::remove(overlayingPath + compiledSuffix);
+        QFile::rename(stashedPath + compiledSuffix, overlayingPath + compiledSuffix);
+        return true;
+    }
+
+    // Removes the files modified least recently until at most limit bytes are used.
+    // Whole documents are removed, the compiled units the QML engine caches for
+    // them elsewhere are left to the engine, which tells them by path and
+    // modification time only.
+    static void evict(const QString &path, qint64 limit)
+    {
+        QFileInfoList files;
+        qint64 total = 0;
+        QDirIterator it(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            files.append(it.fileInfo());
+            total += it.fileInfo().size();
+        }
+
+        if (total <= limit)
+            return;
+
+        std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+            return a.lastModified() < b.lastModified();
+        });
+
+        foreach (const QFileInfo &info, files) {
+            if (total <= limit)
+                break;
+            if (QFile::remove(info.absoluteFilePath()))
+                total -= info.size();
+        }
+    }
+
+    // Remote directories cannot be listed by the QML engine, so a qmldir
+    // is generated for them listing the components found on disk and in memory
+    QByteArray implicitQmldir(const QString &dirPath) const
+    {
+        QStringList fileNames = QDir(dirPath).entryList(QStringList() << QStringLiteral("*.qml"), QDir::Files);
+
+        QReadLocker locker(&m_lock);
+        for (auto it = m_mappings.constBegin(); it != m_mappings.constEnd(); ++it) {
+            const QFileInfo info(it.key());
+            if (info.absolutePath() == dirPath && info.suffix() == QLatin1String("qml")
+                    && !fileNames.contains(info.fileName())) {
+                fileNames.append(info.fileName());
+            }
+        }
+
+        QByteArray qmldir;
+        foreach (const QString &fileName, fileNames) {
+            const QString typeName = QFileInfo(fileName).completeBaseName();
+            if (typeName.isEmpty() || !typeName.at(0).isUpper())
+                continue;
+            qmldir += typeName.toUtf8() + " 1.0 " + fileName.toUtf8() + '\n';
+        }
+        return qmldir;
+    }
+
+    QString overlaySlotPath(int slot) const
+    {
+        const QString name = QString::fromLatin1(QCryptographicHash::hash(m_basePath.toUtf8(),
+                QCryptographicHash::Sha1).toHex().left(16))
+                + QLatin1Char(OVERLAY_PATH_SEPARATOR) + QString::number(slot);
+        const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (cacheLocation.isEmpty())
+            return overlayTemplatePath() + QLatin1Char(OVERLAY_PATH_SEPARATOR) + name;
+        return cacheLocation + QLatin1String("/qmllive-overlay-") + name;
+    }
+
     static QString overlayTemplatePath()
     {
         QSettings settings;
@@ -157,12 +457,147 @@ private:
 
 private:
     mutable QReadWriteLock m_lock;
-    // base path -> ( overlaying path, file exists at base path )
-    QHash<QString, QPair<QString, bool>> m_mappings;
+    QAtomicInt m_generation;
+    // base path -> overlay entry
+    QHash<QString, Entry> m_mappings;
     QString m_basePath;
-    QTemporaryDir m_overlay;
+    qint64 m_memoryLimit;
+    qint64 m_memoryUsage;
+    QString m_directoryPath;
+    // documents stored by earlier runs, see unstash()
+    QString m_stashPath;
+    QScopedPointer<QLockFile> m_slotLock;
+    QScopedPointer<QTemporaryDir> m_temporaryDirectory;
+};
+
+// Serves a document read from the overlay
+class OverlayReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    OverlayReply(const QNetworkRequest &request, QNetworkAccessManager::Operation operation,
+                 const Overlay *overlay, QObject *parent)
+        : QNetworkReply(parent)
+        , m_offset(0)
+    {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(operation);
+
+        if (operation != QNetworkAccessManager::GetOperation
+                && operation != QNetworkAccessManager::HeadOperation) {
+            setError(OperationNotImplementedError, tr("Operation not supported on overlay documents"));
+        } else if (!overlay->read(request.url(), &m_content)) {
+            setError(ContentNotFoundError, tr("Overlay document not found: %1").arg(request.url().toString()));
+        } else {
+            setHeader(QNetworkRequest::ContentLengthHeader, m_content.size());
+            if (operation == QNetworkAccessManager::HeadOperation)
+                m_content.clear();
+        }
+
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        QMetaObject::invokeMethod(this, "deliver", Qt::QueuedConnection);
+    }
+
+    qint64 bytesAvailable() const Q_DECL_OVERRIDE
+    {
+        return m_content.size() - m_offset + QNetworkReply::bytesAvailable();
+    }
+
+    bool isSequential() const Q_DECL_OVERRIDE
+    {
+        return true;
+    }
+
+    void abort() Q_DECL_OVERRIDE
+    {
+        close();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        if (m_offset >= m_content.size())
+            return -1;
+
+        const qint64 count = qMin(maxSize, m_content.size() - m_offset);
+        memcpy(data, m_content.constData() + m_offset, count);
+        m_offset += count;
+        return count;
+    }
+
+private Q_SLOTS:
+    void deliver()
+    {
+        if (error() != NoError) {
+            emit error(error());
+        } else {
+            emit metaDataChanged();
+            emit downloadProgress(m_content.size(), m_content.size());
+            if (!m_content.isEmpty())
+                emit readyRead();
+        }
+        emit finished();
+    }
+
+private:
+    QByteArray m_content;
+    qint64 m_offset;
 };
 
+class OverlayNetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+public:
+    OverlayNetworkAccessManager(const Overlay *overlay, QObject *parent)
+        : QNetworkAccessManager(parent)
+        , m_overlay(overlay)
+    {
+    }
+
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request,
+                                 QIODevice *outgoingData) Q_DECL_OVERRIDE
+    {
+        if (request.url().scheme() != QLatin1String(OVERLAY_URL_SCHEME))
+            return QNetworkAccessManager::createRequest(op, request, outgoingData);
+
+        return new OverlayReply(request, op, m_overlay, this);
+    }
+
+private:
+    const Overlay *m_overlay;
+};
+
+// Instances are created by the QML engine in its loader threads, including the
+// one used by QQuickPixmap, so images are served from the overlay as well
+class OverlayNetworkAccessManagerFactory : public QQmlNetworkAccessManagerFactory
+{
+public:
+    explicit OverlayNetworkAccessManagerFactory(const Overlay *overlay)
+        : m_overlay(overlay)
+    {
+    }
+
+    QNetworkAccessManager *create(QObject *parent) Q_DECL_OVERRIDE
+    {
+        return new OverlayNetworkAccessManager(m_overlay, parent);
+    }
+
+private:
+    const Overlay *m_overlay;
+};
+
+// Results are memoized per thread, tagged with the overlay and resource map
+// generations. Any update to either of them drops the memoized results.
+//
+// The workspace documents intercepted are recorded together with their size and
+// modification time at that point, to tell which documents the loaded components
+// depend on and whether they changed on disk since. The directories holding them
+// are recorded too, so that documents created or removed there later are noticed -
+// the QML engine resolves implicitly imported types by listing these directories.
 class UrlInterceptor : public QObject, public QQmlAbstractUrlInterceptor
 {
     Q_OBJECT
@@ -173,6 +608,7 @@ public:
         : QObject(parent)
         , m_otherInterceptor(otherInterceptor)
         , m_workspace(workspace)
+        , m_workspacePrefix(workspace.absolutePath() + QLatin1Char('/'))
         , m_overlay(overlay)
         , m_resourceMap(resourceMap)
     {
@@ -185,31 +621,241 @@ public:
     {
         const QUrl url_ = m_otherInterceptor ? m_otherInterceptor->intercept(url, type) : url;
 
-        if (url_.scheme() == QLatin1String("file")) {
-            bool existingOnly = true;
-            return QUrl::fromLocalFile(m_overlay->map(url_.toLocalFile(), existingOnly));
-        } else if (url_.scheme() == QLatin1String("qrc")) {
-            const LiveDocument document = LiveDocument::resolve(m_workspace, *m_resourceMap, url_);
-            if (document.isNull())
-                return url_;
-
-            QString filePath = document.absoluteFilePathIn(m_workspace);
-            bool existingOnly = false;
-            filePath = m_overlay->map(filePath, existingOnly);
-            if (!QFileInfo(filePath).exists())
-                return url_;
-
-            return QUrl::fromLocalFile(filePath);
-        } else {
+        if (url_.scheme() != QLatin1String("file") && url_.scheme() != QLatin1String("qrc"))
             return url_;
+
+        const int overlayGeneration = m_overlay->generation();
+        const int resourceMapGeneration = m_resourceMap->generation();
+        const int generation = m_generation.load();
+
+        Memo &memo = m_memo.localData();
+        if (memo.overlayGeneration != overlayGeneration
+                || memo.resourceMapGeneration != resourceMapGeneration
+                || memo.generation != generation
+                || memo.urls.size() >= MaximumMemoSize) {
+            memo.urls.clear();
+            memo.overlayGeneration = overlayGeneration;
+            memo.resourceMapGeneration = resourceMapGeneration;
+            memo.generation = generation;
+        }
+
+        auto it = memo.urls.constFind(url_);
+        const bool hit = it != memo.urls.constEnd();
+        if (!hit) {
+            Resolved resolved;
+            resolved.document = document(url_);
+            resolved.url = resolve(url_, resolved.document);
+            it = memo.urls.insert(url_, resolved);
+        }
+#ifdef QMLLIVE_DEBUG
+        // Shared counters would be contended by the loader threads otherwise
+        (hit ? m_hits : m_misses).ref();
+#endif
+
+        // Documents are recorded once per thread, the inputs are shared
+        const int inputsGeneration = m_inputsGeneration.load();
+        if (memo.inputsGeneration != inputsGeneration) {
+            memo.recorded.clear();
+            memo.inputsGeneration = inputsGeneration;
+        }
+        if (!it->document.isNull() && !memo.recorded.contains(it->document.relativeFilePath())) {
+            record(it->document);
+            memo.recorded.insert(it->document.relativeFilePath());
+        }
+        return it->url;
+    }
+
+    // To be called on workspace changes not tracked by the overlay
+    void invalidate()
+    {
+        m_generation.ref();
+    }
+
+    // Only counted with QMLLIVE_DEBUG
+    int hits() const { return m_hits.load(); }
+    int misses() const { return m_misses.load(); }
+
+    bool isInput(const LiveDocument &document) const
+    {
+        QMutexLocker locker(&m_inputsMutex);
+        return m_inputs.contains(document.relativeFilePath());
+    }
+
+    // Whether the file of a recorded document changed on disk since it was recorded,
+    // or the document was created or removed in a recorded directory since
+    bool isModified(const LiveDocument &document) const
+    {
+        const QFileInfo info(document.absoluteFilePathIn(m_workspace));
+        bool recorded = false;
+        Input input;
+        QDateTime directoryModified;
+        {
+            QMutexLocker locker(&m_inputsMutex);
+            auto it = m_inputs.constFind(document.relativeFilePath());
+            if (it != m_inputs.constEnd()) {
+                recorded = true;
+                input = *it;
+            }
+            directoryModified = m_directories.value(info.absolutePath());
+        }
+        if (recorded && !input.matches(info))
+            return true;
+        return directoryModified.isValid()
+                && QFileInfo(info.absolutePath()).lastModified() != directoryModified;
+    }
+
+    bool isAnyModified() const
+    {
+        QHash<QString, Input> inputs;
+        QHash<QString, QDateTime> directories;
+        {
+            QMutexLocker locker(&m_inputsMutex);
+            inputs = m_inputs;
+            directories = m_directories;
+        }
+        for (auto it = inputs.constBegin(); it != inputs.constEnd(); ++it) {
+            if (!it->matches(QFileInfo(m_workspace.absoluteFilePath(it.key()))))
+                return true;
+        }
+        for (auto it = directories.constBegin(); it != directories.constEnd(); ++it) {
+            if (QFileInfo(it.key()).lastModified() != it.value())
+                return true;
+        }
+        return false;
+    }
+
+    // To be called when the component cache is cleared
+    void resetInputs()
+    {
+        QMutexLocker locker(&m_inputsMutex);
+        m_inputs.clear();
+        m_directories.clear();
+        m_inputsGeneration.ref();
+    }
+
+    void resetStatistics()
+    {
+        m_hits.store(0);
+        m_misses.store(0);
+    }
+
+private:
+    enum { MaximumMemoSize = 16384 };
+
+    struct Resolved
+    {
+        QUrl url;
+        LiveDocument document;
+    };
+
+    struct Memo
+    {
+        Memo() : overlayGeneration(-1), resourceMapGeneration(-1), generation(-1), inputsGeneration(-1) {}
+        int overlayGeneration;
+        int resourceMapGeneration;
+        int generation;
+        QHash<QUrl, Resolved> urls;
+        // documents recorded by this thread since the inputs were reset
+        int inputsGeneration;
+        QSet<QString> recorded;
+    };
+
+    struct Input
+    {
+        qint64 size;
+        QDateTime lastModified;
+        // Only for files modified within the time resolution before being recorded,
+        // which may change again without changing the modification time
+        QByteArray hash;
+
+        bool matches(const QFileInfo &info) const
+        {
+            if (info.size() != size || info.lastModified() != lastModified)
+                return false;
+            return hash.isEmpty() || fileHash(info.absoluteFilePath()) == hash;
+        }
+    };
+
+    static QByteArray fileHash(const QString &path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(&file);
+        return hash.result();
+    }
+
+    // The workspace document at url, if any
+    LiveDocument document(const QUrl &url) const
+    {
+        if (url.scheme() == QLatin1String("file")) {
+            const QString path = url.toLocalFile();
+            if (!path.startsWith(m_workspacePrefix))
+                return LiveDocument();
+            return LiveDocument(path.mid(m_workspacePrefix.length()));
+        }
+
+        return LiveDocument::resolve(m_workspace, *m_resourceMap, url);
+    }
+
+    QUrl resolve(const QUrl &url, const LiveDocument &document) const
+    {
+        if (url.scheme() == QLatin1String("file")) {
+            bool existingOnly = true;
+            return m_overlay->map(url.toLocalFile(), existingOnly);
+        }
+
+        if (document.isNull())
+            return url;
+
+        bool existingOnly = false;
+        const QUrl mapped = m_overlay->map(document.absoluteFilePathIn(m_workspace), existingOnly);
+        if (mapped.isLocalFile() && !QFileInfo(mapped.toLocalFile()).exists())
+            return url;
+
+        return mapped;
+    }
+
+    void record(const LiveDocument &document)
+    {
+        {
+            QMutexLocker locker(&m_inputsMutex);
+            if (m_inputs.contains(document.relativeFilePath()))
+                return;
         }
+
+        const QFileInfo info(document.absoluteFilePathIn(m_workspace));
+        Input input;
+        input.size = info.size();
+        input.lastModified = info.lastModified();
+        if (info.isFile() && input.lastModified.msecsTo(QDateTime::currentDateTime()) < MODIFICATION_TIME_RESOLUTION)
+            input.hash = fileHash(info.absoluteFilePath());
+        const QString directoryPath = info.absolutePath();
+        const QDateTime directoryModified = QFileInfo(directoryPath).lastModified();
+
+        QMutexLocker locker(&m_inputsMutex);
+        if (!m_inputs.contains(document.relativeFilePath()))
+            m_inputs.insert(document.relativeFilePath(), input);
+        if (!m_directories.contains(directoryPath))
+            m_directories.insert(directoryPath, directoryModified);
     }
 
 private:
     QQmlAbstractUrlInterceptor *m_otherInterceptor;
     const QDir m_workspace;
+    const QString m_workspacePrefix;
     const QPointer<const Overlay> m_overlay;
     const QPointer<const ResourceMap> m_resourceMap;
+    QAtomicInt m_generation;
+    QAtomicInt m_hits;
+    QAtomicInt m_misses;
+    QThreadStorage<Memo> m_memo;
+    QAtomicInt m_inputsGeneration;
+    mutable QMutex m_inputsMutex;
+    QHash<QString, Input> m_inputs;
+    // absolute path -> modification time
+    QHash<QString, QDateTime> m_directories;
 };
 
 /*!
@@ -221,14 +867,34 @@ LiveNodeEngine::LiveNodeEngine(QObject *parent)
     , m_xOffset(0)
     , m_yOffset(0)
     , m_rotation(0)
+    , m_networkAccessManagerFactory(0)
+    , m_overlayMemoryLimit(DEFAULT_OVERLAY_MEMORY_LIMIT)
     , m_resourceMap(new ResourceMap(this))
     , m_delayReload(new QTimer(this))
     , m_pluginFactory(new ContentPluginFactory(this))
+    , m_adapterRegistry(new ContentAdapterRegistry)
     , m_activePlugin(0)
+    , m_reloading(false)
+    , m_contentRevision(0)
+    , m_loadedReady(false)
+    , m_activeOutdated(false)
+    , m_prefetchTimer(new QTimer(this))
+    , m_cacheRevision(-1)
+    , m_keepComponentCache(false)
+    , m_standbyTimer(new QTimer(this))
+    , m_standbyWarm(false)
 {
     m_delayReload->setInterval(250);
     m_delayReload->setSingleShot(true);
     connect(m_delayReload, &QTimer::timeout, this, &LiveNodeEngine::reloadDocument);
+
+    m_prefetchTimer->setInterval(PREFETCH_IDLE_DELAY);
+    m_prefetchTimer->setSingleShot(true);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &LiveNodeEngine::prefetchNext);
+
+    m_standbyTimer->setInterval(STANDBY_WARM_DELAY);
+    m_standbyTimer->setSingleShot(true);
+    connect(m_standbyTimer, &QTimer::timeout, this, &LiveNodeEngine::warmStandby);
 }
 
 /*!
@@ -236,10 +902,20 @@ LiveNodeEngine::LiveNodeEngine(QObject *parent)
  */
 LiveNodeEngine::~LiveNodeEngine()
 {
+    foreach (QQmlEngine *qmlEngine, qmlEngines()) {
+        if (qmlEngine->networkAccessManagerFactory() == m_networkAccessManagerFactory)
+            qmlEngine->setNetworkAccessManagerFactory(0);
+    }
+    delete m_networkAccessManagerFactory;
+    delete m_adapterRegistry;
 }
 
 /*!
  * The QML engine to be used for loading QML components
+ *
+ * With a standby engine set, the two engines take turns on reload.
+ *
+ * \sa setStandbyQmlEngine()
  */
 QQmlEngine *LiveNodeEngine::qmlEngine() const
 {
@@ -256,9 +932,87 @@ void LiveNodeEngine::setQmlEngine(QQmlEngine *qmlEngine)
 
     m_qmlEngine = qmlEngine;
 
-    connect(m_qmlEngine.data(), &QQmlEngine::warnings, this, &LiveNodeEngine::logErrors);
+    prepareQmlEngine(m_qmlEngine);
+}
+
+void LiveNodeEngine::prepareQmlEngine(QQmlEngine *qmlEngine)
+{
+    connect(qmlEngine, &QQmlEngine::warnings, this, &LiveNodeEngine::logErrors);
 
-    m_qmlEngine->rootContext()->setContextProperty("livert", m_runtime);
+    qmlEngine->rootContext()->setContextProperty("livert", m_runtime);
+}
+
+/*!
+ * Returns the QML engine kept on standby, or \c nullptr if none is set.
+ *
+ * \sa setStandbyQmlEngine()
+ */
+QQmlEngine *LiveNodeEngine::standbyQmlEngine() const
+{
+    return m_standbyEngine;
+}
+
+/*!
+ * Sets \a qmlEngine with its own \a fallbackView as a second QML engine, kept on
+ * standby to speed up reloads.
+ *
+ * While idle, the standby engine compiles an empty object with the module imports
+ * of the active document from outside of the workspace, which parses their qmldir
+ * files and loads their plugins. Singletons, dummy data and workspace documents
+ * are not prepared. Instead of clearing the component cache of qmlEngine(), a
+ * reload then continues with the standby engine and the previous engine is put
+ * on standby and prepared again in the background. A window created by a
+ * document is recreated on reload anyway, only Item based documents move to the
+ * other fallback view.
+ *
+ * Must be called after setFallbackView() and before setWorkspace(). The import
+ * paths and plugin paths of qmlEngine() are copied to the \a qmlEngine whenever
+ * they change.
+ */
+void LiveNodeEngine::setStandbyQmlEngine(QQmlEngine *qmlEngine, QQuickView *fallbackView)
+{
+    Q_ASSERT(this->qmlEngine());
+    Q_ASSERT(!m_standbyEngine);
+    Q_ASSERT(qmlEngine && qmlEngine != this->qmlEngine());
+    Q_ASSERT(fallbackView && fallbackView->engine() == qmlEngine);
+    Q_ASSERT(m_fallbackView);
+
+    m_standbyEngine = qmlEngine;
+    m_standbyView = fallbackView;
+
+    prepareQmlEngine(m_standbyEngine);
+    syncStandbyPaths();
+}
+
+/*!
+ * Copies the import paths and plugin paths of qmlEngine() to the standby engine.
+ * Returns true if they differed, the standby engine is not warm anymore then.
+ */
+bool LiveNodeEngine::syncStandbyPaths()
+{
+    if (!m_standbyEngine)
+        return false;
+
+    if (m_standbyEngine->importPathList() == m_qmlEngine->importPathList()
+            && m_standbyEngine->pluginPathList() == m_qmlEngine->pluginPathList()) {
+        return false;
+    }
+
+    m_standbyEngine->setImportPathList(m_qmlEngine->importPathList());
+    m_standbyEngine->setPluginPathList(m_qmlEngine->pluginPathList());
+    m_standbyWarm = false;
+    m_standbyDocument = LiveDocument();
+    return true;
+}
+
+QList<QQmlEngine *> LiveNodeEngine::qmlEngines() const
+{
+    QList<QQmlEngine *> engines;
+    if (m_qmlEngine)
+        engines.append(m_qmlEngine);
+    if (m_standbyEngine)
+        engines.append(m_standbyEngine);
+    return engines;
 }
 
 /*!
@@ -422,6 +1176,11 @@ void LiveNodeEngine::usePreloadedDocument(const QString &document, QQuickWindow
  * The activeDocumentChanged() signal is emitted when this results in change of
  * the activeDocument().
  *
+ * With AllowUpdates, loading the document loaded already is skipped unless a
+ * document it uses was updated with updateDocument() or changed on disk since, a
+ * document was created or removed in a directory it uses, or the last load failed.
+ * Use reloadDocument() to reload unconditionally.
+ *
  * \sa documentLoaded()
  */
 void LiveNodeEngine::loadDocument(const LiveDocument& document)
@@ -435,8 +1194,21 @@ void LiveNodeEngine::loadDocument(const LiveDocument& document)
     if (m_activeFile != oldActiveFile)
         emit activeDocumentChanged(m_activeFile);
 
-    if (!m_activeFile.isNull())
-        reloadDocument();
+    if (m_activeFile.isNull())
+        return;
+
+    if ((m_workspaceOptions & AllowUpdates) && m_activeFile == m_loadedDocument && !m_activeOutdated) {
+        if (m_loadedReady && m_urlInterceptor && !m_urlInterceptor->isAnyModified()) {
+            DEBUG << "Document and the documents it uses unchanged, not reloading" << m_activeFile;
+            return;
+        }
+        // Failed to load or changed on disk by other means than updateDocument(),
+        // drop what is compiled including the type loader's view of the directories
+        ++m_contentRevision;
+    }
+
+    m_keepComponentCache = true;
+    reloadDocument();
 }
 
 /*!
@@ -451,17 +1223,21 @@ void LiveNodeEngine::delayReload()
 }
 
 /*!
- * Checks if the QtQuick Controls module exists for the content adapters
+ * Checks if the QtQuick Controls module exists for the content adapters.
+ *
+ * The result is only updated when the import paths change.
  */
 void LiveNodeEngine::checkQmlFeatures()
 {
-    foreach (const QString &importPath, m_qmlEngine->importPathList()) {
-        QDir dir(importPath);
-        if (dir.exists("QtQuick/Controls") &&
-            dir.exists("QtQuick/Layouts") &&
-            dir.exists("QtQuick/Dialogs")) {
-            m_quickFeatures |= ContentAdapterInterface::QtQuickControls;
-        }
+    if (!m_importPathIndex.setImportPaths(m_qmlEngine->importPathList()))
+        return;
+
+    if (m_importPathIndex.hasModule(QStringLiteral("QtQuick.Controls")) &&
+        m_importPathIndex.hasModule(QStringLiteral("QtQuick.Layouts")) &&
+        m_importPathIndex.hasModule(QStringLiteral("QtQuick.Dialogs"))) {
+        m_quickFeatures |= ContentAdapterInterface::QtQuickControls;
+    } else {
+        m_quickFeatures &= ~ContentAdapterInterface::QtQuickControls;
     }
 }
 
@@ -475,7 +1251,9 @@ QUrl LiveNodeEngine::errorScreenUrl() const
 /*!
  * Reloads the active QML document.
  *
- * Emits documentLoaded() when finished.
+ * Emits documentLoaded() when finished. Documents served from the in-memory
+ * overlay load asynchronously, in which case this returns before. A reload
+ * requested meanwhile abandons the one in progress.
  *
  * If \l fallbackView is set, its \c source will be cleared, whether the view
  * was previously used or not.
@@ -484,6 +1262,21 @@ void LiveNodeEngine::reloadDocument()
 {
     Q_ASSERT(qmlEngine());
 
+    const bool keepComponentCache = m_keepComponentCache;
+    m_keepComponentCache = false;
+
+    if (m_loadingComponent) {
+        DEBUG << "Abandoning loading" << m_loadingComponent->url();
+        delete m_loadingComponent;
+    }
+    m_reloading = true;
+
+    // Any pending delayed reload is covered by this one
+    m_delayReload->stop();
+    m_loadedDocument = m_activeFile;
+    m_loadedReady = false;
+    m_activeOutdated = false;
+
     while (!m_activeWindowConnections.isEmpty()) {
         disconnect(m_activeWindowConnections.takeLast());
     }
@@ -497,7 +1290,25 @@ void LiveNodeEngine::reloadDocument()
     delete m_object;
 
     QQuickPixmap::purgeCache();
-    m_qmlEngine->clearComponentCache();
+    if (keepComponentCache && (m_workspaceOptions & AllowUpdates) && m_cacheRevision == m_contentRevision) {
+        // Just switching documents, keep what is compiled, prefetched documents in particular
+        m_qmlEngine->trimComponentCache();
+    } else {
+        syncStandbyPaths();
+        if (m_standbyWarm) {
+            // Nothing compiled from the workspace lives in the standby engine
+            clearPrefetched();
+            swapStandby();
+        } else {
+            clearPrefetched();
+            m_qmlEngine->clearComponentCache();
+        }
+        m_cacheRevision = m_contentRevision;
+        // Everything is compiled again, recording what is used
+        if (m_urlInterceptor)
+            m_urlInterceptor->resetInputs();
+        m_prefetchOnly.clear();
+    }
 
     checkQmlFeatures();
 
@@ -506,12 +1317,50 @@ void LiveNodeEngine::reloadDocument()
 
     emit clearLog();
 
-    const QUrl originalUrl = m_activeFile.runtimeLocation(m_workspace, *m_resourceMap);
-    const QUrl url = queryDocumentViewer(originalUrl);
+    m_loadingOriginalUrl = m_activeFile.runtimeLocation(m_workspace, *m_resourceMap);
+    m_loadingUrl = queryDocumentViewer(m_loadingOriginalUrl);
+
+    DEBUG << "Loading document" << m_activeFile << "runtime location:" << m_loadingOriginalUrl;
+    if (m_loadingUrl != m_loadingOriginalUrl)
+        DEBUG << "Using viewer" << m_loadingUrl;
+
+    m_loadingComponent = new QQmlComponent(m_qmlEngine, this);
+    if (m_loadingUrl.path().endsWith(QLatin1String(".qml"), Qt::CaseInsensitive)) {
+        m_loadingComponent->loadUrl(m_loadingUrl);
+        if (m_loadingComponent->isLoading()) {
+            // Documents served from the in-memory overlay load asynchronously
+            connect(m_loadingComponent.data(), &QQmlComponent::statusChanged,
+                    this, &LiveNodeEngine::continueReload);
+            return;
+        }
+    }
 
-    DEBUG << "Loading document" << m_activeFile << "runtime location:" << originalUrl;
-    if (url != originalUrl)
-        DEBUG << "Using viewer" << url;
+    continueReload();
+}
+
+/*!
+ * Finishes reloadDocument() once the component is loaded.
+ */
+void LiveNodeEngine::continueReload()
+{
+    if (!m_loadingComponent || m_loadingComponent->isLoading())
+        return;
+
+    // May be called from a signal of the component
+    QScopedPointer<QQmlComponent, QScopedPointerDeleteLater> component(m_loadingComponent.data());
+    m_loadingComponent.clear();
+    disconnect(component.data(), &QQmlComponent::statusChanged, this, &LiveNodeEngine::continueReload);
+
+    const QUrl originalUrl = m_loadingOriginalUrl;
+    const QUrl url = m_loadingUrl;
+
+    if (m_activeOutdated) {
+        // Updated while loading, the component may mix old and new content
+        DEBUG << "Workspace updated while loading" << url;
+        m_reloading = false;
+        delayReload();
+        return;
+    }
 
     auto showErrorScreen = [this] {
         Q_ASSERT(m_fallbackView);
@@ -530,10 +1379,9 @@ void LiveNodeEngine::reloadDocument()
         emit logErrors(QList<QQmlError>() << error);
     };
 
-    QScopedPointer<QQmlComponent> component(new QQmlComponent(m_qmlEngine));
     if (url.path().endsWith(QLatin1String(".qml"), Qt::CaseInsensitive)) {
-        component->loadUrl(url);
-        m_object = component->create();
+        if (component->isReady())
+            m_object = component->create();
     } else if (url == originalUrl) {
         logError(tr("LiveNodeEngine: Cannot display this file type"));
     } else {
@@ -541,16 +1389,10 @@ void LiveNodeEngine::reloadDocument()
     }
 
     if (!component->isReady()) {
-        if (component->isLoading()) {
-            qCritical() << "Component did not load synchronously."
-                        << "URL:" << url.toString()
-                        << "(original URL:" << originalUrl.toString() << ")";
-        } else {
-            emit logErrors(component->errors());
-            delete m_object;
-            if (m_fallbackView)
-                showErrorScreen();
-        }
+        emit logErrors(component->errors());
+        delete m_object;
+        if (m_fallbackView)
+            showErrorScreen();
     } else if (QQuickWindow *window = qobject_cast<QQuickWindow *>(m_object)) {
         // TODO (why) is this needed?
         m_qmlEngine->setIncubationController(window->incubationController());
@@ -576,6 +1418,10 @@ void LiveNodeEngine::reloadDocument()
             showErrorScreen();
     }
 
+    // Errors may go away without any document changing, e.g. once a missing
+    // module is installed, so failed loads are never skipped
+    m_loadedReady = component->isReady() && m_object && m_activeWindow;
+
     if (m_activeWindow) {
         m_activeWindowConnections << connect(m_activeWindow.data(), &QWindow::widthChanged,
                                              this, &LiveNodeEngine::onSizeChanged);
@@ -584,6 +1430,14 @@ void LiveNodeEngine::reloadDocument()
         onSizeChanged();
     }
 
+    if (m_urlInterceptor) {
+        DEBUG << "URL interceptor hits:" << m_urlInterceptor->hits()
+              << "misses:" << m_urlInterceptor->misses();
+        m_urlInterceptor->resetStatistics();
+    }
+
+    m_reloading = false;
+
     emit documentLoaded();
     emit activeWindowChanged(m_activeWindow);
 
@@ -595,11 +1449,24 @@ void LiveNodeEngine::reloadDocument()
     // (Applies when this is instantiated for the bench.)
     if (m_activeWindow)
         m_activeWindow->show();
+
+    if (m_standbyView && m_standbyView != m_activeWindow)
+        m_standbyView->close();
+
+    if (m_standbyEngine && (!m_standbyWarm || m_standbyDocument != m_activeFile))
+        m_standbyTimer->start();
 }
 
 /*!
  * Updates \a content of the given workspace \a document when enabled.
  *
+ * The active document is reloaded if it uses the \a document, i.e. the document was
+ * loaded by any component compiled since the component cache was cleared last. This
+ * includes documents loaded dynamically, e.g. with a \l Loader. The \a document
+ * counts as updated also when the workspace held the \a content already, but not
+ * when the active document was loaded. Creating a document reloads the active
+ * document in any case.
+ *
  * The behavior of this function is controlled by WorkspaceOptions passed to setWorkspace().
  */
 void LiveNodeEngine::updateDocument(const LiveDocument &document, const QByteArray &content)
@@ -610,6 +1477,11 @@ void LiveNodeEngine::updateDocument(const LiveDocument &document, const QByteArr
         buffer.open(QIODevice::ReadOnly);
         if (!m_resourceMap->updateMapping(document, &buffer))
             qWarning() << "Unable to parse qrc file " << document.relativeFilePath() << ":" << m_resourceMap->errorString();
+        ++m_contentRevision;
+        // Any document may resolve differently now
+        m_activeOutdated = true;
+        if (!m_activeFile.isNull())
+            delayReload();
     }
 
     if (!(m_workspaceOptions & AllowUpdates)) {
@@ -622,25 +1494,226 @@ void LiveNodeEngine::updateDocument(const LiveDocument &document, const QByteArr
         return;
 
     bool useOverlay = (m_workspaceOptions & UpdatesAsOverlay) || mapsToResource;
+    // Types are resolved by listing directories, a new document may be used by any
+    bool created = !existsInWorkspace && !mapsToResource && !m_overlay->contains(document);
+
+    bool changed = true;
+    if (useOverlay) {
+        if (!m_overlay->store(document, existsInWorkspace, content, &changed))
+            return;
+    } else if (hasContent(document.absoluteFilePathIn(m_workspace), content)) {
+        changed = false;
+    } else {
+        QString writablePath = document.absoluteFilePathIn(m_workspace);
+        QString writableDirPath = QFileInfo(writablePath).absoluteDir().absolutePath();
+        QDir().mkpath(writableDirPath);
+        QFile file(writablePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Unable to save file: " << file.errorString();
+            return;
+        }
+        file.write(content);
+        file.close();
+
+        if (m_urlInterceptor)
+            m_urlInterceptor->invalidate();
+    }
 
-    QString writablePath = useOverlay
-        ? m_overlay->reserve(document, existsInWorkspace)
-        : document.absoluteFilePathIn(m_workspace);
+    emit documentUpdated(document, content);
 
-    QString writableDirPath = QFileInfo(writablePath).absoluteDir().absolutePath();
-    QDir().mkpath(writableDirPath);
-    QFile file(writablePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Unable to save file: " << file.errorString();
+    // Stored already, e.g. written to a shared workspace by the sender, but
+    // possibly after the active document was loaded
+    if (!changed && !created && !(m_urlInterceptor && m_urlInterceptor->isModified(document)))
         return;
-    }
-    file.write(content);
-    file.close();
 
-    if (!m_activeFile.isNull())
+    ++m_contentRevision;
+
+    if ((created && !m_activeFile.isNull()) || isActiveInput(document)) {
+        m_activeOutdated = true;
         delayReload();
+    }
+}
+
+/*!
+ * Returns true if the active document uses \a document, as far as recorded while
+ * loading components. Documents compiled ahead by prefetchDocuments() do not count
+ * unless the active document used them already.
+ */
+bool LiveNodeEngine::isActiveInput(const LiveDocument &document) const
+{
+    if (m_activeFile.isNull())
+        return false;
+
+    if (document == m_activeFile || !m_urlInterceptor)
+        return true;
+
+    // Directory previews show the files directly in the directory
+    if (m_activeFile.existsIn(m_workspace) && !m_activeFile.isFileIn(m_workspace))
+        return QFileInfo(document.relativeFilePath()).path() == m_activeFile.relativeFilePath();
+
+    return m_urlInterceptor->isInput(document) && !m_prefetchOnly.contains(document.relativeFilePath());
+}
+
+
+/*!
+ * Compiles the QML \a documents in the background, in the given order, so that
+ * loading any of them later does not need to compile it.
+ *
+ * Documents are compiled when the node is idle, a few at a time. Each call replaces
+ * the documents from the previous call which were not compiled yet. Only available
+ * with AllowUpdates, otherwise the component cache is cleared on every load.
+ */
+void LiveNodeEngine::prefetchDocuments(const QStringList &documents)
+{
+    if (!(m_workspaceOptions & AllowUpdates))
+        return;
+
+    m_prefetchQueue.clear();
+    foreach (const QString &path, documents) {
+        const LiveDocument document(path);
+        if (document != m_activeFile && path.endsWith(QLatin1String(".qml"), Qt::CaseInsensitive))
+            m_prefetchQueue.append(document);
+    }
+
+    if (!m_prefetchQueue.isEmpty())
+        m_prefetchTimer->start();
+}
+
+void LiveNodeEngine::prefetchNext()
+{
+    if (!m_qmlEngine)
+        return;
+
+    // Do not compete with loading the active document
+    if (m_reloading || m_delayReload->isActive()) {
+        m_prefetchTimer->start();
+        return;
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+    while (!m_prefetchQueue.isEmpty() && budget.elapsed() < PREFETCH_TIME_BUDGET) {
+        const LiveDocument document = m_prefetchQueue.takeFirst();
+        DEBUG << "Prefetching" << document;
+
+        // Not to be taken for a document the active document uses
+        if (m_urlInterceptor && !m_urlInterceptor->isInput(document))
+            m_prefetchOnly.insert(document.relativeFilePath());
+
+        // Asynchronous components are compiled by the type loader thread
+        const QUrl url = document.runtimeLocation(m_workspace, *m_resourceMap);
+        m_prefetched.append(new QQmlComponent(m_qmlEngine, url, QQmlComponent::Asynchronous, this));
+        while (m_prefetched.count() > MAXIMUM_PREFETCHED)
+            delete m_prefetched.takeFirst();
+    }
+
+    if (!m_prefetchQueue.isEmpty())
+        m_prefetchTimer->start();
+}
+
+/*!
+ * Continues with the standby engine and its fallback view, putting the current
+ * ones on standby. The fallback view keeps its place on screen.
+ */
+void LiveNodeEngine::swapStandby()
+{
+    if (m_fallbackView && m_standbyView) {
+        m_standbyView->setGeometry(m_fallbackView->geometry());
+        m_standbyView->setWindowState(m_fallbackView->windowState());
+    }
+
+    qSwap(m_qmlEngine, m_standbyEngine);
+    qSwap(m_fallbackView, m_standbyView);
+
+    m_standbyWarm = false;
+    m_standbyDocument = LiveDocument();
+}
+
+void LiveNodeEngine::warmStandby()
+{
+    if (!m_standbyEngine)
+        return;
+
+    // Do not compete with loading the active document
+    if (m_reloading || m_delayReload->isActive()) {
+        m_standbyTimer->start();
+        return;
+    }
+
+    // Drop what the engine compiled while it was active. Once warm, it is
+    // only extended for other documents.
+    syncStandbyPaths();
+    if (!m_standbyWarm)
+        m_standbyEngine->clearComponentCache();
+
+    QByteArray data("import QtQml 2.0\n");
+    data += standbyImports();
+    data += "QtObject {}\n";
+
+    // Compiled synchronously, resolving the imports and loading their plugins
+    QQmlComponent component(m_standbyEngine);
+    component.setData(data, QUrl());
+    delete component.create();
+    if (!component.isReady())
+        DEBUG << "Warming standby engine failed:" << component.errors();
+
+    m_standbyWarm = true;
+    m_standbyDocument = m_activeFile;
+}
+
+/*!
+ * Returns the import statements of the active document for modules from
+ * outside of the workspace. These are not affected by workspace updates.
+ */
+QByteArray LiveNodeEngine::standbyImports()
+{
+    if (m_activeFile.isNull() || !m_activeFile.relativeFilePath().endsWith(QLatin1String(".qml"), Qt::CaseInsensitive))
+        return QByteArray();
+
+    const QString path = m_activeFile.absoluteFilePathIn(m_workspace);
+    QByteArray content;
+    if (m_overlay) {
+        if (!m_overlay->read(QUrl::fromLocalFile(path), &content))
+            return QByteArray();
+    } else {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        content = file.readAll();
+    }
+
+    static const QRegularExpression moduleImport(
+        QStringLiteral("^\\s*import\\s+([A-Za-z_][\\w.]*)\\s+(\\d+)(\\.\\d+)?(\\s+as\\s+[A-Za-z_]\\w*)?"),
+        QRegularExpression::MultilineOption);
+
+    const QString workspacePath = m_workspace.absolutePath() + QLatin1Char('/');
+    QByteArray imports;
+    QRegularExpressionMatchIterator it = moduleImport.globalMatch(QString::fromUtf8(content));
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        const QString uri = match.captured(1);
+        if (uri == QLatin1String("QtQml"))
+            continue;
+
+        const ImportPathIndex::Module module = m_importPathIndex.module(uri, match.captured(2).toInt());
+        if (!module.isValid() || (module.directory + QLatin1Char('/')).startsWith(workspacePath))
+            continue;
+
+        imports += match.captured(0).trimmed().toUtf8() + '\n';
+    }
+
+    return imports;
 }
 
+/*!
+ * Drops the documents compiled already. Documents still queued are compiled with the
+ * new content.
+ */
+void LiveNodeEngine::clearPrefetched()
+{
+    qDeleteAll(m_prefetched);
+    m_prefetched.clear();
+}
 
 /*!
  * Allows to adapt a \a url to display not native QML documents (e.g. images).
@@ -649,15 +1722,16 @@ QUrl LiveNodeEngine::queryDocumentViewer(const QUrl& url)
 {
     initPlugins();
 
-    foreach (ContentAdapterInterface *adapter, m_plugins) {
-        if (adapter->canAdapt(url)) {
-            adapter->cleanUp();
-            adapter->setAvailableFeatures(m_quickFeatures);
+    // Subclasses may append to m_plugins directly
+    m_adapterRegistry->setAdapters(m_plugins);
 
-            m_activePlugin = adapter;
+    if (ContentAdapterInterface *adapter = m_adapterRegistry->find(url)) {
+        adapter->cleanUp();
+        adapter->setAvailableFeatures(m_quickFeatures);
 
-            return adapter->adapt(url, m_qmlEngine->rootContext());
-        }
+        m_activePlugin = adapter;
+
+        return adapter->adapt(url, m_qmlEngine->rootContext());
     }
 
     m_activePlugin = 0;
@@ -685,9 +1759,25 @@ void LiveNodeEngine::setWorkspace(const QString &path, WorkspaceOptions options)
 
     m_workspace = QDir(path);
     m_workspaceOptions = options;
+    ++m_contentRevision;
+    m_activeOutdated = true;
+    m_prefetchOnly.clear();
+
+    foreach (QQmlEngine *qmlEngine, qmlEngines()) {
+        if (m_workspaceOptions & LoadDummyData)
+            QmlHelper::loadDummyData(qmlEngine, m_workspace.absolutePath());
+
+        if ((m_workspaceOptions & UpdatesInMemory) && qmlEngine->networkAccessManagerFactory()) {
+            qWarning() << "Got UpdatesInMemory but a network access manager factory is already set. "
+                          "Disabling UpdatesInMemory.";
+            m_workspaceOptions &= ~UpdatesInMemory;
+        }
+    }
 
-    if (m_workspaceOptions & LoadDummyData)
-        QmlHelper::loadDummyData(m_qmlEngine, m_workspace.absolutePath());
+    if ((m_workspaceOptions & UpdatesInMemory) && !(m_workspaceOptions & UpdatesAsOverlay)) {
+        qWarning() << "Got UpdatesInMemory without UpdatesAsOverlay. Enabling UpdatesAsOverlay.";
+        m_workspaceOptions |= UpdatesAsOverlay;
+    }
 
     if ((m_workspaceOptions & UpdatesAsOverlay) && !(m_workspaceOptions & AllowUpdates)) {
         qWarning() << "Got UpdatesAsOverlay without AllowUpdates. Enabling AllowUpdates.";
@@ -701,14 +1791,50 @@ void LiveNodeEngine::setWorkspace(const QString &path, WorkspaceOptions options)
 
     if (m_workspaceOptions & AllowUpdates) {
         // Even without UpdatesAsOverlay the overlay is used for Qt resources
-        m_overlay = new Overlay(m_workspace.path(), this);
+        const qint64 memoryLimit = (m_workspaceOptions & UpdatesInMemory) ? m_overlayMemoryLimit : 0;
+        m_overlay = new Overlay(m_workspace.path(), memoryLimit, this);
+        if (m_workspaceOptions & UpdatesInMemory) {
+            m_networkAccessManagerFactory = new OverlayNetworkAccessManagerFactory(m_overlay);
+            foreach (QQmlEngine *qmlEngine, qmlEngines())
+                qmlEngine->setNetworkAccessManagerFactory(m_networkAccessManagerFactory);
+        }
         m_urlInterceptor = new UrlInterceptor(m_workspace, m_overlay, m_resourceMap, qmlEngine()->urlInterceptor(), this);
-        qmlEngine()->setUrlInterceptor(m_urlInterceptor);
+        foreach (QQmlEngine *qmlEngine, qmlEngines())
+            qmlEngine->setUrlInterceptor(m_urlInterceptor);
     }
 
+    m_standbyWarm = false;
+    m_standbyDocument = LiveDocument();
+    if (m_standbyEngine)
+        m_standbyTimer->start();
+
     emit workspaceChanged(workspace());
 }
 
+/*!
+ * Returns the maximum amount of memory in bytes used to store updates when
+ * \l UpdatesInMemory is enabled. The default is 64 MiB.
+ *
+ * \sa setOverlayMemoryLimit()
+ */
+qint64 LiveNodeEngine::overlayMemoryLimit() const
+{
+    return m_overlayMemoryLimit;
+}
+
+/*!
+ * Sets the maximum amount of memory in bytes used to store updates when
+ * \l UpdatesInMemory is enabled to \a bytes. Documents which would exceed
+ * this limit are stored in a temporary directory instead.
+ */
+void LiveNodeEngine::setOverlayMemoryLimit(qint64 bytes)
+{
+    m_overlayMemoryLimit = bytes;
+
+    if (m_overlay && (m_workspaceOptions & UpdatesInMemory))
+        m_overlay->setMemoryLimit(bytes);
+}
+
 /*!
  * Returns the ResourceMap managed by this instance.
  *
@@ -770,12 +1896,27 @@ void LiveNodeEngine::initPlugins()
 {
     if (m_plugins.isEmpty()) {
         m_pluginFactory->load();
-        m_plugins.append(m_pluginFactory->plugins());
-        m_plugins.append(new ImageAdapter(this));
-        m_plugins.append(new FontAdapter(this));
+        foreach (ContentAdapterInterface *plugin, m_pluginFactory->plugins())
+            registerPlugin(plugin, m_pluginFactory->suffixes(plugin));
+        registerPlugin(new ImageAdapter(this), ImageAdapter::supportedSuffixes());
+        registerPlugin(new FontAdapter(this), FontAdapter::supportedSuffixes());
     }
 }
 
+/*!
+ * Appends \a plugin to the list of content adapters.
+ *
+ * If \a suffixes is not empty, the plugin is primarily asked about documents
+ * with one of these file suffixes. Other documents are offered to it only
+ * when no other plugin accepts them. Without \a suffixes the plugin is asked
+ * about every document.
+ */
+void LiveNodeEngine::registerPlugin(ContentAdapterInterface *plugin, const QStringList &suffixes)
+{
+    m_plugins.append(plugin);
+    m_adapterRegistry->setClaimedSuffixes(plugin, suffixes);
+}
+
 /*!
  * Handles size changes and updates the view according
  */
@@ -832,6 +1973,13 @@ void LiveNodeEngine::onSizeChanged()
  * Log the Errors \a errors
  */
 
+/*!
+ * \fn void LiveNodeEngine::documentUpdated(const LiveDocument &document, const QByteArray &content)
+ *
+ * This signal is emitted when updateDocument() stored \a content for \a document,
+ * or found it stored already. Rejected updates are not reported.
+ */
+
 /*!
  * \fn void LiveNodeEngine::workspaceChanged(const QString &workspace)
  *
@@ -35,10 +35,12 @@
 #include <QtQuick>
 
 #include "contentadapterinterface.h"
+#include "importpathindex.h"
 #include "livedocument.h"
 #include "qmllive_global.h"
 
 class LiveRuntime;
+class ContentAdapterRegistry;
 class ContentPluginFactory;
 class Overlay;
 class ResourceMap;
@@ -54,7 +56,8 @@ public:
         LoadDummyData = 0x1,
         AllowUpdates = 0x2,
         UpdatesAsOverlay = 0x4,
-        AllowCreateMissing = 0x8
+        AllowCreateMissing = 0x8,
+        UpdatesInMemory = 0x10
     };
     Q_DECLARE_FLAGS(WorkspaceOptions, WorkspaceOption)
 #if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
@@ -73,6 +76,9 @@ public:
     QQuickView *fallbackView() const;
     void setFallbackView(QQuickView *fallbackView);
 
+    QQmlEngine *standbyQmlEngine() const;
+    void setStandbyQmlEngine(QQmlEngine *qmlEngine, QQuickView *fallbackView);
+
     int xOffset() const;
     int yOffset() const;
     int rotation() const;
@@ -81,6 +87,9 @@ public:
     void setWorkspace(const QString &path, WorkspaceOptions options = NoWorkspaceOption);
     ResourceMap *resourceMap() const;
 
+    qint64 overlayMemoryLimit() const;
+    void setOverlayMemoryLimit(qint64 bytes);
+
     void setPluginPath(const QString& path);
     QString pluginPath() const;
 
@@ -101,6 +110,7 @@ public Q_SLOTS:
     void delayReload();
     virtual void reloadDocument();
     void updateDocument(const LiveDocument &document, const QByteArray &content);
+    void prefetchDocuments(const QStringList &documents);
 
 Q_SIGNALS:
     void activeDocumentChanged(const LiveDocument& document);
@@ -110,20 +120,32 @@ Q_SIGNALS:
     void activeWindowChanged(QQuickWindow *window);
     void logErrors(const QList<QQmlError> &errors);
     void workspaceChanged(const QString &workspace);
+    void documentUpdated(const LiveDocument &document, const QByteArray &content);
 
 protected:
     virtual void initPlugins();
+    void registerPlugin(ContentAdapterInterface *plugin, const QStringList &suffixes = QStringList());
     QList<ContentAdapterInterface*> m_plugins;
     LiveDocument m_activeFile;
     LiveRuntime *m_runtime;
 
 private Q_SLOTS:
     void onSizeChanged();
+    void continueReload();
+    void prefetchNext();
+    void warmStandby();
 
 private:
     void checkQmlFeatures();
     QUrl errorScreenUrl() const;
     QUrl queryDocumentViewer(const QUrl& url);
+    void clearPrefetched();
+    void prepareQmlEngine(QQmlEngine *qmlEngine);
+    QList<QQmlEngine *> qmlEngines() const;
+    bool isActiveInput(const LiveDocument &document) const;
+    void swapStandby();
+    bool syncStandbyPaths();
+    QByteArray standbyImports();
 
 private:
     int m_xOffset;
@@ -134,6 +156,8 @@ private:
     QPointer<QQuickView> m_fallbackView;
     QPointer<QObject> m_object;
     QPointer<QQuickWindow> m_activeWindow;
+    QQmlNetworkAccessManagerFactory *m_networkAccessManagerFactory;
+    qint64 m_overlayMemoryLimit;
     QList<QMetaObject::Connection> m_activeWindowConnections;
     QDir m_workspace;
     WorkspaceOptions m_workspaceOptions;
@@ -143,9 +167,39 @@ private:
     QTimer *m_delayReload;
 
     ContentPluginFactory* m_pluginFactory;
+    ContentAdapterRegistry *m_adapterRegistry;
     ContentAdapterInterface* m_activePlugin;
 
     ContentAdapterInterface::Features m_quickFeatures;
+    ImportPathIndex m_importPathIndex;
+    bool m_reloading;
+    QPointer<QQmlComponent> m_loadingComponent;
+    QUrl m_loadingUrl;
+    QUrl m_loadingOriginalUrl;
+
+    // Bumped whenever workspace content is updated, to tell if the component cache is outdated
+    int m_contentRevision;
+    LiveDocument m_loadedDocument;
+    // Whether loading m_loadedDocument produced an object without errors
+    bool m_loadedReady;
+    // Set when a document used by the active document was updated
+    bool m_activeOutdated;
+
+    // Compiled ahead of being activated, kept alive to stay in the component cache
+    QTimer *m_prefetchTimer;
+    QList<LiveDocument> m_prefetchQueue;
+    QList<QPointer<QQmlComponent> > m_prefetched;
+    // Prefetched documents not used by the active document, see isActiveInput()
+    QSet<QString> m_prefetchOnly;
+    int m_cacheRevision;
+    bool m_keepComponentCache;
+
+    // Takes over on reload with imports resolved already, see setStandbyQmlEngine()
+    QPointer<QQmlEngine> m_standbyEngine;
+    QPointer<QQuickView> m_standbyView;
+    QTimer *m_standbyTimer;
+    bool m_standbyWarm;
+    LiveDocument m_standbyDocument;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(LiveNodeEngine::WorkspaceOptions)
@@ -112,7 +112,7 @@ Item {
                 anchors.margins: 4
 
                 function loadDocument() {
-                    adapter.loadDocument(path + "/" + modelData)
+                    adapter.loadDocument(model.filePath)
                 }
 
                 focus: true
@@ -131,7 +131,16 @@ Item {
 
                     height: 0.8 * width
 
-                    source: "image://qmlLiveDirectoryPreview/" + path + "/" + modelData
+                    // Do not request previews for delegates just passing by. Once
+                    // requested, keep the preview when flicking starts again.
+                    property bool requested: false
+                    Component.onCompleted: requested = !grid.flicking
+                    Connections {
+                        target: grid
+                        onFlickingChanged: if (!grid.flicking) image.requested = true
+                    }
+
+                    source: requested ? "image://qmlLiveDirectoryPreview/" + model.filePath : ""
 
                     fillMode: Image.PreserveAspectFit
                     sourceSize.width: slider.maximumValue
@@ -148,7 +157,7 @@ Item {
                     anchors.right: parent.right
                     anchors.bottom: parent.bottom
 
-                    text: modelData
+                    text: model.fileName
                     color: root.textColor
 
                     textFormat: Text.PlainText
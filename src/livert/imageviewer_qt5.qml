@@ -42,7 +42,67 @@ Item {
     Image {
         id: image
         anchors.centerIn: parent
-        source: imageViewerSource
+        visible: !imageViewerTiled
+        source: imageViewerTiled ? "" : imageViewerSource
+    }
+
+    // Huge images are shown tile by tile, using the level of detail matching the zoom
+    Flickable {
+        id: tiledView
+        anchors.fill: parent
+        visible: imageViewerTiled
+        interactive: visible
+        contentWidth: Math.max(width, imageViewerSize.width * zoom)
+        contentHeight: Math.max(height, imageViewerSize.height * zoom)
+        clip: true
+
+        readonly property real fitZoom: Math.min(1, width / imageViewerSize.width,
+                                                 height / imageViewerSize.height)
+        property real zoom: fitZoom
+        readonly property int level: Math.max(imageViewerFirstLevel, Math.min(imageViewerLevelCount - 1,
+                                                                               Math.floor(-Math.log(zoom) / Math.LN2)))
+        readonly property real levelScale: Math.pow(2, level)
+        readonly property real tileExtent: imageViewerTileSize * levelScale * zoom
+
+        readonly property real offsetX: Math.max(0, (width - imageViewerSize.width * zoom) / 2)
+        readonly property real offsetY: Math.max(0, (height - imageViewerSize.height * zoom) / 2)
+        readonly property int columns: Math.ceil(imageViewerSize.width / levelScale / imageViewerTileSize)
+        readonly property int rows: Math.ceil(imageViewerSize.height / levelScale / imageViewerTileSize)
+        readonly property int firstColumn: Math.max(0, Math.floor((contentX - offsetX) / tileExtent))
+        readonly property int lastColumn: Math.min(columns - 1, Math.floor((contentX - offsetX + width) / tileExtent))
+        readonly property int firstRow: Math.max(0, Math.floor((contentY - offsetY) / tileExtent))
+        readonly property int lastRow: Math.min(rows - 1, Math.floor((contentY - offsetY + height) / tileExtent))
+        readonly property int visibleColumns: Math.max(0, lastColumn - firstColumn + 1)
+
+        function zoomBy(factor) {
+            var centerX = (contentX + width / 2 - offsetX) / zoom;
+            var centerY = (contentY + height / 2 - offsetY) / zoom;
+            zoom = Math.max(fitZoom, Math.min(4, zoom * factor));
+            contentX = Math.max(0, Math.min(contentWidth - width, centerX * zoom + offsetX - width / 2));
+            contentY = Math.max(0, Math.min(contentHeight - height, centerY * zoom + offsetY - height / 2));
+        }
+
+        Repeater {
+            model: imageViewerTiled ? tiledView.visibleColumns * Math.max(0, tiledView.lastRow - tiledView.firstRow + 1) : 0
+            Image {
+                readonly property int column: tiledView.firstColumn + index % tiledView.visibleColumns
+                readonly property int row: tiledView.firstRow + Math.floor(index / tiledView.visibleColumns)
+                x: tiledView.offsetX + column * tiledView.tileExtent
+                y: tiledView.offsetY + row * tiledView.tileExtent
+                width: sourceSize.width * tiledView.levelScale * tiledView.zoom
+                height: sourceSize.height * tiledView.levelScale * tiledView.zoom
+                asynchronous: true
+                smooth: true
+                source: "image://qmlLiveTiles/" + tiledView.level + "/" + column + "/" + row + "/" + imageViewerPath
+            }
+        }
+
+        MouseArea {
+            width: tiledView.contentWidth
+            height: tiledView.contentHeight
+            acceptedButtons: Qt.NoButton
+            onWheel: tiledView.zoomBy(wheel.angleDelta.y > 0 ? 1.25 : 0.8)
+        }
     }
 
     Text {
@@ -50,6 +110,8 @@ Item {
         anchors.left: parent.left
         anchors.margins: 4
         color: '#ffffff'
-        text: image.width + "x" + image.height
+        text: imageViewerTiled
+              ? imageViewerSize.width + "x" + imageViewerSize.height + " @ " + Math.round(tiledView.zoom * 100) + "%"
+              : image.width + "x" + image.height
     }
 }
@@ -32,9 +32,226 @@
 #include "logger.h"
 #include "stdio.h"
 
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace {
+const quint32 QUEUE_CAPACITY = 4096; // must be a power of two
+const int IDLE_TIMEOUT = 100; // ms
+const int FATAL_FLUSH_TIMEOUT = 100; // ms
+
+struct LogRecord
+{
+    QtMsgType type;
+    QString message;
+    // Copied, the context of QML console messages does not outlive the handler
+    QByteArray file;
+    int line;
+    QByteArray function;
+};
+
+/*
+ * Bounded lock-free queue for many producers and a single consumer. Every slot
+ * carries a sequence number telling whether it is free for the producer claiming
+ * the position or filled for the consumer. A producer finding the queue full fails
+ * instead of waiting.
+ */
+class LogQueue
+{
+public:
+    LogQueue()
+        : m_enqueuePos(0)
+        , m_dequeuePos(0)
+    {
+        for (quint32 i = 0; i < QUEUE_CAPACITY; ++i)
+            m_slots[i].sequence.store(i);
+    }
+
+    bool enqueue(const LogRecord &record)
+    {
+        quint32 pos = m_enqueuePos.load();
+        Slot *slot;
+        forever {
+            slot = &m_slots[pos & (QUEUE_CAPACITY - 1)];
+            const qint32 diff = qint32(slot->sequence.loadAcquire() - pos);
+            if (diff == 0) {
+                if (m_enqueuePos.testAndSetRelaxed(pos, pos + 1, pos))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load();
+            }
+        }
+
+        slot->record = record;
+        slot->sequence.storeRelease(pos + 1);
+        return true;
+    }
+
+    // Consumer only
+    bool dequeue(LogRecord *record)
+    {
+        const quint32 pos = m_dequeuePos.load();
+        Slot &slot = m_slots[pos & (QUEUE_CAPACITY - 1)];
+        if (qint32(slot.sequence.loadAcquire() - (pos + 1)) < 0)
+            return false;
+
+        *record = slot.record;
+        slot.record = LogRecord();
+        slot.sequence.storeRelease(pos + QUEUE_CAPACITY);
+        m_dequeuePos.storeRelease(pos + 1);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        const quint32 pos = m_dequeuePos.loadAcquire();
+        return qint32(m_slots[pos & (QUEUE_CAPACITY - 1)].sequence.loadAcquire() - (pos + 1)) < 0;
+    }
+
+private:
+    struct Slot
+    {
+        QAtomicInteger<quint32> sequence;
+        LogRecord record;
+    };
+
+    Slot m_slots[QUEUE_CAPACITY];
+    QAtomicInteger<quint32> m_enqueuePos;
+    QAtomicInteger<quint32> m_dequeuePos;
+};
+
+} // namespace
+
+/*
+ * Formats and writes the messages queued by any thread and emits Logger::message()
+ * for them, so that threads logging do not wait for the output. Messages arriving
+ * while the queue is full are dropped and counted.
+ */
+class LoggerThread : public QThread
+{
+public:
+    explicit LoggerThread(Logger *logger)
+        : m_logger(logger)
+        , m_waiting(0)
+        , m_stop(0)
+        , m_dropped(0)
+        , m_droppedReported(0)
+    {
+        setObjectName(QStringLiteral("Logger"));
+    }
+
+    void post(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+    {
+        LogRecord record;
+        record.type = type;
+        record.message = msg;
+        record.file = QByteArray(context.file);
+        record.line = context.line;
+        record.function = QByteArray(context.function);
+
+        if (!m_queue.enqueue(record)) {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+
+        wake();
+    }
+
+    // Gives the consumer a chance to write out what was logged before a fatal error
+    void flush()
+    {
+        if (QThread::currentThread() == this || !isRunning())
+            return;
+
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_queue.isEmpty() && timer.elapsed() < FATAL_FLUSH_TIMEOUT) {
+            wake();
+            QThread::msleep(1);
+        }
+    }
+
+    void stop()
+    {
+        m_stop.storeRelease(1);
+        QMutexLocker l(&m_mutex);
+        m_wakeUp.wakeOne();
+    }
+
+    int dropped() const
+    {
+        return m_dropped.load();
+    }
+
+protected:
+    void run()
+    {
+        forever {
+            LogRecord record;
+            while (m_queue.dequeue(&record))
+                process(record);
+
+            reportDropped();
+
+            if (m_stop.loadAcquire())
+                break;
+
+            QMutexLocker l(&m_mutex);
+            m_waiting.fetchAndStoreOrdered(1);
+            if (m_queue.isEmpty() && !m_stop.loadAcquire())
+                m_wakeUp.wait(&m_mutex, IDLE_TIMEOUT);
+            m_waiting.fetchAndStoreOrdered(0);
+        }
+
+        LogRecord record;
+        while (m_queue.dequeue(&record))
+            process(record);
+    }
+
+private:
+    void wake()
+    {
+        if (m_waiting.testAndSetOrdered(1, 0)) {
+            QMutexLocker l(&m_mutex);
+            m_wakeUp.wakeOne();
+        }
+    }
+
+    void process(const LogRecord &record)
+    {
+        Logger::writeMessage(record.type, record.message, record.file.constData(), record.line,
+                             record.function.constData());
+        emit m_logger->message(record.type, record.message);
+    }
+
+    void reportDropped()
+    {
+        const int dropped = m_dropped.load();
+        if (dropped == m_droppedReported)
+            return;
+
+        const QString msg = QString::fromLatin1("Logger: %1 messages dropped").arg(dropped - m_droppedReported);
+        m_droppedReported = dropped;
+        Logger::writeMessage(QtWarningMsg, msg, "", 0, "");
+        emit m_logger->message(QtWarningMsg, msg);
+    }
+
+    Logger *m_logger;
+    LogQueue m_queue;
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+    QAtomicInt m_waiting;
+    QAtomicInt m_stop;
+    QAtomicInt m_dropped;
+    int m_droppedReported;
+};
+
 Logger *Logger::s_instance = 0;
-bool Logger::s_ignoreMesssages = false;
-QMutex Logger::m_mutex;
+QAtomicInt Logger::s_ignoreMesssages(0);
 
 /*!
  * \class Logger
@@ -44,6 +261,11 @@ QMutex Logger::m_mutex;
  * The intention is to use this class if you want to display the log into widget
  * or you want to preproccess the log messages itself before displaying it
  *
+ * Messages are queued by the logging thread and written out and emitted by a
+ * separate thread, so that logging does not slow down the threads logging. When
+ * messages arrive faster than they can be written out, the excess messages are
+ * dropped, see droppedMessages(). Fatal messages are written out synchronously.
+ *
  * \sa RemoteLogger
  */
 
@@ -51,13 +273,15 @@ QMutex Logger::m_mutex;
  * Standard constructor using \a parent as parent
  */
 Logger::Logger(QObject *parent) :
-    QObject(parent)
+    QObject(parent) ,
+    m_thread(new LoggerThread(this))
 {
     if (s_instance) {
         qFatal("Cannot create more than one Logger");
     }
     s_instance = this;
 
+    m_thread->start();
     qInstallMessageHandler(messageHandler);
 }
 
@@ -67,6 +291,21 @@ Logger::Logger(QObject *parent) :
 Logger::~Logger()
 {
     qInstallMessageHandler(0);
+
+    m_thread->stop();
+    m_thread->wait();
+    delete m_thread;
+
+    s_instance = 0;
+}
+
+/*!
+ * Returns the number of messages dropped because they arrived faster than they
+ * could be written out.
+ */
+int Logger::droppedMessages() const
+{
+    return m_thread->dropped();
 }
 
 /*!
@@ -74,8 +313,7 @@ Logger::~Logger()
  */
 void Logger::setIgnoreMessages(bool ignoreMessages)
 {
-    QMutexLocker l(&m_mutex);
-    s_ignoreMesssages = ignoreMessages;
+    s_ignoreMesssages.storeRelease(ignoreMessages ? 1 : 0);
 }
 
 void Logger::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
@@ -85,33 +323,39 @@ void Logger::messageHandler(QtMsgType type, const QMessageLogContext& context, c
         abort();
     }
 
-    {
-        QMutexLocker l(&m_mutex);
-        if (s_ignoreMesssages)
-            return;
+    // The application is going to abort, write out right now
+    if (type == QtFatalMsg) {
+        s_instance->m_thread->flush();
+        writeMessage(type, msg, context.file, context.line, context.function);
+        return;
     }
 
-    emit s_instance->message(type, msg);
+    if (s_ignoreMesssages.loadAcquire())
+        return;
 
-    // and output to stdout
+    s_instance->m_thread->post(type, context, msg);
+}
+
+void Logger::writeMessage(QtMsgType type, const QString &msg, const char *file, int line, const char *function)
+{
     QByteArray localMsg = msg.toLocal8Bit();
     switch (type) {
     case QtDebugMsg:
-        fprintf(stderr, "Debug: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
+        fprintf(stderr, "Debug: %s (%s:%u, %s)\n", localMsg.constData(), file, line, function);
         break;
 #if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
     case QtInfoMsg:
-        fprintf(stderr, "Info: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
+        fprintf(stderr, "Info: %s (%s:%u, %s)\n", localMsg.constData(), file, line, function);
         break;
 #endif
     case QtWarningMsg:
-        fprintf(stderr, "Warning: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
+        fprintf(stderr, "Warning: %s (%s:%u, %s)\n", localMsg.constData(), file, line, function);
         break;
     case QtCriticalMsg:
-        fprintf(stderr, "Critical: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
+        fprintf(stderr, "Critical: %s (%s:%u, %s)\n", localMsg.constData(), file, line, function);
         break;
     case QtFatalMsg:
-        fprintf(stderr, "Fatal: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
+        fprintf(stderr, "Fatal: %s (%s:%u, %s)\n", localMsg.constData(), file, line, function);
     }
 }
 
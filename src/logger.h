@@ -32,11 +32,13 @@
 #pragma once
 
 #include <QObject>
-#include <QMutex>
+#include <QAtomicInt>
 #include <QUrl>
 
 #include "qmllive_global.h"
 
+class LoggerThread;
+
 class QMLLIVESHARED_EXPORT Logger : public QObject
 {
     Q_OBJECT
@@ -45,6 +47,8 @@ public:
     explicit Logger(QObject *parent = 0);
     virtual ~Logger();
 
+    int droppedMessages() const;
+
 public Q_SLOTS:
     static void setIgnoreMessages(bool ignoreMessages);
 
@@ -52,10 +56,13 @@ Q_SIGNALS:
     void message(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
 
 private:
+    friend class LoggerThread;
+
     static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    static void writeMessage(QtMsgType type, const QString &msg, const char *file, int line, const char *function);
 
     static Logger *s_instance;
-    static bool s_ignoreMesssages;
+    static QAtomicInt s_ignoreMesssages;
 
-    static QMutex m_mutex;
+    LoggerThread *m_thread;
 };
@@ -33,12 +33,18 @@
 #include <QStringList>
 #include <QUrl>
 #include "logreceiver.h"
+#include "ipc/logdatagram.h"
 
 /*!
  * \class LogReceiver
  * \brief Connects to a port and waits for log messages sent via udp
  * \inmodule qmllive
  *
+ * Datagrams lost or received out of order are counted, see lostDatagrams() and
+ * reorderedDatagrams(). A warning message is emitted when datagrams were lost.
+ * Datagrams in the format of older senders, carrying a single message each, are
+ * understood as well.
+ *
  * \sa Logger, RemoteLogger
  */
 
@@ -47,7 +53,9 @@
  */
 LogReceiver::LogReceiver(QObject *parent) :
     QObject(parent),
-    m_socket(new QUdpSocket(this))
+    m_socket(new QUdpSocket(this)),
+    m_lostDatagrams(0),
+    m_reorderedDatagrams(0)
 {
     setPort(45454);
     connect(m_socket, &QAbstractSocket::readyRead, this, &LogReceiver::processPendingDatagrams);
@@ -94,6 +102,22 @@ QString LogReceiver::address() const
     return m_address.toString();
 }
 
+/*!
+ * The number of datagrams which did not arrive so far
+ */
+int LogReceiver::lostDatagrams() const
+{
+    return m_lostDatagrams;
+}
+
+/*!
+ * The number of datagrams which arrived later than datagrams sent after them
+ */
+int LogReceiver::reorderedDatagrams() const
+{
+    return m_reorderedDatagrams;
+}
+
 void LogReceiver::processPendingDatagrams()
 {
     while (m_socket->hasPendingDatagrams()) {
@@ -101,16 +125,46 @@ void LogReceiver::processPendingDatagrams()
         datagram.resize(m_socket->pendingDatagramSize());
         m_socket->readDatagram(datagram.data(), datagram.size());
 
-        QStringList data = QString::fromUtf8(datagram).split("%%%");
-        if (data.count() != 5) {
-            qWarning("Invalid Log package received");
-            return;
+        LogDatagram batch;
+        if (!batch.decode(datagram)) {
+            if (!processLegacyDatagram(datagram))
+                qWarning("Invalid Log package received");
+            continue;
+        }
+
+        QHash<quint32, quint32>::iterator next = m_nextSequence.find(batch.session);
+        if (next == m_nextSequence.end())
+            next = m_nextSequence.insert(batch.session, batch.sequence);
+
+        const qint32 gap = qint32(batch.sequence - next.value());
+        if (gap > 0) {
+            m_lostDatagrams += gap;
+            emit message(QtWarningMsg, QString::fromLatin1("LogReceiver: %1 log datagrams lost").arg(gap),
+                         QUrl(), -1, -1);
+        } else if (gap < 0) {
+            // Counted as lost before
+            ++m_reorderedDatagrams;
+            if (m_lostDatagrams > 0)
+                --m_lostDatagrams;
         }
+        if (gap >= 0)
+            next.value() = batch.sequence + 1;
 
-        emit message(data.at(0).toInt(), data.at(1), QUrl(data.at(2)) ,data.at(3).toInt(), data.at(4).toInt());
+        foreach (const LogDatagram::Record &record, batch.records)
+            emit message(record.type, record.message, record.url, record.line, record.column);
     }
 }
 
+bool LogReceiver::processLegacyDatagram(const QByteArray &datagram)
+{
+    QStringList data = QString::fromUtf8(datagram).split("%%%");
+    if (data.count() != 5)
+        return false;
+
+    emit message(data.at(0).toInt(), data.at(1), QUrl(data.at(2)) ,data.at(3).toInt(), data.at(4).toInt());
+    return true;
+}
+
 
 /*!
   \fn LogReceiver::message(int type, const QString &msg, const QUrl &url, int line, int column)
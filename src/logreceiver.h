@@ -32,6 +32,7 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
 #include <QUrl>
 #include <QHostAddress>
 
@@ -48,6 +49,9 @@ public:
     int port() const;
     QString address() const;
 
+    int lostDatagrams() const;
+    int reorderedDatagrams() const;
+
 public Q_SLOTS:
     void setPort(int port);
     void setAddress(const QString& address);
@@ -60,7 +64,14 @@ private Q_SLOTS:
     void processPendingDatagrams();
 
 private:
+    bool processLegacyDatagram(const QByteArray &datagram);
+
     QUdpSocket* m_socket;
     QHostAddress m_address;
     int m_port;
+
+    // Next sequence number expected per sender session
+    QHash<quint32, quint32> m_nextSequence;
+    int m_lostDatagrams;
+    int m_reorderedDatagrams;
 };
@@ -44,17 +44,51 @@
 #include <QLocalSocket>
 #include <QDebug>
 #include <QTextStream>
+#include <QTimer>
+#include <QSharedMemory>
 
 #include "../qmllive_version.h"
+#include "previewprotocol.h"
 
-void handlePreview(QLocalSocket *socket);
+Q_DECLARE_LOGGING_CATEGORY(pg)
+Q_LOGGING_CATEGORY(pg, "PreviewGenerator", QtInfoMsg)
+
+namespace {
+// The engine is recreated after this many previews so that state leaking from
+// previewed documents, e.g. singletons, does not accumulate forever
+const int ENGINE_RECYCLE_COUNT = 100;
+}
+
+class PreviewGenerator
+{
+public:
+    PreviewGenerator()
+        : m_engine(0)
+        , m_previewCount(0)
+    {
+    }
+
+    ~PreviewGenerator()
+    {
+        delete m_engine;
+    }
+
+    QImage preview(const QString &path, const QSize &expectedSize);
+
+private:
+    QQmlEngine *engine();
+
+    QQmlEngine *m_engine;
+    int m_previewCount;
+};
 
 class PreviewServer : public QObject
 {
     Q_OBJECT
 public:
     PreviewServer()
-        : m_server(new QLocalServer())
+        : m_server(new QLocalServer(this))
+        , m_busy(false)
     {
         connect(m_server, &QLocalServer::newConnection, this, &PreviewServer::onNewConnection);
     }
@@ -73,10 +107,12 @@ public:
         if (userName.isEmpty())
             qWarning("Failed to determine system user name");
 
-        QString serverName = QString::fromLatin1("%1.%2-%3")
+        // Several generators run at once, one per worker of the bench
+        QString serverName = QString::fromLatin1("%1.%2-%3-%4")
             .arg(qApp->organizationDomain().isEmpty() ? qApp->organizationName() : qApp->organizationDomain())
             .arg(qApp->applicationName())
-            .arg(userName);
+            .arg(userName)
+            .arg(QCoreApplication::applicationPid());
 
         QLocalServer::removeServer(serverName);
         return m_server->listen(serverName);
@@ -97,19 +133,119 @@ protected slots:
     {
         while (m_server->hasPendingConnections()) {
             QLocalSocket *socket = m_server->nextPendingConnection();
+            connect(socket, &QLocalSocket::readyRead, this, &PreviewServer::onReadyRead);
+            connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
 
-            handlePreview(socket);
+    void onReadyRead()
+    {
+        QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+
+        QByteArray frame;
+        while (PreviewProtocol::readFrame(socket, &frame)) {
+            QDataStream ds(frame);
+            quint8 type;
+            Request request;
+            ds >> type >> request.id;
+
+            if (type == PreviewProtocol::Preview) {
+                ds >> request.expectedSize >> request.path >> request.segmentKey;
+                request.socket = socket;
+                qCDebug(pg) << "Received" << request.id << request.expectedSize << request.path;
+                m_queue.append(request);
+            } else if (type == PreviewProtocol::Cancel) {
+                for (int i = 0; i < m_queue.count(); ++i) {
+                    if (m_queue.at(i).socket == socket && m_queue.at(i).id == request.id) {
+                        qCDebug(pg) << "Canceled" << request.id;
+                        m_queue.removeAt(i);
+                        // Still answer so the bench can forget the request
+                        sendImage(socket, request.id, QString(), QImage());
+                        break;
+                    }
+                }
+            }
+        }
+
+        scheduleNext();
+    }
 
-            delete socket;
+    void processNext()
+    {
+        // Grabbing spins a nested event loop, new requests are queued meanwhile
+        if (m_busy || m_queue.isEmpty())
+            return;
+
+        Request request = m_queue.takeFirst();
+        if (!request.socket) {
+            scheduleNext();
+            return;
         }
+
+        m_busy = true;
+        const QImage image = m_generator.preview(request.path, request.expectedSize);
+        m_busy = false;
+
+        if (request.socket)
+            sendImage(request.socket, request.id, request.segmentKey, image);
+
+        scheduleNext();
     }
+
 private:
+    struct Request
+    {
+        QPointer<QLocalSocket> socket;
+        quint32 id = 0;
+        QSize expectedSize;
+        QString path;
+        QString segmentKey;
+    };
+
+    void scheduleNext()
+    {
+        if (!m_busy && !m_queue.isEmpty())
+            QTimer::singleShot(0, this, SLOT(processNext()));
+    }
+
+    void sendImage(QLocalSocket *socket, quint32 id, const QString &segmentKey, QImage image)
+    {
+        QByteArray frame;
+        QDataStream ds(&frame, QIODevice::WriteOnly);
+        ds << id;
+
+        if (image.isNull()) {
+            ds << quint8(PreviewProtocol::NoImage);
+        } else {
+            if (image.depth() != 32)
+                image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            // Pass the raw pixels through the segment to save encoding and decoding
+            QSharedMemory segment(segmentKey);
+            if (!segmentKey.isEmpty() && segment.attach()
+                    && segment.size() >= image.height() * image.bytesPerLine()) {
+                char *to = static_cast<char *>(segment.data());
+                for (int y = 0; y < image.height(); ++y)
+                    memcpy(to + y * image.bytesPerLine(), image.constScanLine(y), image.bytesPerLine());
+                ds << quint8(PreviewProtocol::SharedMemory) << image.size()
+                   << qint32(image.bytesPerLine()) << qint32(image.format());
+            } else {
+                qCDebug(pg) << "Cannot use shared memory segment" << segmentKey << segment.errorString();
+                ds << quint8(PreviewProtocol::Inline) << image;
+            }
+        }
+
+        PreviewProtocol::writeFrame(socket, frame);
+        socket->flush();
+        qCDebug(pg) << "Sent" << id;
+    }
+
     QLocalServer *m_server;
+    PreviewGenerator m_generator;
+    QList<Request> m_queue;
+    bool m_busy;
 };
 
-Q_DECLARE_LOGGING_CATEGORY(pg)
-Q_LOGGING_CATEGORY(pg, "PreviewGenerator", QtInfoMsg)
-
 int main (int argc, char** argv)
 {
     QGuiApplication::setApplicationName("QmlLivePreviewGenerator");
@@ -134,30 +270,35 @@ int main (int argc, char** argv)
     return app.exec();
 }
 
-void handlePreview(QLocalSocket *socket)
+QQmlEngine *PreviewGenerator::engine()
 {
-    qCDebug(pg) << "Waiting on input";
-
-    socket->waitForReadyRead();
-
-    QDataStream ds (socket);
-    QSize expectedSize;
-    QString path;
+    if (m_engine && m_previewCount >= ENGINE_RECYCLE_COUNT) {
+        delete m_engine;
+        m_engine = 0;
+    }
 
-    ds >> expectedSize >> path;
+    if (!m_engine) {
+        m_engine = new QQmlEngine;
+        m_engine->setOutputWarningsToStandardError(false);
+        QObject::connect(m_engine, &QQmlEngine::warnings, [](const QList<QQmlError> &warnings) {
+            foreach (const QQmlError &warning, warnings) {
+                qCWarning(pg) << warning;
+            }
+        });
+        m_previewCount = 0;
+    }
 
-    qCDebug(pg) << "Received" << expectedSize << path;
+    ++m_previewCount;
+    return m_engine;
+}
 
-    QQmlEngine engine;
+QImage PreviewGenerator::preview(const QString &path, const QSize &expectedSize)
+{
+    QQmlEngine *engine = this->engine();
 
-    engine.setOutputWarningsToStandardError(false);
-    QObject::connect(&engine, &QQmlEngine::warnings, [](const QList<QQmlError> &warnings) {
-        foreach (const QQmlError &warning, warnings) {
-            qCWarning(pg) << warning;
-        }
-    });
+    QImage image;
 
-    QPointer<QQmlComponent> component = new QQmlComponent(&engine, QUrl::fromLocalFile(path));
+    QPointer<QQmlComponent> component = new QQmlComponent(engine, QUrl::fromLocalFile(path));
     QPointer<QObject> object = component->create();
 
     QQuickWindow *window = 0;
@@ -179,7 +320,7 @@ void handlePreview(QLocalSocket *socket)
             qCWarning(pg) << "Window has no child item:" << path;
         }
     } else if ((item = qobject_cast<QQuickItem *>(object.data()))) {
-        QQuickView *view = new QQuickView(&engine, 0);
+        QQuickView *view = new QQuickView(engine, 0);
         view->setContent(QUrl::fromLocalFile(path), component, object);
         window = view;
     } else {
@@ -200,11 +341,9 @@ void handlePreview(QLocalSocket *socket)
             QEventLoop loop;
             QObject::connect(result.data(), &QQuickItemGrabResult::ready, &loop, &QEventLoop::quit);
             loop.exec();
-            QImage image = result->image();
+            image = result->image();
             if (!image.isNull()) {
                 image = image.scaled(expectedSize, Qt::KeepAspectRatio);
-                image.save(socket, "PNG");
-                qCDebug(pg) << "Sending image";
             } else {
                 qCWarning(pg) << "Grabbed a null image for" << path;
             }
@@ -217,10 +356,11 @@ void handlePreview(QLocalSocket *socket)
     delete object;
     delete component;
 
-    socket->write("\nEND");
-    socket->flush();
+    // Keep imports and shared components compiled, drop the previewed document so
+    // that it is loaded again when it changes
+    engine->trimComponentCache();
 
-    qCDebug(pg) << "Sent END and flushed";
+    return image;
 }
 
 
@@ -16,3 +16,6 @@ QT = gui core quick
 
 SOURCES += \
     main.cpp
+
+HEADERS += \
+    previewprotocol.h
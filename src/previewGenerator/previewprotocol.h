@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+
+// Messages exchanged between QmlLive Bench and previewGenerator over a local socket.
+//
+// Each message is a frame: quint32 size followed by size bytes serialized with
+// QDataStream. The bench sends
+//
+//   quint8 Preview, quint32 id, QSize requestedSize, QString path, QString segmentKey
+//   quint8 Cancel, quint32 id
+//
+// and the generator answers every Preview it did not drop on Cancel with
+//
+//   quint32 id, quint8 transport
+//
+// followed for SharedMemory by
+//
+//   QSize size, qint32 bytesPerLine, qint32 format
+//
+// describing the raw pixels written to the start of the shared memory segment the
+// bench created for the request under segmentKey, or for Inline by
+//
+//   QImage image
+//
+// which is used when the segment is missing or too small. Requests are answered in
+// order.
+namespace PreviewProtocol {
+
+enum MessageType {
+    Preview = 0,
+    Cancel = 1
+};
+
+enum Transport {
+    NoImage = 0,
+    SharedMemory = 1,
+    Inline = 2
+};
+
+inline void writeFrame(QIODevice *device, const QByteArray &frame)
+{
+    QByteArray header;
+    QDataStream(&header, QIODevice::WriteOnly) << quint32(frame.size());
+    device->write(header);
+    device->write(frame);
+}
+
+inline bool readFrame(QIODevice *device, QByteArray *frame)
+{
+    if (device->bytesAvailable() < qint64(sizeof(quint32)))
+        return false;
+
+    quint32 size;
+    QDataStream(device->peek(sizeof(quint32))) >> size;
+    if (device->bytesAvailable() < qint64(sizeof(quint32) + size))
+        return false;
+
+    device->read(sizeof(quint32));
+    *frame = device->read(size);
+    return true;
+}
+
+} // namespace PreviewProtocol
@@ -32,11 +32,21 @@
 #include <QUdpSocket>
 #include "remotelogger.h"
 
+namespace {
+// Messages logged within this interval are sent in one datagram
+const int FLUSH_INTERVAL = 10; // ms
+}
+
 /*!
  * \class RemoteLogger
  * \brief Installs a qt messageHandler and sends the logs over udp
  * \inmodule qmllive
  *
+ * Messages are packed into numbered datagrams, each carrying as many messages
+ * as logged within a short interval, so that a LogReceiver can tell about lost
+ * datagrams. Messages too long for a single datagram are split into several
+ * ones.
+ *
  * \sa Logger, LogReceiver
  */
 
@@ -46,11 +56,28 @@
 RemoteLogger::RemoteLogger(QObject *parent) :
     Logger(parent) ,
     m_socket(new QUdpSocket(this)) ,
-    m_port(45454)
+    m_port(45454) ,
+    m_batchSize(LogDatagram::headerSize()) ,
+    m_flushTimer(new QTimer(this)) ,
+    m_droppedRecords(0)
 {
+    m_batch.session = QUuid::createUuid().data1;
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(m_flushTimer, &QTimer::timeout, this, &RemoteLogger::flush);
+
     connect(this, &Logger::message, this, &RemoteLogger::broadcast);
 }
 
+/*!
+ * Standard destructor, sends the messages not sent yet
+ */
+RemoteLogger::~RemoteLogger()
+{
+    flush();
+}
+
 /*!
  * Sets the \a address where the log messages will be sent to
  * \sa setPort()
@@ -77,13 +104,78 @@ void RemoteLogger::setPort(int port)
  */
 void RemoteLogger::broadcast(int type, const QString &msg, const QUrl &url, int line, int column)
 {
-    QByteArray datagram;
-    QStringList data;
-    data << QString::number(type) << msg << url.toString() << QString::number(line) << QString::number(column);
+    LogDatagram::Record record;
+    record.type = type;
+    record.message = msg;
+    record.url = url;
+    record.line = line;
+    record.column = column;
+
+    const int available = LogDatagram::MaximumSize - LogDatagram::headerSize();
+    if (LogDatagram::recordSize(record) <= available) {
+        append(record);
+        return;
+    }
+
+    // Split into records of their own, each filling a datagram
+    LogDatagram::Record part = record;
+    part.message.clear();
+    if (LogDatagram::recordSize(part) > available) {
+        part.url.clear();
+        ++m_droppedRecords;
+    }
+
+    const int maximumLength = (available - LogDatagram::recordSize(part)) / 2;
+    int i = 0;
+    do {
+        int length = qMin(maximumLength, msg.size() - i);
+        if (i + length < msg.size() && msg.at(i + length - 1).isHighSurrogate())
+            --length;
+        part.message = msg.mid(i, length);
+        append(part);
+        i += length;
+    } while (i < msg.size());
+}
+
+void RemoteLogger::append(const LogDatagram::Record &record)
+{
+    const int size = LogDatagram::recordSize(record);
+    if (!m_batch.records.isEmpty() && m_batchSize + size > LogDatagram::MaximumSize)
+        flush();
+
+    m_batch.records.append(record);
+    m_batchSize += size;
+
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
+}
+
+/*!
+ * Returns the number of records which could not be sent, either at all or with
+ * their location, since this logger was created.
+ */
+int RemoteLogger::droppedRecords() const
+{
+    return m_droppedRecords;
+}
+
+/*!
+ * Sends the messages collected so far in one datagram.
+ */
+void RemoteLogger::flush()
+{
+    m_flushTimer->stop();
+
+    if (m_batch.records.isEmpty())
+        return;
+
+    const QByteArray datagram = m_batch.encode();
+    if (m_socket->writeDatagram(datagram, m_host, m_port) == -1)
+        m_droppedRecords += m_batch.records.count();
 
-    datagram = data.join("%%%").toUtf8();
-    m_socket->writeDatagram(datagram.data(), datagram.size(),
-                            m_host, m_port);
+    ++m_batch.sequence;
+    m_batch.records.clear();
+    m_batchSize = LogDatagram::headerSize();
 }
 
 /*!
@@ -36,6 +36,7 @@
 #include <QtQuick>
 
 #include "qmllive_global.h"
+#include "ipc/logdatagram.h"
 
 QT_FORWARD_DECLARE_CLASS(QUdpSocket);
 
@@ -45,6 +46,9 @@ class QMLLIVESHARED_EXPORT RemoteLogger : public Logger
 
 public:
     explicit RemoteLogger(QObject *parent = 0);
+    ~RemoteLogger();
+
+    int droppedRecords() const;
 
 public Q_SLOTS:
     void setHostAddress(const QHostAddress &address);
@@ -53,9 +57,17 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void broadcast(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
+    void flush();
 
 private:
+    void append(const LogDatagram::Record &record);
+
     QUdpSocket* m_socket;
     int m_port;
     QHostAddress m_host;
+
+    LogDatagram m_batch;
+    int m_batchSize;
+    QTimer *m_flushTimer;
+    int m_droppedRecords;
 };
@@ -89,7 +89,9 @@ void RemotePublisher::registerHub(LiveHubEngine *hub)
         disconnect(m_hub);
     }
     m_hub = hub;
+    setPayloadSource(hub);
     connect(hub, &LiveHubEngine::activateDocument, this, &RemotePublisher::activateDocument);
+    connect(hub, &LiveHubEngine::prefetchDocuments, this, &RemotePublisher::prefetchDocuments);
     connect(hub, &LiveHubEngine::fileChanged, this, &RemotePublisher::sendDocument);
     connect(hub, &LiveHubEngine::publishFile, this, &RemotePublisher::sendDocument);
     connect(this, &RemotePublisher::needsPublishWorkspace, hub, &LiveHubEngine::publishWorkspace);
@@ -97,6 +99,20 @@ void RemotePublisher::registerHub(LiveHubEngine *hub)
     connect(hub, &LiveHubEngine::endPublishWorkspace, this, &RemotePublisher::endBulkSend);
 }
 
+/*!
+ * Use \a hub to obtain the content of published documents.
+ *
+ * The hub reads and serializes each changed document once, no matter how many
+ * publishers send it. Without a payload source, documents are read from the workspace
+ * set with setWorkspace().
+ *
+ * \sa LiveHubEngine::documentPayload()
+ */
+void RemotePublisher::setPayloadSource(LiveHubEngine *hub)
+{
+    m_payloadSource = hub;
+}
+
 /*!
  * Sets the current workspace to \a path. Documents location will be adjusted based on
  * this workspace path.
@@ -120,7 +136,7 @@ void RemotePublisher::connectToServer(const QString &hostName, int port)
  */
 QString RemotePublisher::errorToString(QAbstractSocket::SocketError error)
 {
-    return m_ipc->errorToString(error);
+    return IpcClient::errorToString(error);
 }
 
 /*!
@@ -144,6 +160,29 @@ QUuid RemotePublisher::activateDocument(const LiveDocument &document)
     return m_ipc->send("activateDocument(QString)", bytes);
 }
 
+/*!
+ * Sends "reloadDocument()" via IPC, making the node reload the active document even
+ * if it did not change.
+ */
+QUuid RemotePublisher::reloadDocument()
+{
+    DEBUG << "RemotePublisher::reloadDocument";
+    return m_ipc->send("reloadDocument()", QByteArray());
+}
+
+/*!
+ * Sends "prefetchDocuments(QStringList)" via IPC, suggesting the node to prepare the
+ * \a documents likely to be activated next.
+ */
+QUuid RemotePublisher::prefetchDocuments(const QStringList &documents)
+{
+    DEBUG << "RemotePublisher::prefetchDocuments" << documents;
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << documents;
+    return m_ipc->send("prefetchDocuments(QStringList)", bytes);
+}
+
 /*!
  * Sends "beginBulkSend()" via IPC.
  */
@@ -227,12 +266,65 @@ QUuid RemotePublisher::initComplete()
     return m_ipc->send("initComplete()", QByteArray());
 }
 
+/*!
+  Asks the node to receive documents sent to the multicast group \a address and
+  \a port by the MulticastSender \a session, starting with the datagram
+  \a firstSequence. Only datagrams authenticated with the session \a key are
+  accepted. The node answers with multicastJoined().
+
+  \sa RemoteReceiver::AcceptMulticast
+ */
+QUuid RemotePublisher::joinMulticast(const QString &address, quint16 port, quint32 session,
+                                     const QByteArray &key, quint32 firstSequence)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << address;
+    out << port;
+    out << session;
+    out << key;
+    out << firstSequence;
+    return m_ipc->send("joinMulticast(QString,quint16,quint32,QByteArray,quint32)", bytes);
+}
+
+/*!
+  Asks the node to process further calls only after all multicast datagrams up to
+  \a sequence have been received.
+ */
+QUuid RemotePublisher::multicastBarrier(quint32 sequence)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << sequence;
+    return m_ipc->send("multicastBarrier(quint32)", bytes);
+}
+
+/*!
+  Tells the node to stop waiting for multicast datagrams up to \a sequence, which
+  cannot be sent again.
+ */
+QUuid RemotePublisher::abandonMulticast(quint32 sequence)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << sequence;
+    return m_ipc->send("multicastAbandon(quint32)", bytes);
+}
+
 /*!
   Sends the \e sendWholeDocument with \a document as argument via IPC
  */
 QUuid RemotePublisher::sendWholeDocument(const LiveDocument& document)
 {
     DEBUG << "RemotePublisher::sendWholeDocument" << document;
+
+    if (m_payloadSource) {
+        const QByteArray bytes = m_payloadSource->documentPayload(document);
+        if (bytes.isEmpty())
+            return QUuid();
+        return m_ipc->send("sendDocument(QString,QByteArray)", bytes);
+    }
+
     QFile file(document.absoluteFilePathIn(m_workspace));
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "ERROR: can't open file: " << document;
@@ -282,8 +374,15 @@ void RemotePublisher::handleCall(const QString &method, const QByteArray &conten
     } else if (method == "pinOK(bool)") {
         qDebug() << "pinOk" << content.toInt();
         emit pinOk(content.toInt());
+    } else if (method == "needsPublishWorkspace(QByteArray)") {
+        QByteArray manifestHash;
+        QDataStream in(content);
+        in >> manifestHash;
+        emit needsPublishWorkspace();
+        emit needsPublishWorkspaceWithHash(manifestHash);
     } else if (method == "needsPublishWorkspace()") {
         emit needsPublishWorkspace();
+        emit needsPublishWorkspaceWithHash(QByteArray());
     } else if (method == "qmlLog(QtMsgType, QString, QUrl, int, int)") {
         int msgType;
         QString description;
@@ -301,6 +400,15 @@ void RemotePublisher::handleCall(const QString &method, const QByteArray &conten
         emit remoteLog(msgType, description, url, line, column);
     } else if (method == "clearLog()") {
         emit clearLog();
+    } else if (method == "multicastJoined(bool)") {
+        emit multicastJoined(content.toInt());
+    } else if (method == "multicastNack(QList<quint32>)") {
+        QList<quint32> sequences;
+
+        QDataStream in(content);
+        in >> sequences;
+
+        emit multicastNack(sequences);
     } else if (method == "activeDocumentChanged(QString)") {
         QString path;
 
@@ -336,6 +444,20 @@ void RemotePublisher::handleCall(const QString &method, const QByteArray &conten
  * with \a ok to indicate a valid pin
 */
 
+/*!
+ * \fn RemotePublisher::multicastJoined(bool ok)
+ *
+ * The signal is emitted after receiving the multicastJoined IPC call
+ * with \a ok to indicate whether the node receives multicast documents now.
+ */
+
+/*!
+ * \fn RemotePublisher::multicastNack(const QList<quint32> &sequences)
+ *
+ * The signal is emitted after receiving the multicastNack IPC call, to indicate
+ * the node misses the multicast datagrams identified by \a sequences.
+ */
+
 /*!
  * \fn RemotePublisher::connectionError(QAbstractSocket::SocketError error)
  *
@@ -368,6 +490,18 @@ void RemotePublisher::handleCall(const QString &method, const QByteArray &conten
  *
  * The signal is emitted after receiving the needsPublishWorkspace IPC call,
  * to indicate the client asks for (re)sending all workspace documents.
+ *
+ * \sa needsPublishWorkspaceWithHash()
+ */
+
+/*!
+ * \fn RemotePublisher::needsPublishWorkspaceWithHash(const QByteArray &manifestHash)
+ *
+ * The signal is emitted together with needsPublishWorkspace(), to let the
+ * publisher skip publishing when the client has the workspace already.
+ *
+ * The \a manifestHash describes the workspace content the client has already,
+ * see LiveHubEngine::requestManifestHash(). It is empty if unknown.
  */
 
 /*!
@@ -50,6 +50,7 @@ public:
     QAbstractSocket::SocketState state() const;
 
     void registerHub(LiveHubEngine *hub);
+    void setPayloadSource(LiveHubEngine *hub);
 Q_SIGNALS:
     void connected();
     void disconnected();
@@ -58,8 +59,11 @@ Q_SIGNALS:
     void connectionError(QAbstractSocket::SocketError error);
     void needsPinAuthentication();
     void needsPublishWorkspace();
+    void needsPublishWorkspaceWithHash(const QByteArray &manifestHash);
     void activeDocumentChanged(const LiveDocument &document);
     void pinOk(bool ok);
+    void multicastJoined(bool ok);
+    void multicastNack(const QList<quint32> &sequences);
     void remoteLog(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
     void clearLog();
 
@@ -67,6 +71,8 @@ public Q_SLOTS:
     void setWorkspace(const QString &path);
     void disconnectFromServer();
     QUuid activateDocument(const LiveDocument& document);
+    QUuid reloadDocument();
+    QUuid prefetchDocuments(const QStringList &documents);
     QUuid beginBulkSend();
     QUuid endBulkSend();
     QUuid sendDocument(const LiveDocument& document);
@@ -75,6 +81,10 @@ public Q_SLOTS:
     QUuid setYOffset(int offset);
     QUuid setRotation(int rotation);
     QUuid initComplete();
+    QUuid joinMulticast(const QString &address, quint16 port, quint32 session, const QByteArray &key,
+                        quint32 firstSequence);
+    QUuid multicastBarrier(quint32 sequence);
+    QUuid abandonMulticast(quint32 sequence);
 
 private Q_SLOTS:
     void handleCall(const QString &method, const QByteArray &content);
@@ -86,6 +96,7 @@ private Q_SLOTS:
 private:
     IpcClient *m_ipc;
     LiveHubEngine *m_hub;
+    QPointer<LiveHubEngine> m_payloadSource;
     QDir m_workspace;
 
     QHash<QUuid, QString> m_packageHash;
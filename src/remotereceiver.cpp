@@ -32,7 +32,9 @@
 #include "remotereceiver.h"
 #include "ipc/ipcserver.h"
 #include "ipc/ipcclient.h"
+#include "ipc/multicastreceiver.h"
 #include "livenodeengine.h"
+#include "workspacemanifest.h"
 
 #include <QTcpSocket>
 
@@ -42,6 +44,10 @@
 #define DEBUG if (0) qDebug()
 #endif
 
+namespace {
+const int MULTICAST_STALL_TIMEOUT = 10000;
+}
+
 
 /*!
  * \class RemoteReceiver
@@ -66,6 +72,11 @@
  *        Call to \l listen() will block until a connection from remote publisher
  *        is open and (optional) PIN exchange and (optional) initial documents
  *        update finishes.
+ * \value AcceptMulticast
+ *        The remote publisher may distribute documents to many nodes at once
+ *        using UDP multicast. Missing datagrams are requested over the
+ *        connection to the remote publisher. If they cannot be recovered, the
+ *        remote publisher is asked to publish the workspace again.
  *
  * \sa listen()
  */
@@ -77,13 +88,22 @@ RemoteReceiver::RemoteReceiver(QObject *parent)
     : QObject(parent)
     , m_server(new IpcServer(this))
     , m_node(0)
+    , m_manifest(0)
     , m_connectionAcknowledged(false)
     , m_socket(0)
     , m_client(0)
     , m_bulkUpdateInProgress(false)
     , m_updateDocumentsOnConnectState(UpdateNotStarted)
     , m_logSentPosition(0)
+    , m_multicast(0)
+    , m_multicastStallTimer(new QTimer(this))
+    , m_multicastBarrierPending(false)
+    , m_multicastBarrier(0)
 {
+    m_multicastStallTimer->setInterval(MULTICAST_STALL_TIMEOUT);
+    m_multicastStallTimer->setSingleShot(true);
+    connect(m_multicastStallTimer, &QTimer::timeout, this, &RemoteReceiver::onMulticastStalled);
+
     void (IpcServer::*IpcServer__clientConnected_socket)(QTcpSocket*) = &IpcServer::clientConnected;
     void (IpcServer::*IpcServer__clientConnected_address)(const QHostAddress &) = &IpcServer::clientConnected;
     void (IpcServer::*IpcServer__clientDisconnected_address)(const QHostAddress &) = &IpcServer::clientDisconnected;
@@ -161,6 +181,19 @@ QString RemoteReceiver::pin() const
     return m_pin;
 }
 
+/*!
+ * Sets the \a manifest of the workspace content the live node holds.
+ *
+ * When asking for the workspace with UpdateDocumentsOnConnect, the hash of the
+ * manifest is passed to the remote publisher, which may skip publishing documents
+ * the node has already. The \a manifest must be kept up to date with the documents
+ * the node stored, see LiveNodeEngine::documentUpdated().
+ */
+void RemoteReceiver::setWorkspaceManifest(const WorkspaceManifest *manifest)
+{
+    m_manifest = manifest;
+}
+
 /*!
  * Set maximum allowed client connection to \a max
  */
@@ -197,7 +230,35 @@ void RemoteReceiver::handleCall(const QString &method, const QByteArray &content
         return;
     }
 
-    if (method == "setXOffset(int)") {
+    if (method == "joinMulticast(QString,quint16,quint32,QByteArray,quint32)") {
+        joinMulticast(content);
+        return;
+    } else if (method == "multicastAbandon(quint32)") {
+        quint32 sequence;
+        QDataStream in(content);
+        in >> sequence;
+        if (m_multicast)
+            m_multicast->skipTo(sequence + 1);
+        return;
+    }
+
+    // Keep the order with documents still arriving by multicast
+    if (m_multicastBarrierPending) {
+        m_deferredCalls.append(qMakePair(method, content));
+        return;
+    }
+
+    if (method == "multicastBarrier(quint32)") {
+        quint32 sequence;
+        QDataStream in(content);
+        in >> sequence;
+        if (m_multicast && m_multicast->isJoined() && m_multicast->nextSequence() <= sequence) {
+            DEBUG << "Waiting for multicast datagrams up to" << sequence;
+            m_multicastBarrier = sequence;
+            m_multicastBarrierPending = true;
+            m_multicastStallTimer->start();
+        }
+    } else if (method == "setXOffset(int)") {
         int offset;
         QDataStream in(content);
         in >> offset;
@@ -246,6 +307,13 @@ void RemoteReceiver::handleCall(const QString &method, const QByteArray &content
         in >> document;
         qDebug() << "\tactivate document: " << document;
         emit activateDocument(LiveDocument(document));
+    } else if (method == "reloadDocument()") {
+        emit reload();
+    } else if (method == "prefetchDocuments(QStringList)") {
+        QStringList documents;
+        QDataStream in(content);
+        in >> documents;
+        emit prefetchDocuments(documents);
     } else if (method == "ping()") {
         if (m_client)
             m_client->send("pong()", QByteArray());
@@ -265,6 +333,8 @@ void RemoteReceiver::registerNode(LiveNodeEngine *node)
     connect(m_node, &LiveNodeEngine::clearLog, this, &RemoteReceiver::clearLog);
     connect(m_node, &LiveNodeEngine::activeDocumentChanged, this, &RemoteReceiver::onActiveDocumentChanged);
     connect(this, &RemoteReceiver::activateDocument, m_node, &LiveNodeEngine::loadDocument);
+    connect(this, &RemoteReceiver::reload, m_node, &LiveNodeEngine::reloadDocument);
+    connect(this, &RemoteReceiver::prefetchDocuments, m_node, &LiveNodeEngine::prefetchDocuments);
     connect(this, &RemoteReceiver::updateDocument, m_node, &LiveNodeEngine::updateDocument);
     connect(this, &RemoteReceiver::xOffsetChanged, m_node, &LiveNodeEngine::setXOffset);
     connect(this, &RemoteReceiver::yOffsetChanged, m_node, &LiveNodeEngine::setYOffset);
@@ -305,12 +375,18 @@ void RemoteReceiver::onClientDisconnected(QTcpSocket *socket)
     }
     if (m_bulkUpdateInProgress)
         emit endBulkUpdate();
+
+    if (m_multicast)
+        m_multicast->leave();
+    m_multicastStallTimer->stop();
+    m_multicastBarrierPending = false;
+    m_deferredCalls.clear();
 }
 void RemoteReceiver::maybeStartUpdateDocumentsOnConnect()
 {
     if (m_connectionOptions & UpdateDocumentsOnConnect
             && m_updateDocumentsOnConnectState == UpdateNotStarted) {
-        m_client->send("needsPublishWorkspace()", QByteArray());
+        requestPublishWorkspace(m_manifest ? m_manifest->hash() : QByteArray());
         m_updateDocumentsOnConnectState = UpdateRequested;
     } else {
         finishConnectionInitialization();
@@ -326,6 +402,111 @@ void RemoteReceiver::finishConnectionInitialization()
     flushLog();
 }
 
+void RemoteReceiver::joinMulticast(const QByteArray &content)
+{
+    QString address;
+    quint16 port;
+    quint32 session;
+    QByteArray key;
+    quint32 firstSequence;
+    QDataStream in(content);
+    in >> address;
+    in >> port;
+    in >> session;
+    in >> key;
+    in >> firstSequence;
+
+    bool ok = false;
+    if (m_connectionOptions & AcceptMulticast) {
+        if (!m_multicast) {
+            m_multicast = new MulticastReceiver(this);
+            connect(m_multicast, &MulticastReceiver::received, this, &RemoteReceiver::onMulticastReceived);
+            connect(m_multicast, &MulticastReceiver::progress, this, &RemoteReceiver::onMulticastProgress);
+            connect(m_multicast, &MulticastReceiver::nack, this, &RemoteReceiver::onMulticastNack);
+        }
+
+        ok = m_multicast->join(QHostAddress(address), port, session, key, firstSequence);
+        if (!ok)
+            qWarning() << "Failed to join multicast group" << address << port << ":" << m_multicast->errorString();
+    }
+
+    if (m_client)
+        m_client->send("multicastJoined(bool)", QByteArray::number(ok ? 1 : 0));
+}
+
+void RemoteReceiver::onMulticastReceived(const QByteArray &payload)
+{
+    if (!m_connectionAcknowledged)
+        return;
+
+    QString document;
+    QByteArray data;
+    QDataStream in(payload);
+    in >> document;
+    in >> data;
+
+    if (in.status() != QDataStream::Ok || document.isEmpty() || !QDir::isRelativePath(document)) {
+        qWarning() << "Ignoring invalid document received by multicast:" << document;
+        return;
+    }
+
+    emit updateDocument(LiveDocument(document), data);
+}
+
+void RemoteReceiver::onMulticastProgress(quint32 nextSequence)
+{
+    if (!m_multicastBarrierPending)
+        return;
+
+    if (nextSequence <= m_multicastBarrier) {
+        m_multicastStallTimer->start();
+        return;
+    }
+
+    m_multicastStallTimer->stop();
+    m_multicastBarrierPending = false;
+    processDeferredCalls();
+}
+
+void RemoteReceiver::onMulticastNack(const QList<quint32> &sequences)
+{
+    if (!m_client)
+        return;
+
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << sequences;
+    m_client->send("multicastNack(QList<quint32>)", bytes);
+}
+
+void RemoteReceiver::onMulticastStalled()
+{
+    qWarning() << "Multicast transfer stalled, requesting the workspace again";
+
+    m_multicast->skipTo(m_multicastBarrier + 1);
+
+    requestPublishWorkspace(QByteArray());
+}
+
+void RemoteReceiver::requestPublishWorkspace(const QByteArray &manifestHash)
+{
+    if (!m_client)
+        return;
+
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << manifestHash;
+    m_client->send("needsPublishWorkspace(QByteArray)", bytes);
+}
+
+void RemoteReceiver::processDeferredCalls()
+{
+    while (!m_multicastBarrierPending && !m_deferredCalls.isEmpty()) {
+        const QPair<QString, QByteArray> call = m_deferredCalls.takeFirst();
+        handleCall(call.first, call.second);
+    }
+}
+
 /*!
  * Called to send \a errors to remote for remote logging
  */
@@ -408,6 +589,13 @@ void RemoteReceiver::onActiveDocumentChanged(const LiveDocument &document)
  * This signal is emitted to notify that a relaod is requested by the remote client
  */
 
+/*!
+ * \fn void RemoteReceiver::prefetchDocuments(const QStringList &documents)
+ *
+ * This signal is emitted when the remote client suggests to prepare the \a documents
+ * likely to be activated next
+ */
+
 /*!
  * \fn void RemoteReceiver::clientConnected(const QHostAddress& address)
  *
@@ -42,6 +42,8 @@ class LiveDocument;
 class LiveNodeEngine;
 class IpcServer;
 class IpcClient;
+class MulticastReceiver;
+class WorkspaceManifest;
 
 QT_FORWARD_DECLARE_CLASS(QTcpSocket);
 
@@ -62,7 +64,8 @@ public:
     {
         NoConnectionOption = 0x0,
         UpdateDocumentsOnConnect = 0x1,
-        BlockingConnect = 0x2
+        BlockingConnect = 0x2,
+        AcceptMulticast = 0x4
     };
     Q_DECLARE_FLAGS(ConnectionOptions, ConnectionOption)
 #if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
@@ -80,9 +83,12 @@ public:
 
     void setMaxConnections(int max);
 
+    void setWorkspaceManifest(const WorkspaceManifest *manifest);
+
 Q_SIGNALS:
     void activateDocument(const LiveDocument& document);
     void reload();
+    void prefetchDocuments(const QStringList &documents);
     void clientConnected(const QHostAddress& address);
     void clientDisconnected(const QHostAddress& address);
     void pinOk(bool ok);
@@ -107,12 +113,21 @@ private Q_SLOTS:
     void maybeStartUpdateDocumentsOnConnect();
     void finishConnectionInitialization();
 
+    void onMulticastReceived(const QByteArray &payload);
+    void onMulticastProgress(quint32 nextSequence);
+    void onMulticastNack(const QList<quint32> &sequences);
+    void onMulticastStalled();
+
 private:
     void flushLog();
+    void joinMulticast(const QByteArray &content);
+    void processDeferredCalls();
+    void requestPublishWorkspace(const QByteArray &manifestHash);
 
 private:
     IpcServer *m_server;
     LiveNodeEngine *m_node;
+    const WorkspaceManifest *m_manifest;
 
     QString m_pin;
     bool m_connectionAcknowledged;
@@ -126,6 +141,12 @@ private:
 
     QList<QQmlError> m_log;
     int m_logSentPosition;
+
+    MulticastReceiver *m_multicast;
+    QTimer *m_multicastStallTimer;
+    bool m_multicastBarrierPending;
+    quint32 m_multicastBarrier;
+    QList<QPair<QString, QByteArray>> m_deferredCalls;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(RemoteReceiver::ConnectionOptions)
@@ -157,6 +157,9 @@ private:
 ResourceMap::ResourceMap(QObject *parent)
     : QObject(parent)
 {
+    // Resolved once - lookups compare locale ids only
+    m_systemLocale = intern(QLocale::system().name());
+    m_cLocale = intern(QLocale::c().name());
 }
 
 /*!
@@ -169,14 +172,21 @@ QString ResourceMap::toResource(const LiveDocument &document) const
 {
     LIVE_ASSERT(!document.isNull(), return QString());
 
+    const QString documentPath = document.relativeFilePath();
+    return toResource(QStringRef(&documentPath));
+}
+
+/*!
+ * \overload
+ *
+ * Returns the resource that maps to the document with the given relative
+ * \a documentPath. The lookup does not allocate memory.
+ */
+QString ResourceMap::toResource(const QStringRef &documentPath) const
+{
     QReadLocker locker(&m_lock);
-    auto localizedIt = m_resourcesByDocument.find(systemLocalePrefix() + document.relativeFilePath());
-    if (localizedIt != m_resourcesByDocument.end())
-        return *localizedIt;
-    auto nonlocalizedIt = m_resourcesByDocument.find(cLocalePrefix() + document.relativeFilePath());
-    if (nonlocalizedIt != m_resourcesByDocument.end())
-        return *nonlocalizedIt;
-    return QString();
+    const int resource = lookup(m_resourcesByDocument, documentPath);
+    return resource != -1 ? m_strings.at(resource) : QString();
 }
 
 /*!
@@ -189,14 +199,19 @@ LiveDocument ResourceMap::toDocument(const QString &resource) const
 {
     LIVE_ASSERT(!resource.isEmpty(), return LiveDocument());
 
+    return toDocument(QStringRef(&resource));
+}
+
+/*!
+ * \overload
+ *
+ * The lookup of \a resource does not allocate memory.
+ */
+LiveDocument ResourceMap::toDocument(const QStringRef &resource) const
+{
     QReadLocker locker(&m_lock);
-    auto localizedIt = m_documentByResource.find(systemLocalePrefix() + resource);
-    if (localizedIt != m_documentByResource.end())
-        return LiveDocument(*localizedIt);
-    auto nonlocalizedIt = m_documentByResource.find(cLocalePrefix() + resource);
-    if (nonlocalizedIt != m_documentByResource.end())
-        return LiveDocument(*nonlocalizedIt);
-    return LiveDocument();
+    const int document = lookup(m_documentsByResource, resource);
+    return document != -1 ? LiveDocument(m_strings.at(document)) : LiveDocument();
 }
 
 /*!
@@ -209,12 +224,25 @@ QString ResourceMap::errorString() const
     return m_errorString;
 }
 
+/*!
+ * Returns a number that changes whenever the mappings change.
+ *
+ * Allows to cache results derived from the mappings cheaply.
+ */
+int ResourceMap::generation() const
+{
+    return m_generation.load();
+}
+
 /*!
  * Updates mapping from the given \c .qrc document
  *
  * Old mappings for the given \a qrcDocument will be removed, then new mappings
  * will be added based on the content of the \a qrcFile.
  *
+ * Existence of the listed resources is checked again on every update, as
+ * resources may be registered at run time, e.g. with QResource::registerResource().
+ *
  * Returns \c true on success. Otherwise errorString() is set and \c false
  * returned.
  */
@@ -230,63 +258,149 @@ bool ResourceMap::updateMapping(const LiveDocument &qrcDocument, QIODevice *qrcF
 
     QWriteLocker locker(&m_lock);
 
-    removeMapping(qrcDocument);
+    m_generation.ref();
+
+    const int qrc = intern(qrcDocument.relativeFilePath());
+    removeMapping(qrc);
+    m_resourceExists.clear();
+
+    struct Entry
+    {
+        QString resource;
+        QString file;
+        int locale;
+    };
+    QVector<Entry> entries;
+    QStringList resources;
 
-    auto addMapping = [&](const QString &resource, const QString &file,
+    auto addEntry = [&](const QString &resource, const QString &file,
             QLocale::Language language, QLocale::Country country) {
-        QString localePrefix = toLocalePrefix(language, country);
-        QString prefixedResourceName = localePrefix + resource;
-        QString filePath = QDir::cleanPath(QFileInfo(qrcPath, file).filePath());
+        const QString filePath = QDir::cleanPath(QFileInfo(qrcPath, file).filePath());
+        entries.append(Entry{resource, filePath, localeId(language, country)});
+        resources.append(resource);
+    };
+
+    QrcReader reader;
+    connect(&reader, &QrcReader::fileRead, addEntry);
+
+    if (!reader.read(qrcFile, &m_errorString))
+        return false;
+
+    updateExistence(resources);
+
+    foreach (const Entry &entry, entries) {
+        const int resource = intern(entry.resource);
+        const int document = intern(entry.file);
 
         // The bench sends all .qrc files found in the workspace, not just those actually built-in
-        if (!QFileInfo(resource).exists()) {
-            qCDebug(rmLog) << "Not mapping" << prefixedResourceName << "to" << filePath << "(resource does not exist)";
-            return;
+        if (!m_resourceExists.value(resource)) {
+            qCDebug(rmLog) << "Not mapping" << entry.resource << "to" << entry.file
+                           << "(resource does not exist)";
+            continue;
         }
-        qCDebug(rmLog) << "Mapping" << prefixedResourceName << "to" << filePath;
+        qCDebug(rmLog) << "Mapping" << entry.resource << "to" << entry.file
+                       << "locale:" << m_strings.at(entry.locale);
 
-        m_resourcesByDocument.insertMulti(localePrefix + filePath, resource);
-        m_documentByResource.insert(prefixedResourceName, filePath);
-        m_resourcesByQrc.insert(qrcDocument.relativeFilePath(), prefixedResourceName);
-    };
+        m_resourcesByDocument[document].append(Mapping{entry.locale, resource, qrc});
+        m_documentsByResource[resource].append(Mapping{entry.locale, document, qrc});
+        m_keysByQrc[qrc].append(qMakePair(resource, document));
+    }
 
-    QrcReader reader;
-    connect(&reader, &QrcReader::fileRead, addMapping);
+    return true;
+}
 
-    bool ok = reader.read(qrcFile, &m_errorString);
-    if (!ok)
-        removeMapping(qrcDocument);
+int ResourceMap::intern(const QString &string)
+{
+    const int id = find(QStringRef(&string));
+    if (id != -1)
+        return id;
+
+    m_strings.append(string);
+    m_stringIds.insert(qHash(QStringRef(&string)), m_strings.size() - 1);
+    return m_strings.size() - 1;
+}
 
-    return ok;
+int ResourceMap::find(const QStringRef &string) const
+{
+    const uint hash = qHash(string);
+    for (auto it = m_stringIds.constFind(hash); it != m_stringIds.constEnd() && it.key() == hash; ++it) {
+        if (m_strings.at(*it) == string)
+            return *it;
+    }
+    return -1;
 }
 
-void ResourceMap::removeMapping(const LiveDocument &qrcDocument)
+int ResourceMap::lookup(const Index &index, const QStringRef &key) const
 {
-    LIVE_ASSERT(!qrcDocument.isNull(), return);
-
-    auto it = m_resourcesByQrc.find(qrcDocument.relativeFilePath());
-    while (it != m_resourcesByQrc.end() && it.key() == qrcDocument.relativeFilePath()) {
-        QString localePrefix = it->left(it->indexOf(QLatin1Char('/')));
-        QString resource = it->mid(localePrefix.length() + 1);
-        QString file = m_documentByResource.take(*it);
-        m_resourcesByDocument.remove(localePrefix + file, resource);
-        it = m_resourcesByQrc.erase(it);
+    const int id = find(key);
+    if (id == -1)
+        return -1;
+
+    auto it = index.constFind(id);
+    if (it == index.constEnd())
+        return -1;
+
+    // Latest mappings take precedence
+    int nonlocalized = -1;
+    for (int i = it->size() - 1; i >= 0; --i) {
+        const Mapping &mapping = it->at(i);
+        if (mapping.locale == m_systemLocale)
+            return mapping.target;
+        if (mapping.locale == m_cLocale && nonlocalized == -1)
+            nonlocalized = mapping.target;
     }
+    return nonlocalized;
+}
+
+int ResourceMap::localeId(QLocale::Language language, QLocale::Country country)
+{
+    return intern(QLocale(language, country).name());
 }
 
-QString ResourceMap::toLocalePrefix(QLocale::Language language, QLocale::Country country)
+// Each resource is checked once per update. Directories are listed at most
+// once per batch.
+void ResourceMap::updateExistence(const QStringList &resources)
 {
-    return QLocale(language, country).name() + QLatin1Char('/');
+    QHash<QString, QSet<QString>> listings;
+
+    foreach (const QString &resource, resources) {
+        const int id = intern(resource);
+        if (m_resourceExists.contains(id))
+            continue;
+
+        const QFileInfo info(resource);
+        auto listing = listings.find(info.path());
+        if (listing == listings.end()) {
+            const QStringList entries = QDir(info.path()).entryList(QDir::Files | QDir::Hidden);
+            listing = listings.insert(info.path(), QSet<QString>::fromList(entries));
+        }
+
+        m_resourceExists.insert(id, listing->contains(info.fileName()));
+    }
 }
 
-QString ResourceMap::cLocalePrefix()
+void ResourceMap::removeMapping(int qrc)
 {
-    return QLocale::c().name() + QLatin1Char('/');
+    const QVector<QPair<int, int>> keys = m_keysByQrc.take(qrc);
+    for (const auto &key : keys) {
+        removeFromIndex(&m_documentsByResource, key.first, qrc);
+        removeFromIndex(&m_resourcesByDocument, key.second, qrc);
+    }
 }
 
-QString ResourceMap::systemLocalePrefix()
+void ResourceMap::removeFromIndex(Index *index, int key, int qrc)
 {
-    return QLocale::system().name() + QLatin1Char('/');
+    auto it = index->find(key);
+    if (it == index->end())
+        return;
+
+    for (int i = it->size() - 1; i >= 0; --i) {
+        if (it->at(i).qrc == qrc)
+            it->remove(i);
+    }
+
+    if (it->isEmpty())
+        index->erase(it);
 }
 
 #include "resourcemap.moc"
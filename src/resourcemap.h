@@ -45,22 +45,43 @@ public:
     explicit ResourceMap(QObject *parent = nullptr);
 
     QString toResource(const LiveDocument &document) const;
+    QString toResource(const QStringRef &documentPath) const;
     LiveDocument toDocument(const QString &resourceName) const;
+    LiveDocument toDocument(const QStringRef &resourceName) const;
 
     QString errorString() const;
+    int generation() const;
 
     bool updateMapping(const LiveDocument &qrcDocument, QIODevice *qrcFile);
 
 private:
-    void removeMapping(const LiveDocument &qrcDocument);
-    static QString toLocalePrefix(QLocale::Language language, QLocale::Country country);
-    static QString cLocalePrefix();
-    static QString systemLocalePrefix();
+    struct Mapping
+    {
+        int locale;
+        int target;
+        int qrc;
+    };
+    typedef QHash<int, QVector<Mapping>> Index;
+
+    int intern(const QString &string);
+    int find(const QStringRef &string) const;
+    int lookup(const Index &index, const QStringRef &key) const;
+    int localeId(QLocale::Language language, QLocale::Country country);
+    void updateExistence(const QStringList &resources);
+    void removeMapping(int qrc);
+    static void removeFromIndex(Index *index, int key, int qrc);
 
 private:
     mutable QReadWriteLock m_lock;
+    QAtomicInt m_generation;
     QString m_errorString;
-    QMultiHash<QString, QString> m_resourcesByDocument;
-    QHash<QString, QString> m_documentByResource;
-    QMultiHash<QString, QString> m_resourcesByQrc;
+    // Interned paths and locale names, referred to by their index
+    QVector<QString> m_strings;
+    QMultiHash<uint, int> m_stringIds;
+    int m_systemLocale;
+    int m_cLocale;
+    Index m_resourcesByDocument;
+    Index m_documentsByResource;
+    QHash<int, QVector<QPair<int, int>>> m_keysByQrc;
+    QHash<int, bool> m_resourceExists;
 };
@@ -34,6 +34,7 @@
 #include <QtQuick>
 
 #include "livenodeengine.h"
+#include "discoveryannouncer.h"
 #include "remotereceiver.h"
 #include "logger.h"
 #include "qmlhelper.h"
@@ -44,8 +45,13 @@ struct Options
     Options()
         : ipcPort(10234)
         , updatesAsOverlay(false)
+        , updatesInMemory(false)
+        , overlayMemoryLimit(-1)
         , updateOnConnect(false)
         , allowCreateMissing(false)
+        , acceptMulticast(false)
+        , announce(false)
+        , warmStandby(false)
         , fullscreen(false)
         , transparent(false)
         , frameless(false)
@@ -53,8 +59,13 @@ struct Options
     {}
     int ipcPort;
     bool updatesAsOverlay;
+    bool updatesInMemory;
+    int overlayMemoryLimit;
     bool updateOnConnect;
     bool allowCreateMissing;
+    bool acceptMulticast;
+    bool announce;
+    bool warmStandby;
     QString activeDocument;
     QString workspace;
     QString pluginPath;
@@ -93,6 +104,15 @@ static void parseArguments(const QStringList &arguments)
                                               "readonly - store updates in a writable overlay");
     parser.addOption(updatesAsOverlayOption);
 
+    QCommandLineOption updatesInMemoryOption("updates-in-memory", "like updates-as-overlay but keep the overlay "
+                                             "in memory instead of writing updates to the storage");
+    parser.addOption(updatesInMemoryOption);
+
+    QCommandLineOption overlayMemoryLimitOption("overlay-memory-limit", "memory available to the in-memory overlay in "
+                                                "MiB, default is 64. Further updates are stored on disk",
+                                                "megabytes");
+    parser.addOption(overlayMemoryLimitOption);
+
     QCommandLineOption updateOnConnectOption("update-on-connect", "update all workspace documents initially (blocking).");
     parser.addOption(updateOnConnectOption);
 
@@ -100,6 +120,18 @@ static void parseArguments(const QStringList &arguments)
                                                 "accepted for existing workspace documents.");
     parser.addOption(allowCreateMissingOption);
 
+    QCommandLineOption acceptMulticastOption("accept-multicast", "accept documents distributed to many "
+                                             "runtimes at once by UDP multicast");
+    parser.addOption(acceptMulticastOption);
+
+    QCommandLineOption announceOption("announce", "announce this runtime to QmlLive Bench instances on the local "
+                                      "network by UDP multicast");
+    parser.addOption(announceOption);
+
+    QCommandLineOption warmStandbyOption("warm-standby", "keep a second QML engine with imports resolved to "
+                                         "speed up reloads, at the cost of memory");
+    parser.addOption(warmStandbyOption);
+
     QCommandLineOption fullScreenOption("fullscreen", "shows in fullscreen mode");
     parser.addOption(fullScreenOption);
 
@@ -118,8 +150,20 @@ static void parseArguments(const QStringList &arguments)
     options.importPaths = parser.values(importPathOption);
     options.stayontop = parser.isSet(stayOnTopOption);
     options.updatesAsOverlay = parser.isSet(updatesAsOverlayOption);
+    options.updatesInMemory = parser.isSet(updatesInMemoryOption);
+    if (parser.isSet(overlayMemoryLimitOption)) {
+        bool ok;
+        options.overlayMemoryLimit = parser.value(overlayMemoryLimitOption).toInt(&ok);
+        if (!ok || options.overlayMemoryLimit < 0) {
+            qWarning() << "Invalid argument to --overlay-memory-limit option";
+            parser.showHelp(-1);
+        }
+    }
     options.updateOnConnect = parser.isSet(updateOnConnectOption);
     options.allowCreateMissing = parser.isSet(allowCreateMissingOption);
+    options.acceptMulticast = parser.isSet(acceptMulticastOption);
+    options.announce = parser.isSet(announceOption);
+    options.warmStandby = parser.isSet(warmStandbyOption);
     options.fullscreen = parser.isSet(fullScreenOption);
     options.transparent = parser.isSet(transparentOption);
     options.frameless = parser.isSet(framelessOption);
@@ -183,23 +227,50 @@ int main(int argc, char** argv)
 
     QQuickView fallbackView(&qmlEngine, 0);
 
+    QScopedPointer<QQmlEngine> standbyEngine;
+    QScopedPointer<QQuickView> standbyView;
+    if (options.warmStandby) {
+        standbyEngine.reset(new QQmlEngine);
+        standbyView.reset(new QQuickView(standbyEngine.data(), 0));
+    }
+
     LiveNodeEngine::WorkspaceOptions workspaceOptions = LiveNodeEngine::LoadDummyData | LiveNodeEngine::AllowUpdates;
     if (options.updatesAsOverlay)
         workspaceOptions |= LiveNodeEngine::UpdatesAsOverlay;
+    if (options.updatesInMemory)
+        workspaceOptions |= LiveNodeEngine::UpdatesInMemory;
     if (options.allowCreateMissing)
         workspaceOptions |= LiveNodeEngine::AllowCreateMissing;
 
     RemoteReceiver::ConnectionOptions connectionOptions;
     if (options.updateOnConnect)
         connectionOptions |= RemoteReceiver::UpdateDocumentsOnConnect | RemoteReceiver::BlockingConnect;
+    if (options.acceptMulticast)
+        connectionOptions |= RemoteReceiver::AcceptMulticast;
 
     RuntimeLiveNodeEngine engine;
     engine.setQmlEngine(&qmlEngine);
     engine.setFallbackView(&fallbackView);
+    if (options.warmStandby)
+        engine.setStandbyQmlEngine(standbyEngine.data(), standbyView.data());
+    if (options.overlayMemoryLimit >= 0)
+        engine.setOverlayMemoryLimit(qint64(options.overlayMemoryLimit) * 1024 * 1024);
     engine.setWorkspace(options.workspace, workspaceOptions);
     engine.setPluginPath(options.pluginPath);
     RemoteReceiver receiver;
     receiver.registerNode(&engine);
+
+    DiscoveryAnnouncer announcer;
+    if (options.announce) {
+        announcer.setIpcPort(options.ipcPort);
+        announcer.setWorkspace(engine.workspace());
+        // Follow what the node stored, rejected updates do not count
+        QObject::connect(&engine, &LiveNodeEngine::documentUpdated, &announcer, &DiscoveryAnnouncer::updateDocument);
+        receiver.setWorkspaceManifest(&announcer.manifest());
+        if (!announcer.start())
+            qWarning() << "Cannot announce runtime:" << announcer.errorString();
+    }
+
     if (!receiver.listen(options.ipcPort, connectionOptions))
         return EXIT_FAILURE;
 
@@ -8,7 +8,7 @@ DEFINES += NO_LIBRSYNC
 
 SOURCES += \
     $$PWD/resourcemap.cpp \
-    $$PWD/watcher.cpp \
+    $$PWD/workspacetree.cpp \
     $$PWD/livedocument.cpp \
     $$PWD/livehubengine.cpp \
     $$PWD/livenodeengine.cpp \
@@ -18,10 +18,16 @@ SOURCES += \
     $$PWD/remotereceiver.cpp \
     $$PWD/imageadapter.cpp \
     $$PWD/contentpluginfactory.cpp \
+    $$PWD/contentadapterregistry.cpp \
+    $$PWD/tileimageprovider.cpp \
     $$PWD/logger.cpp \
     $$PWD/remotelogger.cpp \
     $$PWD/logreceiver.cpp \
-    $$PWD/fontadapter.cpp
+    $$PWD/fontadapter.cpp \
+    $$PWD/importpathindex.cpp \
+    $$PWD/workspacemanifest.cpp \
+    $$PWD/dependencygraph.cpp \
+    $$PWD/discoveryannouncer.cpp
 
 public_headers += \
     $$PWD/livedocument.h \
@@ -35,14 +41,20 @@ public_headers += \
     $$PWD/remotepublisher.h \
     $$PWD/remotereceiver.h \
     $$PWD/contentadapterinterface.h \
-    $$PWD/remotelogger.h
+    $$PWD/remotelogger.h \
+    $$PWD/importpathindex.h \
+    $$PWD/workspacemanifest.h \
+    $$PWD/workspacetree.h \
+    $$PWD/dependencygraph.h \
+    $$PWD/discoveryannouncer.h
 
 HEADERS += \
     $$public_headers \
     $$PWD/qmllive_version.h \
-    $$PWD/watcher.h \
     $$PWD/imageadapter.h \
     $$PWD/contentpluginfactory.h \
+    $$PWD/contentadapterregistry.h \
+    $$PWD/tileimageprovider.h \
     $$PWD/fontadapter.h
 
 OTHER_FILES += \
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "tileimageprovider.h"
+
+#include <QImageReader>
+#include <QDebug>
+
+namespace {
+const int LEVEL_CACHE_LIMIT = 128 * 1024 * 1024;
+// Whole level images larger than this are not offered
+const qint64 MAX_LEVEL_SIZE = 256 * 1024 * 1024;
+}
+
+/*
+ * Serves tiles of huge images for the image viewer.
+ *
+ * Tile ids have the form "<level>/<column>/<row>/<path>". Level 0 is the image
+ * at full resolution, every further level halves its width and height. Tiles
+ * are TileSize pixels wide and high, except for the last column and row.
+ *
+ * Formats able to decode a clipped and scaled part of an image, like JPEG,
+ * decode each tile on its own. Others, like PNG, decode the whole image even
+ * when scaling it. For these only levels small enough to be held in memory as
+ * a whole are offered, see firstLevel(). The first of them is decoded once and
+ * kept, the further levels are scaled down from it.
+ */
+
+TileImageProvider::TileImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
+    , m_levels(LEVEL_CACHE_LIMIT)
+{
+}
+
+QImage TileImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    Q_UNUSED(requestedSize);
+
+    const QStringList parts = id.split(QLatin1Char('/'));
+    if (parts.count() < 4)
+        return QImage();
+
+    const int level = parts.at(0).toInt();
+    const int column = parts.at(1).toInt();
+    const int row = parts.at(2).toInt();
+    const QString path = QStringList(parts.mid(3)).join(QLatin1Char('/'));
+
+    QImageReader reader(path);
+    const int first = firstLevel(&reader);
+    if (level < first)
+        return QImage();
+
+    const QSize levelSize = TileImageProvider::levelSize(reader.size(), level);
+    const QRect tile = QRect(column * TileSize, row * TileSize, TileSize, TileSize)
+            .intersected(QRect(QPoint(0, 0), levelSize));
+    if (tile.isEmpty())
+        return QImage();
+
+    QImage image;
+    if (canDecodeTiles(&reader, level)) {
+        if (level > 0)
+            reader.setScaledSize(levelSize);
+        reader.setScaledClipRect(tile);
+        image = reader.read();
+    } else {
+        image = levelImage(path, level, reader.size(), first).copy(tile);
+    }
+
+    if (image.isNull())
+        qWarning() << "Failed to decode tile" << id << reader.errorString();
+
+    *size = image.size();
+    return image;
+}
+
+QSize TileImageProvider::levelSize(const QSize &imageSize, int level)
+{
+    if (!imageSize.isValid() || level < 0 || level >= 31)
+        return QSize();
+
+    const int divisor = 1 << level;
+    return QSize(qMax(1, (imageSize.width() + divisor - 1) / divisor),
+                 qMax(1, (imageSize.height() + divisor - 1) / divisor));
+}
+
+int TileImageProvider::levelCount(const QSize &imageSize)
+{
+    int count = 1;
+    QSize size = imageSize;
+    while (size.width() > TileSize || size.height() > TileSize) {
+        size = levelSize(imageSize, count);
+        ++count;
+    }
+    return count;
+}
+
+int TileImageProvider::firstLevel(const QString &path)
+{
+    QImageReader reader(path);
+    return firstLevel(&reader);
+}
+
+bool TileImageProvider::canDecodeTiles(QImageReader *reader, int level)
+{
+    return reader->supportsOption(QImageIOHandler::ScaledClipRect)
+            && (level == 0 || reader->supportsOption(QImageIOHandler::ScaledSize));
+}
+
+int TileImageProvider::firstLevel(QImageReader *reader)
+{
+    const QSize imageSize = reader->size();
+    const int count = levelCount(imageSize);
+
+    int level = 0;
+    for (; level < count - 1 && !canDecodeTiles(reader, level); ++level) {
+        const QSize size = levelSize(imageSize, level);
+        if (qint64(size.width()) * size.height() * 4 <= MAX_LEVEL_SIZE)
+            break;
+    }
+    return level;
+}
+
+QImage TileImageProvider::levelImage(const QString &path, int level, const QSize &imageSize, int firstLevel)
+{
+    const QString key = QString::number(level) + QLatin1Char('/') + path;
+
+    QMutexLocker m(&m_mutex);
+    // Tiles of the same level are requested together, decode the level only once
+    forever {
+        if (key == m_currentKey)
+            return m_current;
+        if (key == m_firstKey)
+            return m_first;
+        if (QImage *image = m_levels.take(key)) {
+            const QImage found = *image;
+            delete image;
+            setCurrentLevel(key, found);
+            return found;
+        }
+        if (!m_decoding.contains(key))
+            break;
+        m_decoded.wait(&m_mutex);
+    }
+    m_decoding.insert(key);
+    m.unlock();
+
+    QImage image;
+    if (level == firstLevel) {
+        QImageReader reader(path);
+        if (level > 0)
+            reader.setScaledSize(levelSize(imageSize, level));
+        image = reader.read();
+    } else {
+        const QImage first = levelImage(path, firstLevel, imageSize, firstLevel);
+        if (!first.isNull())
+            image = first.scaled(levelSize(imageSize, level), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    m.relock();
+    m_decoding.remove(key);
+    if (!image.isNull()) {
+        if (level == firstLevel) {
+            m_firstKey = key;
+            m_first = image;
+        } else {
+            setCurrentLevel(key, image);
+        }
+    }
+    m_decoded.wakeAll();
+    return image;
+}
+
+// Called with m_mutex locked
+void TileImageProvider::setCurrentLevel(const QString &key, const QImage &image)
+{
+    // The cache drops levels which exceed its limit on its own
+    if (!m_currentKey.isEmpty())
+        m_levels.insert(m_currentKey, new QImage(m_current), m_current.bytesPerLine() * m_current.height());
+
+    m_currentKey = key;
+    m_current = image;
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QCache>
+#include <QMutex>
+#include <QQuickImageProvider>
+#include <QSet>
+#include <QWaitCondition>
+
+class QImageReader;
+
+class TileImageProvider : public QQuickImageProvider
+{
+public:
+    static const int TileSize = 512;
+
+    TileImageProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize);
+
+    static QSize levelSize(const QSize &imageSize, int level);
+    static int levelCount(const QSize &imageSize);
+    static int firstLevel(const QString &path);
+
+private:
+    static bool canDecodeTiles(QImageReader *reader, int level);
+    static int firstLevel(QImageReader *reader);
+    QImage levelImage(const QString &path, int level, const QSize &imageSize, int firstLevel);
+    void setCurrentLevel(const QString &key, const QImage &image);
+
+    QMutex m_mutex;
+    QWaitCondition m_decoded;
+    // Whole level images, for formats which cannot decode tiles. The first level
+    // offered, which the others are scaled from, and the level used last are
+    // kept outside of the cache, so that they are never evicted.
+    QString m_firstKey;
+    QImage m_first;
+    QString m_currentKey;
+    QImage m_current;
+    QCache<QString, QImage> m_levels;
+    QSet<QString> m_decoding;
+};
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "filetypefilter.h"
+
+/*
+ * Matches file names against wildcard patterns like "*.qml", ignoring case.
+ *
+ * The patterns are compiled once. Patterns which only name a suffix are looked up
+ * in a hash set by the suffixes of the file name, only other patterns are matched
+ * as wildcard expressions.
+ */
+FileTypeFilter::FileTypeFilter()
+    : m_maximumSuffixDots(0)
+{
+}
+
+QStringList FileTypeFilter::patterns() const
+{
+    return m_patterns;
+}
+
+void FileTypeFilter::setPatterns(const QStringList &patterns)
+{
+    m_patterns = patterns;
+    m_suffixes.clear();
+    m_maximumSuffixDots = 0;
+    m_regExps.clear();
+
+    static const QRegExp wildcardCharacters(QStringLiteral("[*?\\[\\]]"));
+
+    foreach (const QString &pattern, patterns) {
+        if (pattern.startsWith(QLatin1String("*."))) {
+            const QString suffix = pattern.mid(2).toLower();
+            if (!suffix.isEmpty() && !suffix.contains(wildcardCharacters)) {
+                m_suffixes.insert(suffix);
+                m_maximumSuffixDots = qMax(m_maximumSuffixDots, suffix.count(QLatin1Char('.')) + 1);
+                continue;
+            }
+        }
+
+        m_regExps.append(QRegExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard));
+    }
+}
+
+bool FileTypeFilter::matches(const QString &fileName) const
+{
+    if (!m_suffixes.isEmpty()) {
+        const QString name = fileName.toLower();
+        int from = name.size();
+        for (int i = 0; i < m_maximumSuffixDots; ++i) {
+            const int dot = name.lastIndexOf(QLatin1Char('.'), from - 1);
+            if (dot < 0)
+                break;
+            if (m_suffixes.contains(name.mid(dot + 1)))
+                return true;
+            from = dot;
+            if (from == 0)
+                break;
+        }
+    }
+
+    foreach (const QRegExp &regExp, m_regExps) {
+        if (regExp.exactMatch(fileName))
+            return true;
+    }
+
+    return false;
+}
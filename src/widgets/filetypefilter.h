@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2016 Pelagicore AG
+** Copyright (C) 2018 Jolla Ltd
 ** Contact: https://www.qt.io/licensing/
 **
 ** This file is part of the QmlLive tool.
@@ -31,24 +31,25 @@
 
 #pragma once
 
-#include <QFileSystemModel>
+#include <QList>
+#include <QRegExp>
+#include <QSet>
+#include <QStringList>
 
-class FileSystemModel : public QFileSystemModel
+class FileTypeFilter
 {
-    Q_OBJECT
 public:
-    explicit FileSystemModel(QObject *parent = 0);
+    FileTypeFilter();
 
-    void setAllowedTypesFilter(QStringList allowed);
-    QStringList allowedTypesFilter() const;
+    QStringList patterns() const;
+    void setPatterns(const QStringList &patterns);
 
-    void setDirectoriesSelectable(bool enabled);
-    bool directoriesSelectable() const;
-
-    Qt::ItemFlags flags(const QModelIndex &index) const;
+    bool matches(const QString &fileName) const;
 
 private:
-    QStringList m_allowedTypes;
-    bool m_dirSelectable;
+    QStringList m_patterns;
+    // Patterns of the form "*.suffix", lower case
+    QSet<QString> m_suffixes;
+    int m_maximumSuffixDots;
+    QList<QRegExp> m_regExps;
 };
-
@@ -0,0 +1,272 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "logmodel.h"
+#include "logview.h"
+
+namespace {
+const int DEFAULT_CAPACITY = 10000;
+// Messages arriving within one frame are inserted together
+const int FLUSH_INTERVAL = 16; // ms
+}
+
+/*
+ * Keeps the most recent log messages in a ring buffer of capacity() entries.
+ *
+ * Appended messages become visible in batches, inserting all messages received
+ * within one frame at once and dropping the oldest ones if needed. Views only
+ * render the rows visible, so that the cost of a message does not depend on how
+ * many are kept.
+ */
+LogModel::LogModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_first(0)
+    , m_count(0)
+    , m_capacity(DEFAULT_CAPACITY)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL);
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogModel::flush);
+}
+
+int LogModel::capacity() const
+{
+    return m_capacity;
+}
+
+void LogModel::setCapacity(int capacity)
+{
+    if (capacity == m_capacity || capacity <= 0)
+        return;
+
+    flush();
+
+    beginResetModel();
+    QVector<Entry> entries;
+    const int count = qMin(m_count, capacity);
+    entries.reserve(count);
+    for (int row = m_count - count; row < m_count; ++row)
+        entries.append(entryAt(row));
+    m_entries = entries;
+    m_first = 0;
+    m_count = count;
+    m_capacity = capacity;
+    endResetModel();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count)
+        return QVariant();
+
+    const Entry &entry = entryAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole: {
+        QString s;
+        if (entry.url.isValid()) {
+            s.append(entry.url.isLocalFile() ? entry.url.toLocalFile() : entry.url.toString());
+            s.append(QLatin1Char(':'));
+        }
+        if (entry.line > 0) {
+            s.append(QString::number(entry.line));
+            s.append(QLatin1Char(':'));
+        }
+        if (!s.isEmpty())
+            s.append(QLatin1Char(' '));
+        s.append(entry.message);
+        return s;
+    }
+    case TypeRole:
+        return entry.type;
+    case MessageRole:
+        return entry.message;
+    case UrlRole:
+        return entry.url;
+    case LineRole:
+        return entry.line;
+    }
+
+    return QVariant();
+}
+
+void LogModel::append(int type, const QString &msg, const QUrl &url, int line, int column)
+{
+    Q_UNUSED(column);
+
+    Entry entry;
+    entry.type = type;
+    entry.message = msg;
+    entry.url = url;
+    entry.line = line;
+
+    m_pending.append(entry);
+
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void LogModel::clear()
+{
+    m_flushTimer.stop();
+    m_pending.clear();
+
+    beginResetModel();
+    m_entries.clear();
+    m_first = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+/*
+ * Inserts the pending messages now.
+ */
+void LogModel::flush()
+{
+    m_flushTimer.stop();
+
+    if (m_pending.isEmpty())
+        return;
+
+    // Messages which would be dropped right away are never inserted
+    const int skip = qMax(0, m_pending.count() - m_capacity);
+    const int count = m_pending.count() - skip;
+
+    const int overflow = m_count + count - m_capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_first = (m_first + overflow) % m_capacity;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + count - 1);
+    for (int i = skip; i < m_pending.count(); ++i) {
+        const Entry &entry = m_pending.at(i);
+        if (m_entries.count() < m_capacity)
+            m_entries.append(entry);
+        else
+            m_entries[(m_first + m_count) % m_capacity] = entry;
+        ++m_count;
+    }
+    endInsertRows();
+
+    m_pending.clear();
+}
+
+const LogModel::Entry &LogModel::entryAt(int row) const
+{
+    return m_entries.at((m_first + row) % m_entries.count());
+}
+
+/*
+ * Filters a LogModel by the severity of messages and by a text contained in the
+ * message or its location. Messages of the tool itself are always accepted.
+ */
+LogFilterModel::LogFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_minimumSeverity(0)
+{
+}
+
+int LogFilterModel::minimumSeverity() const
+{
+    return m_minimumSeverity;
+}
+
+void LogFilterModel::setMinimumSeverity(int severity)
+{
+    if (severity == m_minimumSeverity)
+        return;
+
+    m_minimumSeverity = severity;
+    invalidateFilter();
+}
+
+QString LogFilterModel::text() const
+{
+    return m_text;
+}
+
+void LogFilterModel::setText(const QString &text)
+{
+    if (text == m_text)
+        return;
+
+    m_text = text;
+    invalidateFilter();
+}
+
+/*
+ * Returns the rank of the message \a type, increasing with severity.
+ */
+int LogFilterModel::severity(int type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return 0;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
+    case QtInfoMsg:
+        return 1;
+#endif
+    case QtWarningMsg:
+        return 2;
+    case QtCriticalMsg:
+        return 3;
+    case QtFatalMsg:
+        return 4;
+    default:
+        return 5;
+    }
+}
+
+bool LogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    const int type = index.data(LogModel::TypeRole).toInt();
+    if (type == LogView::InternalInfo || type == LogView::InternalError)
+        return true;
+
+    if (severity(type) < m_minimumSeverity)
+        return false;
+
+    if (m_text.isEmpty())
+        return true;
+
+    return index.data(Qt::DisplayRole).toString().contains(m_text, Qt::CaseInsensitive);
+}
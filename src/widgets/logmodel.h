@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Roles {
+        TypeRole = Qt::UserRole + 1,
+        MessageRole,
+        UrlRole,
+        LineRole
+    };
+
+    explicit LogModel(QObject *parent = 0);
+
+    int capacity() const;
+    void setCapacity(int capacity);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+
+public slots:
+    void append(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
+    void clear();
+    void flush();
+
+private:
+    struct Entry
+    {
+        int type;
+        QString message;
+        QUrl url;
+        int line;
+    };
+
+    const Entry &entryAt(int row) const;
+
+    QVector<Entry> m_entries;
+    int m_first;
+    int m_count;
+    int m_capacity;
+
+    QVector<Entry> m_pending;
+    QTimer m_flushTimer;
+};
+
+class LogFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit LogFilterModel(QObject *parent = 0);
+
+    int minimumSeverity() const;
+    void setMinimumSeverity(int severity);
+
+    QString text() const;
+    void setText(const QString &text);
+
+    static int severity(int type);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+
+private:
+    int m_minimumSeverity;
+    QString m_text;
+};
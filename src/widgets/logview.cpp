@@ -30,18 +30,118 @@
 ****************************************************************************/
 
 #include "logview.h"
+#include "logmodel.h"
+
+#include <algorithm>
+
+namespace {
+
+class LogDelegate : public QStyledItemDelegate
+{
+public:
+    explicit LogDelegate(QObject *parent)
+        : QStyledItemDelegate(parent)
+    {
+    }
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const
+    {
+        QStyledItemDelegate::initStyleOption(option, index);
+
+        qreal baseValue = option->palette.color(QPalette::Base).valueF();
+        QColor color = option->palette.color(QPalette::Text);
+
+        switch (index.data(LogModel::TypeRole).toInt()) {
+        case QtWarningMsg: // yellow
+            color = baseValue < 0.5f ? QColor(255, 255, 128) : QColor(140, 140, 0);
+            break;
+        case QtCriticalMsg: // red
+            color = baseValue < 0.5f ? QColor(255, 64, 64) : QColor(165, 0, 0);
+            break;
+        case QtFatalMsg: // red
+            color = baseValue < 0.5f ? QColor(255, 64, 64) : QColor(165, 0, 0);
+            break;
+        case LogView::InternalInfo: // green
+            color = baseValue < 0.5f ? QColor(96, 255, 96) : QColor(128, 0, 0);
+            break;
+        case LogView::InternalError: // purple
+            color = baseValue < 0.5f ? QColor(196, 128, 196) : QColor(96, 0, 96);
+            break;
+        default:
+            break;
+        }
+
+        option->palette.setColor(QPalette::Text, color);
+        option->font.setBold(true);
+    }
+};
+
+} // namespace
 
 LogView::LogView(bool createLogger, QWidget *parent)
     : QWidget(parent)
-    , m_log(new QPlainTextEdit(this))
+    , m_log(new QListView(this))
+    , m_model(new LogModel(this))
+    , m_filter(new LogFilterModel(this))
+    , m_severity(new QComboBox(this))
+    , m_text(new QLineEdit(this))
+    , m_followTail(true)
     , m_logger(0)
 {
-    m_log->setReadOnly(true);
-    m_log->setMaximumBlockCount(1000);
-    m_log->setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::LinksAccessibleByMouse);
+    m_filter->setSourceModel(m_model);
+
+    // Only the visible rows are laid out and painted
+    m_log->setModel(m_filter);
+    m_log->setItemDelegate(new LogDelegate(m_log));
+    m_log->setUniformItemSizes(true);
+    m_log->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_log->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_log->setContextMenuPolicy(Qt::ActionsContextMenu);
+
+    QAction *copyAction = new QAction(tr("Copy"), m_log);
+    copyAction->setShortcut(QKeySequence::Copy);
+    copyAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(copyAction, &QAction::triggered, this, &LogView::copy);
+    m_log->addAction(copyAction);
+
+    QAction *selectAllAction = new QAction(tr("Select All"), m_log);
+    selectAllAction->setShortcut(QKeySequence::SelectAll);
+    selectAllAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(selectAllAction, &QAction::triggered, m_log, &QListView::selectAll);
+    m_log->addAction(selectAllAction);
+
+    QAction *clearAction = new QAction(tr("Clear"), m_log);
+    connect(clearAction, &QAction::triggered, this, &LogView::clear);
+    m_log->addAction(clearAction);
+
+    m_severity->addItem(tr("All Messages"), 0);
+    m_severity->addItem(tr("Warnings and Errors"), LogFilterModel::severity(QtWarningMsg));
+    m_severity->addItem(tr("Errors"), LogFilterModel::severity(QtCriticalMsg));
+    connect(m_severity, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, [this](int index) {
+        m_filter->setMinimumSeverity(m_severity->itemData(index).toInt());
+    });
+
+    m_text->setPlaceholderText(tr("Filter by file or message"));
+    m_text->setClearButtonEnabled(true);
+    connect(m_text, &QLineEdit::textChanged, m_filter, &LogFilterModel::setText);
+
+    QScrollBar *scrollBar = m_log->verticalScrollBar();
+    connect(scrollBar, &QScrollBar::valueChanged, this, [this, scrollBar](int value) {
+        m_followTail = value == scrollBar->maximum();
+    });
+    connect(m_filter, &QAbstractItemModel::rowsInserted, this, &LogView::onRowsInserted);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout;
+    filterLayout->setMargin(0);
+    filterLayout->addWidget(m_severity);
+    filterLayout->addWidget(m_text, 1);
 
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->setMargin(0);
+    layout->setSpacing(0);
+    layout->addLayout(filterLayout);
     layout->addWidget(m_log);
     setLayout(layout);
 
@@ -59,49 +159,7 @@ void LogView::setIgnoreMessages(bool ignoreMessages)
 
 void LogView::appendToLog(int type, const QString &msg, const QUrl &url, int line, int column)
 {
-    QMutexLocker l(&m_mutex);
-
-    qreal baseValue = m_log->palette().color(QPalette::Base).valueF();
-    QColor color = m_log->palette().color(QPalette::Text);
-
-    switch (type) {
-    case QtWarningMsg: // yellow
-        color = baseValue < 0.5f ? QColor(255, 255, 128) : QColor(140, 140, 0);
-        break;
-    case QtCriticalMsg: // red
-        color = baseValue < 0.5f ? QColor(255, 64, 64) : QColor(165, 0, 0);
-        break;
-    case QtFatalMsg: // red
-        color = baseValue < 0.5f ? QColor(255, 64, 64) : QColor(165, 0, 0);
-        break;
-    case InternalInfo: // green
-        color = baseValue < 0.5f ? QColor(96, 255, 96) : QColor(128, 0, 0);
-        break;
-    case InternalError: // purple
-        color = baseValue < 0.5f ? QColor(196, 128, 196) : QColor(96, 0, 96);
-        break;
-    default:
-        break;
-    }
-
-    QString s;
-    if (url.isValid()) {
-        s.append(url.isLocalFile() ? url.toLocalFile() : url.toString());
-        s.append(QLatin1Char(':'));
-    }
-    if (line > 0) {
-        s.append(QString::number(line));
-        s.append(QLatin1Char(':'));
-    }
-    Q_UNUSED(column);
-    if (!s.isEmpty())
-        s.append(QLatin1Char(' '));
-
-    s.append(QString::fromLatin1("<b><font color=\"%2\">%1</font></b>")
-             .arg(msg)
-             .arg(color.name()));
-
-    m_log->appendHtml(s);
+    m_model->append(type, msg, url, line, column);
 }
 
 void LogView::appendAllToLog(const QList<QQmlError> &errors)
@@ -125,7 +183,29 @@ void LogView::appendAllToLog(const QList<QQmlError> &errors)
 
 void LogView::clear()
 {
-    QMutexLocker l(&m_mutex);
-    m_log->clear();
+    m_model->clear();
+    m_followTail = true;
+}
+
+/*
+ * Copies the selected messages to the clipboard, one per line.
+ */
+void LogView::copy()
+{
+    QModelIndexList selection = m_log->selectionModel()->selectedRows();
+    std::sort(selection.begin(), selection.end());
+
+    QStringList lines;
+    foreach (const QModelIndex &index, selection)
+        lines.append(index.data(Qt::DisplayRole).toString());
+
+    if (!lines.isEmpty())
+        QGuiApplication::clipboard()->setText(lines.join(QLatin1Char('\n')));
+}
+
+void LogView::onRowsInserted()
+{
+    if (m_followTail)
+        m_log->scrollToBottom();
 }
 
@@ -38,6 +38,8 @@
 
 #include "logger.h"
 
+class LogModel;
+class LogFilterModel;
 
 class LogView : public QWidget
 {
@@ -55,9 +57,18 @@ public slots:
     void appendToLog(int type, const QString &msg, const QUrl &url = QUrl(), int line = -1, int column = -1);
     void appendAllToLog(const QList<QQmlError> &errors);
 
+    void copy();
+
+private slots:
+    void onRowsInserted();
+
 private:
-    QPlainTextEdit *m_log;
+    QListView *m_log;
+    LogModel *m_model;
+    LogFilterModel *m_filter;
+    QComboBox *m_severity;
+    QLineEdit *m_text;
+    bool m_followTail;
 
-    QMutex m_mutex;
     Logger* m_logger;
 };
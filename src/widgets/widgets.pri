@@ -2,14 +2,18 @@ QT += network
 
 SOURCES += \
     $$PWD/logview.cpp \
+    $$PWD/logmodel.cpp \
     $$PWD/workspaceview.cpp \
-    $$PWD/filesystemmodel.cpp \
+    $$PWD/workspacemodel.cpp \
+    $$PWD/filetypefilter.cpp \
     $$PWD/workspacedelegate.cpp \
     $$PWD/windowwidget.cpp
 
 HEADERS += \
     $$PWD/logview.h \
+    $$PWD/logmodel.h \
     $$PWD/workspaceview.h \
-    $$PWD/filesystemmodel.h \
+    $$PWD/workspacemodel.h \
+    $$PWD/filetypefilter.h \
     $$PWD/workspacedelegate.h \
     $$PWD/windowwidget.h
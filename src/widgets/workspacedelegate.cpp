@@ -31,7 +31,7 @@
 
 #include "workspacedelegate.h"
 
-#include "filesystemmodel.h"
+#include "workspacemodel.h"
 #include "workspaceview.h"
 
 WorkspaceDelegate::WorkspaceDelegate(WorkspaceView *view) :
@@ -66,15 +66,9 @@ void WorkspaceDelegate::initStyleOption(QStyleOptionViewItem *option, const QMod
             option->palette.setColor(QPalette::Text, highlightedText);
         }
 
-        if (m_view->model()->isDir(index))
+        if (m_view->model()->isDir(index) || m_view->model()->isAllowedType(index))
             return;
 
-        foreach (QString type, m_view->model()->allowedTypesFilter())
-        {
-            if (path.contains(QRegExp(type, Qt::CaseInsensitive, QRegExp::Wildcard)))
-                return;
-        }
-
         option->state &= ~QStyle::State_Enabled;
 
         QColor disabled = option->palette.color(QPalette::Disabled, QPalette::Text);
@@ -0,0 +1,295 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "workspacemodel.h"
+
+#include <QMimeData>
+#include <QUrl>
+
+/*
+ * Presents a WorkspaceTree to item views, so that views do not scan and watch the
+ * workspace on their own. The model has a single column, the workspace root
+ * directory is represented by the invalid index.
+ */
+WorkspaceModel::WorkspaceModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_dirSelectable(true)
+{
+}
+
+WorkspaceTree *WorkspaceModel::tree() const
+{
+    return m_tree;
+}
+
+void WorkspaceModel::setTree(WorkspaceTree *tree)
+{
+    if (tree == m_tree)
+        return;
+
+    beginResetModel();
+
+    while (!m_treeConnections.isEmpty())
+        disconnect(m_treeConnections.takeLast());
+
+    m_tree = tree;
+    clearAllowedTypeCache();
+
+    if (m_tree) {
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::aboutToBeReset,
+                                     this, &WorkspaceModel::beginResetModel);
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::reset, this, [this] {
+            clearAllowedTypeCache();
+            endResetModel();
+        });
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::nodesAboutToBeInserted,
+                                     this, &WorkspaceModel::onNodesAboutToBeInserted);
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::nodesInserted,
+                                     this, &WorkspaceModel::endInsertRows);
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::nodesAboutToBeRemoved,
+                                     this, &WorkspaceModel::onNodesAboutToBeRemoved);
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::nodesRemoved,
+                                     this, &WorkspaceModel::endRemoveRows);
+        m_treeConnections << connect(m_tree.data(), &WorkspaceTree::nodeChanged,
+                                     this, &WorkspaceModel::onNodeChanged);
+    }
+
+    endResetModel();
+}
+
+QString WorkspaceModel::rootPath() const
+{
+    return m_tree ? m_tree->rootPath() : QString();
+}
+
+QModelIndex WorkspaceModel::index(const QString &path) const
+{
+    if (!m_tree)
+        return QModelIndex();
+
+    return indexOf(m_tree->find(path));
+}
+
+QString WorkspaceModel::filePath(const QModelIndex &index) const
+{
+    if (!m_tree)
+        return QString();
+
+    return m_tree->filePath(node(index));
+}
+
+QString WorkspaceModel::fileName(const QModelIndex &index) const
+{
+    const WorkspaceTree::Node *n = node(index);
+    return n ? n->name : QString();
+}
+
+bool WorkspaceModel::isDir(const QModelIndex &index) const
+{
+    const WorkspaceTree::Node *n = node(index);
+    return n && n->isDir;
+}
+
+void WorkspaceModel::setAllowedTypesFilter(QStringList allowed)
+{
+    m_allowedTypes.setPatterns(allowed);
+    clearAllowedTypeCache();
+}
+
+QStringList WorkspaceModel::allowedTypesFilter() const
+{
+    return m_allowedTypes.patterns();
+}
+
+void WorkspaceModel::setDirectoriesSelectable(bool enabled)
+{
+    m_dirSelectable = enabled;
+}
+
+bool WorkspaceModel::directoriesSelectable() const
+{
+    return m_dirSelectable;
+}
+
+/*
+ * Returns whether the file at \a index matches the allowed types filter.
+ */
+bool WorkspaceModel::isAllowedType(const QModelIndex &index) const
+{
+    const WorkspaceTree::Node *n = node(index);
+    if (!n)
+        return false;
+
+    QHash<const WorkspaceTree::Node *, bool>::const_iterator it = m_allowedTypeCache.constFind(n);
+    if (it != m_allowedTypeCache.constEnd())
+        return it.value();
+
+    const bool allowed = m_allowedTypes.matches(n->name);
+    m_allowedTypeCache.insert(n, allowed);
+    return allowed;
+}
+
+QModelIndex WorkspaceModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!m_tree || column != 0 || row < 0)
+        return QModelIndex();
+
+    const WorkspaceTree::Node *parentNode = parent.isValid() ? node(parent) : m_tree->root();
+    if (!parentNode || row >= parentNode->children.count())
+        return QModelIndex();
+
+    return createIndex(row, column, const_cast<WorkspaceTree::Node *>(parentNode->children.at(row)));
+}
+
+QModelIndex WorkspaceModel::parent(const QModelIndex &child) const
+{
+    const WorkspaceTree::Node *n = node(child);
+    if (!n)
+        return QModelIndex();
+
+    return indexOf(n->parent);
+}
+
+int WorkspaceModel::rowCount(const QModelIndex &parent) const
+{
+    if (!m_tree || parent.column() > 0)
+        return 0;
+
+    const WorkspaceTree::Node *n = parent.isValid() ? node(parent) : m_tree->root();
+    return n ? n->children.count() : 0;
+}
+
+int WorkspaceModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    return 1;
+}
+
+QVariant WorkspaceModel::data(const QModelIndex &index, int role) const
+{
+    const WorkspaceTree::Node *n = node(index);
+    if (!n)
+        return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return n->name;
+    case Qt::DecorationRole:
+        // Per type icons, looking up icons per file is too slow for large trees
+        return m_iconProvider.icon(n->isDir ? QFileIconProvider::Folder : QFileIconProvider::File);
+    case Qt::ToolTipRole:
+        return filePath(index);
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags WorkspaceModel::flags(const QModelIndex &index) const
+{
+    const WorkspaceTree::Node *n = node(index);
+    if (!n)
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags f = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+
+    if (n->isDir) {
+        if (m_dirSelectable)
+            return f;
+        else
+            return f & ~Qt::ItemIsSelectable;
+    }
+
+    f |= Qt::ItemIsDragEnabled | Qt::ItemNeverHasChildren;
+
+    if (isAllowedType(index))
+        return f;
+
+    return f & ~Qt::ItemIsSelectable;
+}
+
+QStringList WorkspaceModel::mimeTypes() const
+{
+    return QStringList(QStringLiteral("text/uri-list"));
+}
+
+QMimeData *WorkspaceModel::mimeData(const QModelIndexList &indexes) const
+{
+    QList<QUrl> urls;
+    foreach (const QModelIndex &index, indexes) {
+        if (index.isValid())
+            urls.append(QUrl::fromLocalFile(filePath(index)));
+    }
+
+    QMimeData *data = new QMimeData;
+    data->setUrls(urls);
+    return data;
+}
+
+void WorkspaceModel::onNodesAboutToBeInserted(const WorkspaceTree::Node *parent, int first, int last)
+{
+    beginInsertRows(indexOf(parent), first, last);
+}
+
+void WorkspaceModel::onNodesAboutToBeRemoved(const WorkspaceTree::Node *parent, int first, int last)
+{
+    // Removed nodes are deleted and their addresses may be reused
+    clearAllowedTypeCache();
+    beginRemoveRows(indexOf(parent), first, last);
+}
+
+void WorkspaceModel::onNodeChanged(const WorkspaceTree::Node *node)
+{
+    const QModelIndex index = indexOf(node);
+    emit dataChanged(index, index);
+}
+
+void WorkspaceModel::clearAllowedTypeCache()
+{
+    m_allowedTypeCache.clear();
+}
+
+const WorkspaceTree::Node *WorkspaceModel::node(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return 0;
+
+    return static_cast<const WorkspaceTree::Node *>(index.internalPointer());
+}
+
+QModelIndex WorkspaceModel::indexOf(const WorkspaceTree::Node *node) const
+{
+    if (!m_tree || !node || node == m_tree->root())
+        return QModelIndex();
+
+    return createIndex(node->row, 0, const_cast<WorkspaceTree::Node *>(node));
+}
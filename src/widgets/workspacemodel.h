@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QFileIconProvider>
+#include <QHash>
+#include <QPointer>
+
+#include "filetypefilter.h"
+#include "workspacetree.h"
+
+class WorkspaceModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    explicit WorkspaceModel(QObject *parent = 0);
+
+    WorkspaceTree *tree() const;
+    void setTree(WorkspaceTree *tree);
+
+    QString rootPath() const;
+
+    QModelIndex index(const QString &path) const;
+    QString filePath(const QModelIndex &index) const;
+    QString fileName(const QModelIndex &index) const;
+    bool isDir(const QModelIndex &index) const;
+
+    void setAllowedTypesFilter(QStringList allowed);
+    QStringList allowedTypesFilter() const;
+
+    void setDirectoriesSelectable(bool enabled);
+    bool directoriesSelectable() const;
+
+    bool isAllowedType(const QModelIndex &index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &child) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+
+    QStringList mimeTypes() const;
+    QMimeData *mimeData(const QModelIndexList &indexes) const;
+
+private slots:
+    void onNodesAboutToBeInserted(const WorkspaceTree::Node *parent, int first, int last);
+    void onNodesAboutToBeRemoved(const WorkspaceTree::Node *parent, int first, int last);
+    void onNodeChanged(const WorkspaceTree::Node *node);
+    void clearAllowedTypeCache();
+
+private:
+    const WorkspaceTree::Node *node(const QModelIndex &index) const;
+    QModelIndex indexOf(const WorkspaceTree::Node *node) const;
+
+    QPointer<WorkspaceTree> m_tree;
+    QList<QMetaObject::Connection> m_treeConnections;
+    FileTypeFilter m_allowedTypes;
+    // Views ask for every paint
+    mutable QHash<const WorkspaceTree::Node *, bool> m_allowedTypeCache;
+    bool m_dirSelectable;
+    QFileIconProvider m_iconProvider;
+};
@@ -30,7 +30,7 @@
 ****************************************************************************/
 
 #include "workspaceview.h"
-#include "filesystemmodel.h"
+#include "workspacemodel.h"
 #include "workspacedelegate.h"
 
 /*!
@@ -38,6 +38,9 @@
   \internal
   \brief A TreeView showing the Local Filesystem.
 
+  The view shows the contents of a WorkspaceTree, usually the one of the LiveHubEngine
+  publishing the same workspace, see setWorkspaceTree().
+
   The activateDocument() signal can be used to connect to a LiveHubEngine.
  */
 
@@ -48,14 +51,11 @@
 WorkspaceView::WorkspaceView(QWidget *parent)
     : QWidget(parent)
     , m_view(new QTreeView(this))
-    , m_model(new FileSystemModel(this))
+    , m_model(new WorkspaceModel(this))
 {
     // setup view
 //    m_view->setFocusPolicy(Qt::NoFocus);
     m_view->setModel(m_model);
-    m_view->hideColumn(1); // size
-    m_view->hideColumn(2); // type
-    m_view->hideColumn(3); // modified time
 
     // Prevent view highlighting background of a selected row. Only the
     // active-document's row should be highlighted. See also
@@ -81,12 +81,12 @@ WorkspaceView::WorkspaceView(QWidget *parent)
 }
 
 /*!
- * Sets the root workspace path to be displayed in the view to \a dirPath
+ * Sets the workspace \a tree to be displayed in the view. The view follows the root
+ * path of the tree.
  */
-void WorkspaceView::setRootPath(const QString &dirPath)
+void WorkspaceView::setWorkspaceTree(WorkspaceTree *tree)
 {
-    m_rootIndex = m_model->setRootPath(dirPath);
-    m_view->setRootIndex(m_model->index(dirPath));
+    m_model->setTree(tree);
 }
 
 /*!
@@ -101,14 +101,20 @@ void WorkspaceView::activateDocument(const LiveDocument &path)
 
 void WorkspaceView::activateRootPath()
 {
-    selectIndex(m_rootIndex);
-    emit pathActivated(LiveDocument(QStringLiteral(".")));
+    LiveDocument oldDocument = m_currentDocument;
+
+    m_view->setCurrentIndex(QModelIndex());
+    m_currentDocument = LiveDocument(QStringLiteral("."));
+    emit pathActivated(m_currentDocument);
+
+    if (!oldDocument.isNull())
+        m_view->update(m_model->index(oldDocument.absoluteFilePathIn(rootPath())));
 }
 
 void WorkspaceView::goUp()
 {
     QModelIndex index = m_view->currentIndex().parent();
-    if (!index.isValid() || index == m_rootIndex)
+    if (!index.isValid())
         return;
 
     selectIndex(index);
@@ -149,7 +155,7 @@ void WorkspaceView::indexActivated(const QModelIndex &index)
 
     LiveDocument oldDocument = m_currentDocument;
 
-    m_currentDocument = LiveDocument::resolve(m_model->rootDirectory(), path);
+    m_currentDocument = LiveDocument::resolve(rootPath(), path);
     emit pathActivated(m_currentDocument);
     m_view->update(index);
 
@@ -36,21 +36,22 @@
 #include <QtGui>
 #include <QtWidgets>
 
-class FileSystemModel;
+class WorkspaceModel;
+class WorkspaceTree;
 
 class WorkspaceView : public QWidget
 {
     Q_OBJECT
 public:
     explicit WorkspaceView(QWidget *parent = 0);
-    FileSystemModel *model() const { return m_model; }
+    WorkspaceModel *model() const { return m_model; }
+    void setWorkspaceTree(WorkspaceTree *tree);
     LiveDocument activeDocument() const;
     QString rootPath() const;
     void setDirectoriesSelectable(bool enabled);
     bool directoriesSelectable() const;
 
 public Q_SLOTS:
-    void setRootPath(const QString& dirPath);
     void activateDocument(const LiveDocument& path);
     void activateRootPath();
     void goUp();
@@ -64,7 +65,6 @@ private Q_SLOTS:
 private:
     void selectIndex(const QModelIndex& index);
     QTreeView *m_view;
-    FileSystemModel *m_model;
-    QModelIndex m_rootIndex;
+    WorkspaceModel *m_model;
     LiveDocument m_currentDocument;
 };
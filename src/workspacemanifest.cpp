@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "workspacemanifest.h"
+#include "workspacetree.h"
+
+/*!
+ * \class WorkspaceManifest
+ * \brief Summarizes the content of a workspace with a single hash
+ * \inmodule qmllive
+ *
+ * The manifest keeps a SHA-1 hash of every document in a workspace, keyed by
+ * the document path relative to the workspace. Two workspaces with equal
+ * hash() hold the same documents with the same content, which lets a hub
+ * skip publishing a workspace a node already has.
+ *
+ * Documents are considered the same way LiveHubEngine::publishWorkspace()
+ * does, i.e. hidden files and directories are skipped.
+ */
+
+/*!
+ * Constructs an empty manifest.
+ */
+WorkspaceManifest::WorkspaceManifest()
+{
+}
+
+/*!
+ * Returns \c true if the manifest lists no documents.
+ */
+bool WorkspaceManifest::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+/*!
+ * Returns the number of documents listed.
+ */
+int WorkspaceManifest::count() const
+{
+    return m_entries.count();
+}
+
+/*!
+ * Returns the relative paths of all documents listed, in sorted order.
+ */
+QStringList WorkspaceManifest::documents() const
+{
+    return m_entries.keys();
+}
+
+/*!
+ * Returns \c true if \a document is listed.
+ */
+bool WorkspaceManifest::contains(const QString &document) const
+{
+    return m_entries.contains(document);
+}
+
+/*!
+ * Updates the manifest to list the documents currently found under \a workspace.
+ *
+ * Documents whose size and modification time did not change since the last
+ * scan are not read again.
+ */
+void WorkspaceManifest::scan(const QString &workspace)
+{
+    const QDir dir(workspace);
+
+    QStringList directories(dir.absolutePath());
+    QDirIterator dirIter(dir.absolutePath(), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (dirIter.hasNext())
+        directories.append(dirIter.next());
+
+    QMap<QString, Entry> entries;
+    foreach (const QString &path, directories) {
+        QDirIterator fileIter(path, QDir::Files);
+        while (fileIter.hasNext()) {
+            fileIter.next();
+            const QFileInfo info = fileIter.fileInfo();
+            const QString document = dir.relativeFilePath(info.absoluteFilePath());
+
+            Entry entry;
+            if (scanDocument(document, info.absoluteFilePath(), info.size(), info.lastModified(), &entry))
+                entries.insert(document, entry);
+        }
+    }
+
+    m_entries.swap(entries);
+    m_hash.clear();
+}
+
+/*!
+ * Updates the manifest to list the files of \a tree, without scanning the
+ * workspace again.
+ */
+void WorkspaceManifest::scan(const WorkspaceTree &tree)
+{
+    const QDir dir(tree.rootPath());
+
+    QMap<QString, Entry> entries;
+    foreach (const WorkspaceTree::Node *node, tree.fileNodes()) {
+        const QString filePath = tree.filePath(node);
+        const QString document = dir.relativeFilePath(filePath);
+
+        Entry entry;
+        if (scanDocument(document, filePath, node->size, node->lastModified, &entry))
+            entries.insert(document, entry);
+    }
+
+    m_entries.swap(entries);
+    m_hash.clear();
+}
+
+/*!
+ * Fills \a entry for \a document, reading the file at \a filePath unless its
+ * \a size and \a lastModified time match the entry listed already.
+ */
+bool WorkspaceManifest::scanDocument(const QString &document, const QString &filePath, qint64 size,
+                                     const QDateTime &lastModified, Entry *entry) const
+{
+    *entry = m_entries.value(document);
+    if (entry->size == size && entry->lastModified == lastModified)
+        return true;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    entry->hash = hash.result();
+    entry->size = size;
+    entry->lastModified = lastModified;
+    return true;
+}
+
+/*!
+ * Records that \a document now holds \a content.
+ */
+void WorkspaceManifest::update(const QString &document, const QByteArray &content)
+{
+    Entry entry;
+    entry.hash = contentHash(content);
+    // Unknown size and modification time, the next scan() reads the document again
+    m_entries.insert(document, entry);
+    m_hash.clear();
+}
+
+/*!
+ * Removes \a document from the manifest.
+ */
+void WorkspaceManifest::remove(const QString &document)
+{
+    if (m_entries.remove(document))
+        m_hash.clear();
+}
+
+/*!
+ * Removes all documents from the manifest.
+ */
+void WorkspaceManifest::clear()
+{
+    m_entries.clear();
+    m_hash.clear();
+}
+
+/*!
+ * Returns the hash of \a document or an empty byte array if it is not listed.
+ */
+QByteArray WorkspaceManifest::documentHash(const QString &document) const
+{
+    return m_entries.value(document).hash;
+}
+
+/*!
+ * Returns a hash over the paths and content hashes of all documents listed or
+ * an empty byte array if the manifest is empty.
+ */
+QByteArray WorkspaceManifest::hash() const
+{
+    if (m_hash.isEmpty() && !m_entries.isEmpty()) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            hash.addData(it.key().toUtf8());
+            hash.addData("\0", 1);
+            hash.addData(it.value().hash);
+        }
+        m_hash = hash.result();
+    }
+
+    return m_hash;
+}
+
+/*!
+ * Returns the hash of a document holding \a content.
+ */
+QByteArray WorkspaceManifest::contentHash(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
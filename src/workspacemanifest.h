@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+
+#include "qmllive_global.h"
+
+class WorkspaceTree;
+
+class QMLLIVESHARED_EXPORT WorkspaceManifest
+{
+public:
+    WorkspaceManifest();
+
+    bool isEmpty() const;
+    int count() const;
+    QStringList documents() const;
+    bool contains(const QString &document) const;
+
+    void scan(const QString &workspace);
+    void scan(const WorkspaceTree &tree);
+    void update(const QString &document, const QByteArray &content);
+    void remove(const QString &document);
+    void clear();
+
+    QByteArray documentHash(const QString &document) const;
+    QByteArray hash() const;
+
+    static QByteArray contentHash(const QByteArray &content);
+
+private:
+    struct Entry
+    {
+        QByteArray hash;
+        qint64 size = -1;
+        QDateTime lastModified;
+    };
+
+    bool scanDocument(const QString &document, const QString &filePath, qint64 size,
+                      const QDateTime &lastModified, Entry *entry) const;
+
+    // relative file path -> entry, ordered so that hash() is stable
+    QMap<QString, Entry> m_entries;
+    mutable QByteArray m_hash;
+};
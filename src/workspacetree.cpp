@@ -0,0 +1,543 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include "workspacetree.h"
+
+#include <algorithm>
+
+namespace {
+const int CHANGE_DELAY = 100; // ms
+
+// Directories first, then by name ignoring case
+int compareEntries(bool aIsDir, const QString &aName, bool bIsDir, const QString &bName)
+{
+    if (aIsDir != bIsDir)
+        return aIsDir ? -1 : 1;
+    const int result = QString::compare(aName, bName, Qt::CaseInsensitive);
+    return result != 0 ? result : QString::compare(aName, bName);
+}
+
+int compareEntries(const WorkspaceTree::Node *node, const QFileInfo &info)
+{
+    return compareEntries(node->isDir, node->name, info.isDir(), info.fileName());
+}
+
+bool infoLessThan(const QFileInfo &a, const QFileInfo &b)
+{
+    return compareEntries(a.isDir(), a.fileName(), b.isDir(), b.fileName()) < 0;
+}
+}
+
+/*!
+ * \class WorkspaceTree
+ * \brief The WorkspaceTree class keeps the contents of a workspace in memory
+ * \inmodule qmllive
+ *
+ * The workspace is scanned once when its root path is set. Every directory is then
+ * watched for changes, and changed directories are scanned again to update the tree.
+ * The tree is shared by everything needing the workspace contents, like publishing
+ * and workspace views, so that a workspace is only scanned and watched once.
+ *
+ * Children of a node are sorted with directories first, then by name ignoring case.
+ * Changes to the tree are signalled in a way suitable for item models.
+ */
+
+/*!
+ \enum WorkspaceTree::Error
+ \brief Describes error state of a WorkspaceTree
+
+ \value NoError
+        No error
+ \value MaximumReached
+        The maximum number of watches set with setMaximumWatches() was exceeded
+ \value SystemError
+        QFileSystemWatcher::addPath failed for an unspecified reason
+ */
+
+int WorkspaceTree::s_maximumWatches = -1;
+
+/*!
+ * Standard constructor using \a parent as parent
+ */
+WorkspaceTree::WorkspaceTree(QObject *parent)
+    : QObject(parent)
+    , m_root(new Node)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_waitTimer(new QTimer(this))
+    , m_watchCount(0)
+{
+    m_root->isDir = true;
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &WorkspaceTree::recordChange);
+    connect(m_waitTimer, &QTimer::timeout, this, &WorkspaceTree::notifyChanges);
+    m_waitTimer->setInterval(CHANGE_DELAY);
+    m_waitTimer->setSingleShot(true);
+}
+
+/*!
+ * Standard destructor
+ */
+WorkspaceTree::~WorkspaceTree()
+{
+    deleteNode(m_root);
+}
+
+/*!
+ * Returns the absolute path of the workspace root directory
+ */
+QString WorkspaceTree::rootPath() const
+{
+    return m_rootDir.absolutePath();
+}
+
+/*!
+ * Scans the workspace at \a path and starts watching it for changes.
+ *
+ * Emits aboutToBeReset() before and reset() after the tree is replaced.
+ */
+void WorkspaceTree::setRootPath(const QString &path)
+{
+    emit aboutToBeReset();
+
+    m_waitTimer->stop();
+    m_changes.clear();
+    m_changedFiles.clear();
+    removeAllWatches();
+    setError(NoError);
+
+    deleteNode(m_root);
+    m_root = new Node;
+    m_root->isDir = true;
+
+    m_rootDir = QDir(path);
+    scanChildren(m_root, m_rootDir.absolutePath());
+
+    emit reset();
+}
+
+/*!
+ * Returns the node of the workspace root directory
+ */
+const WorkspaceTree::Node *WorkspaceTree::root() const
+{
+    return m_root;
+}
+
+/*!
+ * Returns the node for the absolute \a path or null if it is not part of the
+ * workspace
+ */
+const WorkspaceTree::Node *WorkspaceTree::find(const QString &path) const
+{
+    const QString relativePath = m_rootDir.relativeFilePath(path);
+    if (relativePath == QLatin1String("."))
+        return m_root;
+    if (relativePath.startsWith(QLatin1String("..")) || QDir::isAbsolutePath(relativePath))
+        return 0;
+
+    const Node *node = m_root;
+    foreach (const QString &name, relativePath.split(QLatin1Char('/'), QString::SkipEmptyParts)) {
+        const Node *child = 0;
+        for (int isDir = 1; isDir >= 0 && !child; --isDir) {
+            auto it = std::lower_bound(node->children.constBegin(), node->children.constEnd(), name,
+                                       [isDir](const Node *n, const QString &key) {
+                return compareEntries(n->isDir, n->name, isDir, key) < 0;
+            });
+            if (it != node->children.constEnd() && (*it)->isDir == bool(isDir) && (*it)->name == name)
+                child = *it;
+        }
+        if (!child)
+            return 0;
+        node = child;
+    }
+
+    return node;
+}
+
+/*!
+ * Returns the absolute path of \a node
+ */
+QString WorkspaceTree::filePath(const Node *node) const
+{
+    QStringList names;
+    for (; node && node != m_root; node = node->parent)
+        names.prepend(node->name);
+
+    if (names.isEmpty())
+        return rootPath();
+
+    return rootPath() + QLatin1Char('/') + names.join(QLatin1Char('/'));
+}
+
+/*!
+ * Returns the absolute paths of all directories in the workspace, starting with
+ * the workspace root directory
+ */
+QStringList WorkspaceTree::directories() const
+{
+    QStringList directories;
+    QList<const Node *> pending;
+    pending.append(m_root);
+    while (!pending.isEmpty()) {
+        const Node *node = pending.takeFirst();
+        directories.append(filePath(node));
+        foreach (const Node *child, node->children) {
+            if (child->isDir)
+                pending.append(child);
+        }
+    }
+    return directories;
+}
+
+/*!
+ * Returns the absolute paths of the files directly in \a directory
+ */
+QStringList WorkspaceTree::files(const QString &directory) const
+{
+    QStringList files;
+    const Node *node = find(directory);
+    if (!node)
+        return files;
+
+    const QString prefix = filePath(node) + QLatin1Char('/');
+    foreach (const Node *child, node->children) {
+        if (!child->isDir)
+            files.append(prefix + child->name);
+    }
+    return files;
+}
+
+/*!
+ * Returns the nodes of all files in the workspace
+ */
+QList<const WorkspaceTree::Node *> WorkspaceTree::fileNodes() const
+{
+    QList<const Node *> files;
+    QList<const Node *> pending;
+    pending.append(m_root);
+    while (!pending.isEmpty()) {
+        const Node *node = pending.takeFirst();
+        foreach (const Node *child, node->children) {
+            if (child->isDir)
+                pending.append(child);
+            else
+                files.append(child);
+        }
+    }
+    return files;
+}
+
+/*!
+ * \fn WorkspaceTree::maximumWatches()
+ *
+ * Returns the maximum number of watched directories
+ */
+
+/*!
+ * Sets the maximum number of watched directories to \a maximumWatches
+ *
+ * This will only take effect with next setRootPath() call.
+ */
+void WorkspaceTree::setMaximumWatches(int maximumWatches)
+{
+    s_maximumWatches = maximumWatches;
+}
+
+void WorkspaceTree::recordChange(const QString &path)
+{
+    m_changes.append(path);
+    m_waitTimer->start();
+}
+
+/*!
+ * Updates the directories changed, each together with its subdirectories.
+ * Changes within a directory changed as well are updated with it.
+ */
+void WorkspaceTree::notifyChanges()
+{
+    QStringList changes = m_changes;
+    m_changes.clear();
+    changes.removeDuplicates();
+    changes.sort();
+
+    QStringList final;
+    foreach (const QString &entry, changes) {
+        bool covered = false;
+        foreach (const QString &top, final) {
+            if (entry.startsWith(top + QLatin1Char('/'))) {
+                covered = true;
+                break;
+            }
+        }
+        // A removed directory is updated with its parent
+        if (!covered && QDir(entry).exists())
+            final.append(entry);
+    }
+
+    foreach (const QString &entry, final) {
+        if (Node *node = const_cast<Node *>(find(entry))) {
+            if (node->isDir)
+                updateChildren(node, entry);
+        }
+    }
+
+    const QStringList changedFiles = m_changedFiles;
+    m_changedFiles.clear();
+    if (!changedFiles.isEmpty())
+        emit filesChanged(changedFiles);
+
+    emit directoriesChanged(final);
+}
+
+QFileInfoList WorkspaceTree::entries(const QString &path) const
+{
+    QFileInfoList infos = QDir(path).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::NoSort);
+    std::sort(infos.begin(), infos.end(), infoLessThan);
+    return infos;
+}
+
+WorkspaceTree::Node *WorkspaceTree::createNode(const QFileInfo &info, Node *parent)
+{
+    Node *node = new Node;
+    node->name = info.fileName();
+    node->isDir = info.isDir();
+    node->size = info.size();
+    node->lastModified = info.lastModified();
+    node->parent = parent;
+
+    // Symbolic links are not followed to avoid cycles
+    if (node->isDir && !info.isSymLink())
+        scanChildren(node, info.absoluteFilePath());
+
+    return node;
+}
+
+void WorkspaceTree::scanChildren(Node *node, const QString &path)
+{
+    watch(path);
+
+    foreach (const QFileInfo &info, entries(path)) {
+        Node *child = createNode(info, node);
+        child->row = node->children.count();
+        node->children.append(child);
+    }
+}
+
+/*!
+ * Brings the children of \a node in line with the directory at \a path.
+ */
+void WorkspaceTree::updateChildren(Node *node, const QString &path)
+{
+    const QFileInfoList infos = entries(path);
+
+    int row = 0;
+    int i = 0;
+    while (row < node->children.count() || i < infos.count()) {
+        const int result = row == node->children.count() ? 1
+                : i == infos.count() ? -1
+                : compareEntries(node->children.at(row), infos.at(i));
+
+        if (result < 0) {
+            int last = row;
+            while (last + 1 < node->children.count()
+                   && (i == infos.count() || compareEntries(node->children.at(last + 1), infos.at(i)) < 0)) {
+                ++last;
+            }
+            removeNodes(node, row, last);
+        } else if (result > 0) {
+            int last = i;
+            while (last + 1 < infos.count()
+                   && (row == node->children.count() || compareEntries(node->children.at(row), infos.at(last + 1)) > 0)) {
+                ++last;
+            }
+            insertNodes(node, row, infos.mid(i, last - i + 1));
+            row += last - i + 1;
+            i = last + 1;
+        } else {
+            Node *child = node->children.at(row);
+            const QFileInfo &info = infos.at(i);
+            if (child->isDir) {
+                if (!info.isSymLink())
+                    updateChildren(child, info.absoluteFilePath());
+            } else if (child->size != info.size() || child->lastModified != info.lastModified()) {
+                child->size = info.size();
+                child->lastModified = info.lastModified();
+                m_changedFiles.append(info.absoluteFilePath());
+                emit nodeChanged(child);
+            }
+            ++row;
+            ++i;
+        }
+    }
+}
+
+void WorkspaceTree::insertNodes(Node *parent, int row, const QFileInfoList &infos)
+{
+    QVector<Node *> nodes;
+    foreach (const QFileInfo &info, infos)
+        nodes.append(createNode(info, parent));
+
+    emit nodesAboutToBeInserted(parent, row, row + nodes.count() - 1);
+    for (int i = 0; i < nodes.count(); ++i)
+        parent->children.insert(row + i, nodes.at(i));
+    renumber(parent, row);
+    emit nodesInserted();
+
+    const QString parentPath = filePath(parent) + QLatin1Char('/');
+    foreach (const Node *node, nodes)
+        collectFiles(node, parentPath + node->name);
+}
+
+void WorkspaceTree::removeNodes(Node *parent, int first, int last)
+{
+    emit nodesAboutToBeRemoved(parent, first, last);
+    const QVector<Node *> nodes = parent->children.mid(first, last - first + 1);
+    parent->children.remove(first, last - first + 1);
+    renumber(parent, first);
+    emit nodesRemoved();
+
+    const QString parentPath = filePath(parent) + QLatin1Char('/');
+    foreach (Node *node, nodes) {
+        collectFiles(node, parentPath + node->name);
+        unwatch(node, parentPath + node->name);
+        deleteNode(node);
+    }
+}
+
+void WorkspaceTree::renumber(Node *parent, int from)
+{
+    for (int row = from; row < parent->children.count(); ++row)
+        parent->children.at(row)->row = row;
+}
+
+/*!
+ * Records the files in the subtree of \a node at \a path as changed.
+ */
+void WorkspaceTree::collectFiles(const Node *node, const QString &path)
+{
+    if (!node->isDir) {
+        m_changedFiles.append(path);
+        return;
+    }
+
+    foreach (const Node *child, node->children)
+        collectFiles(child, path + QLatin1Char('/') + child->name);
+}
+
+void WorkspaceTree::deleteNode(Node *node)
+{
+    foreach (Node *child, node->children)
+        deleteNode(child);
+    delete node;
+}
+
+void WorkspaceTree::watch(const QString &path)
+{
+    if (hasError())
+        return;
+
+    if (s_maximumWatches > 0 && m_watchCount >= s_maximumWatches) {
+        removeAllWatches();
+        setError(MaximumReached);
+        return;
+    }
+
+    if (!m_watcher->addPath(path)) {
+        removeAllWatches();
+        setError(SystemError);
+        return;
+    }
+
+    ++m_watchCount;
+}
+
+void WorkspaceTree::unwatch(const Node *node, const QString &path)
+{
+    if (!node->isDir)
+        return;
+
+    foreach (const Node *child, node->children)
+        unwatch(child, path + QLatin1Char('/') + child->name);
+
+    if (m_watcher->removePath(path))
+        --m_watchCount;
+}
+
+void WorkspaceTree::removeAllWatches()
+{
+    if (!m_watcher->directories().isEmpty())
+        m_watcher->removePaths(m_watcher->directories());
+    if (!m_watcher->files().isEmpty())
+        m_watcher->removePaths(m_watcher->files());
+    m_watchCount = 0;
+}
+
+void WorkspaceTree::setError(WorkspaceTree::Error error)
+{
+    if (m_error == error)
+        return;
+
+    m_error = error;
+    emit errorChanged();
+}
+
+/*!
+ * \fn WorkspaceTree::hasError() const
+ *
+ * Returns true if error() is not NoError
+ */
+
+/*!
+ * \fn WorkspaceTree::error() const
+ *
+ * Describes the current error state of this tree
+ */
+
+/*!
+ * \fn void WorkspaceTree::filesChanged(const QStringList &files)
+ *
+ * This signal is emitted after the tree was updated, just before
+ * directoriesChanged(), with the absolute paths of the \a files added, removed or
+ * modified.
+ */
+
+/*!
+ * \fn void WorkspaceTree::directoriesChanged(const QStringList &changes)
+ *
+ * This signal is emitted after the tree was updated for changes of the
+ * directories \a changes and their subdirectories.
+ */
+
+/*!
+ * \fn void WorkspaceTree::errorChanged()
+ *
+ * Notifies about error() change
+ */
@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore>
+
+#include "qmllive_global.h"
+
+class QMLLIVESHARED_EXPORT WorkspaceTree : public QObject
+{
+    Q_OBJECT
+public:
+    enum Error {
+        NoError,
+        MaximumReached,
+        SystemError,
+    };
+
+    struct Node
+    {
+        QString name;
+        bool isDir = false;
+        qint64 size = 0;
+        QDateTime lastModified;
+        Node *parent = 0;
+        int row = 0;
+        QVector<Node *> children;
+    };
+
+    explicit WorkspaceTree(QObject *parent = 0);
+    ~WorkspaceTree();
+
+    QString rootPath() const;
+    void setRootPath(const QString &path);
+
+    const Node *root() const;
+    const Node *find(const QString &path) const;
+    QString filePath(const Node *node) const;
+
+    QStringList directories() const;
+    QStringList files(const QString &directory) const;
+    QList<const Node *> fileNodes() const;
+
+    bool hasError() const { return m_error != NoError; }
+    Error error() const { return m_error; }
+    static int maximumWatches() { return s_maximumWatches; }
+    static void setMaximumWatches(int maximumWatches);
+
+Q_SIGNALS:
+    void filesChanged(const QStringList &files);
+    void directoriesChanged(const QStringList &changes);
+    void errorChanged();
+
+    void aboutToBeReset();
+    void reset();
+    void nodesAboutToBeInserted(const WorkspaceTree::Node *parent, int first, int last);
+    void nodesInserted();
+    void nodesAboutToBeRemoved(const WorkspaceTree::Node *parent, int first, int last);
+    void nodesRemoved();
+    void nodeChanged(const WorkspaceTree::Node *node);
+
+private Q_SLOTS:
+    void recordChange(const QString &path);
+    void notifyChanges();
+
+private:
+    QFileInfoList entries(const QString &path) const;
+    Node *createNode(const QFileInfo &info, Node *parent);
+    void scanChildren(Node *node, const QString &path);
+    void updateChildren(Node *node, const QString &path);
+    void insertNodes(Node *parent, int row, const QFileInfoList &infos);
+    void removeNodes(Node *parent, int first, int last);
+    void renumber(Node *parent, int from);
+    void deleteNode(Node *node);
+    void collectFiles(const Node *node, const QString &path);
+
+    void watch(const QString &path);
+    void unwatch(const Node *node, const QString &path);
+    void removeAllWatches();
+    void setError(Error error);
+
+    static int s_maximumWatches;
+
+    QDir m_rootDir;
+    Node *m_root;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_waitTimer;
+    QStringList m_changes;
+    QStringList m_changedFiles;
+    int m_watchCount;
+    Error m_error = NoError;
+};
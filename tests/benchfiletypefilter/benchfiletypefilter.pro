@@ -0,0 +1,15 @@
+QT       += testlib core
+
+TARGET = tst_benchfiletypefilter
+CONFIG   += testcase
+
+INCLUDEPATH += $$PWD/../../src/widgets
+
+TEMPLATE = app
+
+SOURCES += \
+    tst_benchfiletypefilter.cpp \
+    $$PWD/../../src/widgets/filetypefilter.cpp
+
+HEADERS += \
+    $$PWD/../../src/widgets/filetypefilter.h
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "filetypefilter.h"
+
+namespace {
+const int ENTRY_COUNT = 100000;
+}
+
+class BenchFileTypeFilter : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchFileTypeFilter() {}
+
+private slots:
+    void initTestCase() {
+        m_patterns << "*.qml" << "*.png" << "*.otf" << "*.ttf";
+
+        // A synthetic workspace tree, 10 levels of 10 directories deep at most
+        static const char *const suffixes[] = { "qml", "js", "png", "PNG", "jpg", "txt", "ttf", "qmlc", "", "tar.gz" };
+        m_paths.reserve(ENTRY_COUNT);
+        for (int i = 0; i < ENTRY_COUNT; ++i) {
+            QString path;
+            for (int level = i; level > 0; level /= 10)
+                path += QStringLiteral("dir%1/").arg(level % 10);
+            path += QStringLiteral("file%1").arg(i);
+            const char *suffix = suffixes[i % 10];
+            if (*suffix)
+                path += QLatin1Char('.') + QLatin1String(suffix);
+            m_paths.append(path);
+        }
+    }
+
+    void matches_data() {
+        QTest::addColumn<QString>("fileName");
+        QTest::addColumn<bool>("matches");
+
+        QTest::newRow("suffix") << "main.qml" << true;
+        QTest::newRow("upper case") << "Image.PNG" << true;
+        QTest::newRow("other suffix") << "main.js" << false;
+        QTest::newRow("suffix prefix") << "main.qmlc" << false;
+        QTest::newRow("inner suffix") << "main.qml.orig" << false;
+        QTest::newRow("no suffix") << "qml" << false;
+        QTest::newRow("dot file") << ".qml" << true;
+        QTest::newRow("wildcard") << "Makefile" << true;
+        QTest::newRow("compound suffix") << "archive.tar.gz" << true;
+    }
+
+    void matches() {
+        QFETCH(QString, fileName);
+        QFETCH(bool, matches);
+
+        FileTypeFilter filter;
+        filter.setPatterns(QStringList(m_patterns) << "Make*" << "*.tar.gz");
+        QCOMPARE(filter.matches(fileName), matches);
+    }
+
+    void regExpBaseline() {
+        int count = 0;
+        QBENCHMARK {
+            count = 0;
+            foreach (const QString &path, m_paths) {
+                foreach (const QString &type, m_patterns) {
+                    if (path.contains(QRegExp(type, Qt::CaseInsensitive, QRegExp::Wildcard))) {
+                        ++count;
+                        break;
+                    }
+                }
+            }
+        }
+        QVERIFY(count > 0);
+    }
+
+    void fileTypeFilter() {
+        FileTypeFilter filter;
+        filter.setPatterns(m_patterns);
+
+        int count = 0;
+        QBENCHMARK {
+            count = 0;
+            foreach (const QString &path, m_paths) {
+                if (filter.matches(path.mid(path.lastIndexOf(QLatin1Char('/')) + 1)))
+                    ++count;
+            }
+        }
+        QCOMPARE(count, ENTRY_COUNT * 4 / 10);
+    }
+
+private:
+    QStringList m_patterns;
+    QStringList m_paths;
+};
+
+QTEST_MAIN(BenchFileTypeFilter)
+
+#include "tst_benchfiletypefilter.moc"
@@ -0,0 +1,21 @@
+QT       += testlib core
+
+TARGET = tst_testdependencygraph
+CONFIG   += testcase
+
+INCLUDEPATH += $$PWD/../../src
+# Library sources are compiled in
+DEFINES += QMLLIVE_LIBRARY
+
+TEMPLATE = app
+
+SOURCES += \
+    tst_testdependencygraph.cpp \
+    $$PWD/../../src/dependencygraph.cpp \
+    $$PWD/../../src/importpathindex.cpp \
+    $$PWD/../../src/workspacetree.cpp
+
+HEADERS += \
+    $$PWD/../../src/dependencygraph.h \
+    $$PWD/../../src/importpathindex.h \
+    $$PWD/../../src/workspacetree.h
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "dependencygraph.h"
+#include "workspacetree.h"
+
+class TestDependencyGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDependencyGraph() {}
+
+private:
+    static void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+private Q_SLOTS:
+    void scanQml_data() {
+        QTest::addColumn<QString>("document");
+        QTest::addColumn<QByteArray>("content");
+        QTest::addColumn<QStringList>("expected");
+        QTest::addColumn<QStringList>("unexpected");
+
+        QTest::newRow("directory import")
+                << "main.qml" << QByteArray("import \"controls\"\nItem {}\n")
+                << QStringList("controls/qmldir") << QStringList();
+        QTest::newRow("script import")
+                << "main.qml" << QByteArray("import \"logic.js\" as Logic\nItem {}\n")
+                << QStringList("logic.js") << QStringList("logic.js/qmldir");
+        QTest::newRow("module import")
+                << "main.qml" << QByteArray("import QtQuick 2.0\nimport Company.Controls 1.0\nItem {}\n")
+                << (QStringList() << "QtQuick/qmldir" << "Company/Controls/qmldir") << QStringList();
+        QTest::newRow("import outside")
+                << "main.qml" << QByteArray("import \"../shared\"\nimport \"/usr/lib/qml\"\nItem {}\n")
+                << QStringList() << (QStringList() << "../shared/qmldir" << "/usr/lib/qml/qmldir");
+        QTest::newRow("type from own directory")
+                << "pages/main.qml" << QByteArray("Item {\n    Button {}\n}\n")
+                << QStringList("pages/Button.qml") << QStringList("Button.qml");
+        QTest::newRow("qualified type")
+                << "main.qml" << QByteArray("import \"controls\" as C\nItem {\n    C.Button {}\n}\n")
+                << QStringList("controls/Button.qml") << QStringList("Button.qml");
+        QTest::newRow("url literals")
+                << "pages/main.qml"
+                << QByteArray("Image {\n    source: \"../images/logo.png\"\n"
+                              "    property url icon: Qt.resolvedUrl('icon.svg')\n"
+                              "    property url remote: \"http://example.com/remote.png\"\n}\n")
+                << (QStringList() << "images/logo.png" << "pages/icon.svg")
+                << QStringList("pages/http://example.com/remote.png");
+        QTest::newRow("comments")
+                << "main.qml"
+                << QByteArray("// import \"old\"\nItem {\n    // Button {}\n    /* Image { source: \"old.png\" }\n"
+                              "       Text {} */\n    Label {}\n}\n")
+                << QStringList("Label.qml")
+                << (QStringList() << "old/qmldir" << "Button.qml" << "old.png" << "Text.qml");
+        QTest::newRow("comment markers in strings")
+                << "main.qml"
+                << QByteArray("Item {\n    property string filter: \"images/*.png\"\n"
+                              "    property string separator: '//'\n    Button {}\n    Label {}\n"
+                              "    property string escaped: \"\\\"/*\"\n    Slider {}\n"
+                              "    /* Would have ended a comment opened within a string */\n}\n")
+                << (QStringList() << "Button.qml" << "Label.qml" << "Slider.qml") << QStringList();
+    }
+
+    void scanQml() {
+        QFETCH(QString, document);
+        QFETCH(QByteArray, content);
+        QFETCH(QStringList, expected);
+        QFETCH(QStringList, unexpected);
+
+        const QStringList dependencies = DependencyGraph::scanQml(document, content);
+        foreach (const QString &dependency, expected)
+            QVERIFY2(dependencies.contains(dependency), qPrintable(dependency));
+        foreach (const QString &dependency, unexpected)
+            QVERIFY2(!dependencies.contains(dependency), qPrintable(dependency));
+        QVERIFY(!dependencies.contains(document));
+    }
+
+    void scanJavaScript() {
+        const QByteArray content(".import \"util.js\" as Util\n"
+                                 "Qt.include(\"other.js\") // Qt.include(\"ignored.js\")\n"
+                                 "var pattern = \"*/\"; var path = \"data/items.json\";\n");
+        const QStringList dependencies = DependencyGraph::scanJavaScript("scripts/main.js", content);
+        QCOMPARE(dependencies, QStringList() << "scripts/data/items.json" << "scripts/other.js"
+                                             << "scripts/util.js");
+    }
+
+    void update() {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        const QDir dir(workspace.path());
+        writeFile(dir.filePath("main.qml"), "import \"controls\"\nItem {\n    Button {}\n}\n");
+        writeFile(dir.filePath("controls/qmldir"), "Button 1.0 Button.qml\n");
+        writeFile(dir.filePath("controls/Button.qml"), "Item {\n    Image { source: \"button.png\" }\n}\n");
+        writeFile(dir.filePath("unused.qml"), "Item {}\n");
+
+        WorkspaceTree tree;
+        tree.setRootPath(workspace.path());
+
+        DependencyGraph graph;
+        QVERIFY(graph.isEmpty());
+        graph.update(tree);
+        QVERIFY(!graph.isEmpty());
+
+        QCOMPARE(graph.dependencies("controls/qmldir"), QStringList("controls/Button.qml"));
+        QVERIFY(graph.closure("main.qml").contains("controls/button.png"));
+        QVERIFY(!graph.closure("main.qml").contains("unused.qml"));
+        QVERIFY(graph.referencedDocuments().contains("controls/Button.qml"));
+        QVERIFY(!graph.referencedDocuments().contains("unused.qml"));
+
+        // Only the documents passed are scanned again
+        writeFile(dir.filePath("controls/Button.qml"), "Item {\n    Image { source: \"pressed.png\" }\n}\n");
+        tree.setRootPath(workspace.path());
+        graph.update(tree, QStringList("controls/Button.qml"));
+        QVERIFY(graph.closure("main.qml").contains("controls/pressed.png"));
+        QVERIFY(!graph.closure("main.qml").contains("controls/button.png"));
+
+        QVERIFY(QFile::remove(dir.filePath("controls/Button.qml")));
+        tree.setRootPath(workspace.path());
+        graph.update(tree, QStringList("controls/Button.qml"));
+        QVERIFY(graph.dependencies("controls/Button.qml").isEmpty());
+
+        graph.clear();
+        QVERIFY(graph.isEmpty());
+    }
+
+    void closureOrder() {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        const QDir dir(workspace.path());
+        writeFile(dir.filePath("main.qml"), "First {}\n");
+        writeFile(dir.filePath("First.qml"), "Second {}\n");
+        // Circular
+        writeFile(dir.filePath("Second.qml"), "First {}\n");
+        writeFile(dir.filePath("Other.qml"), "Second {}\n");
+
+        WorkspaceTree tree;
+        tree.setRootPath(workspace.path());
+        DependencyGraph graph;
+        graph.update(tree);
+
+        QCOMPARE(graph.closure("main.qml"),
+                 QSet<QString>() << "main.qml" << "First.qml" << "Second.qml");
+        QCOMPARE(graph.closureOrder("main.qml"),
+                 QStringList() << "Second.qml" << "First.qml" << "main.qml");
+        QCOMPARE(graph.closureOrder("Second.qml"), QStringList() << "First.qml" << "Second.qml");
+
+        // Not scanned
+        QCOMPARE(graph.closureOrder("missing.qml"), QStringList("missing.qml"));
+    }
+};
+
+QTEST_MAIN(TestDependencyGraph)
+
+#include "tst_testdependencygraph.moc"
@@ -1,15 +1,25 @@
-QT       += testlib core network
+QT       += testlib core network qml quick
 
 TARGET = tst_testipc
 CONFIG   += testcase
 
 include($$PWD/../../src/ipc/ipc.pri)
 INCLUDEPATH += $$PWD/../../src
+# Library sources are compiled in
+DEFINES += QMLLIVE_LIBRARY
 
 TEMPLATE = app
 
 SOURCES += \
-    tst_testipc.cpp
+    tst_testipc.cpp \
+    $$PWD/../../src/logger.cpp \
+    $$PWD/../../src/logreceiver.cpp \
+    $$PWD/../../src/remotelogger.cpp
+
+HEADERS += \
+    $$PWD/../../src/logger.h \
+    $$PWD/../../src/logreceiver.h \
+    $$PWD/../../src/remotelogger.h
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
 TESTDATA = testdata/*
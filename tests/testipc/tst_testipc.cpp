@@ -30,9 +30,17 @@
 ****************************************************************************/
 
 #include <QtTest>
+#include <QUdpSocket>
 
 #include "ipc/ipcserver.h"
 #include "ipc/ipcclient.h"
+#include "ipc/multicastsender.h"
+#include "ipc/multicastreceiver.h"
+#include "ipc/multicastdatagram.h"
+#include "ipc/discoverydatagram.h"
+#include "ipc/logdatagram.h"
+#include "logreceiver.h"
+#include "remotelogger.h"
 
 class TestIpc : public QObject
 {
@@ -86,6 +94,206 @@ private Q_SLOTS:
         QSignalSpy received(&peer1, &IpcServer::received);
         QTRY_COMPARE(received.count(), 1);
     }
+
+    void multicast() {
+        const QHostAddress group("239.255.43.21");
+        MulticastSender sender;
+        if (!sender.start(group, 10240))
+            QSKIP(qPrintable("Multicast not available: " + sender.errorString()));
+
+        // Sent before the receiver is listening, so it has to ask for it
+        QByteArray missed(5000, 'm');
+        const quint32 firstSequence = sender.nextSequence();
+        sender.send(missed);
+        QSignalSpy idle(&sender, &MulticastSender::idle);
+        QTRY_VERIFY(idle.count() > 0);
+
+        MulticastReceiver receiver;
+        if (!receiver.join(group, 10240, sender.session(), sender.key(), firstSequence))
+            QSKIP(qPrintable("Multicast not available: " + receiver.errorString()));
+        connect(&receiver, &MulticastReceiver::nack, &sender, &MulticastSender::resend);
+        QSignalSpy received(&receiver, &MulticastReceiver::received);
+
+        QByteArray payload(3000, 'p');
+        sender.send(payload);
+
+        QTRY_COMPARE(received.count(), 2);
+        QList<QByteArray> payloads;
+        payloads << received.at(0).at(0).toByteArray() << received.at(1).at(0).toByteArray();
+        QVERIFY(payloads.contains(missed));
+        QVERIFY(payloads.contains(payload));
+        QCOMPARE(receiver.nextSequence(), sender.nextSequence());
+    }
+
+    void multicastDatagram() {
+        const QByteArray key = MulticastDatagram::createKey();
+        QCOMPARE(key.size(), int(MulticastDatagram::KeySize));
+
+        MulticastDatagram datagram;
+        datagram.session = 42;
+        datagram.sequence = 7;
+        datagram.transfer = 3;
+        datagram.fragment = 1;
+        datagram.fragmentCount = 2;
+        datagram.chunk = "chunk";
+
+        MulticastDatagram decoded;
+        QVERIFY(decoded.decode(datagram.encode(key), key));
+        QCOMPARE(decoded.session, datagram.session);
+        QCOMPARE(decoded.sequence, datagram.sequence);
+        QCOMPARE(decoded.fragment, datagram.fragment);
+        QCOMPARE(decoded.fragmentCount, datagram.fragmentCount);
+        QCOMPARE(decoded.chunk, datagram.chunk);
+
+        // Not authenticated with the session key
+        QVERIFY(!decoded.decode(datagram.encode(MulticastDatagram::createKey()), key));
+        QByteArray tampered = datagram.encode(key);
+        tampered[MulticastDatagram::DataHeaderSize] = 'C';
+        QVERIFY(!decoded.decode(tampered, key));
+
+        // Would make the receiver allocate more than any payload needs
+        datagram.fragmentCount = MulticastDatagram::MaxFragmentCount + 1;
+        QVERIFY(!decoded.decode(datagram.encode(key), key));
+    }
+
+    void discoveryDatagram() {
+        DiscoveryDatagram announce;
+        announce.id = QUuid::createUuid();
+        announce.port = 10234;
+        announce.ttl = 6000;
+        announce.productVersion = "1.0";
+        announce.systemName = "Sailfish OS";
+        announce.manifestHash = QByteArray(20, 'h');
+
+        DiscoveryDatagram decoded;
+        QVERIFY(decoded.decode(announce.encode()));
+        QCOMPARE(decoded.type, quint8(DiscoveryDatagram::Announce));
+        QCOMPARE(decoded.id, announce.id);
+        QCOMPARE(decoded.port, announce.port);
+        QCOMPARE(decoded.ttl, announce.ttl);
+        QCOMPARE(decoded.productVersion, announce.productVersion);
+        QCOMPARE(decoded.systemName, announce.systemName);
+        QCOMPARE(decoded.manifestHash, announce.manifestHash);
+
+        QVERIFY(!decoded.decode(announce.encode().left(20)));
+        QVERIFY(!decoded.decode(QByteArray("QLMC")));
+    }
+
+    void logDatagram() {
+        LogDatagram batch;
+        batch.session = 42;
+        batch.sequence = 7;
+        LogDatagram::Record warning;
+        warning.type = QtWarningMsg;
+        warning.message = "Binding loop detected";
+        warning.url = QUrl::fromLocalFile("/workspace/main.qml");
+        warning.line = 12;
+        warning.column = 5;
+        LogDatagram::Record debug;
+        debug.message = "hello";
+        batch.records << warning << debug;
+
+        const QByteArray encoded = batch.encode();
+        QCOMPARE(encoded.size(), LogDatagram::headerSize() + LogDatagram::recordSize(warning)
+                 + LogDatagram::recordSize(debug));
+
+        LogDatagram decoded;
+        QVERIFY(decoded.decode(encoded));
+        QCOMPARE(decoded.session, batch.session);
+        QCOMPARE(decoded.sequence, batch.sequence);
+        QCOMPARE(decoded.records.count(), 2);
+        QCOMPARE(decoded.records.at(0).type, int(QtWarningMsg));
+        QCOMPARE(decoded.records.at(0).message, warning.message);
+        QCOMPARE(decoded.records.at(0).url, warning.url);
+        QCOMPARE(decoded.records.at(0).line, warning.line);
+        QCOMPARE(decoded.records.at(0).column, warning.column);
+        QCOMPARE(decoded.records.at(1).message, debug.message);
+
+        QVERIFY(!decoded.decode(encoded.left(encoded.size() - 1)));
+        QVERIFY(!decoded.decode(QByteArray("1%%%legacy%%%%%%-1%%%-1")));
+    }
+
+    void logReceiver() {
+        LogReceiver receiver;
+        receiver.setAddress("127.0.0.1");
+        receiver.setPort(10245);
+        receiver.connectToServer();
+        QSignalSpy messages(&receiver, &LogReceiver::message);
+
+        auto batch = [](quint32 sequence, const QString &message) {
+            LogDatagram datagram;
+            datagram.session = 42;
+            datagram.sequence = sequence;
+            LogDatagram::Record record;
+            record.message = message;
+            datagram.records << record;
+            return datagram.encode();
+        };
+
+        QUdpSocket sender;
+        const QHostAddress host(QHostAddress::LocalHost);
+        sender.writeDatagram(batch(0, "first"), host, 10245);
+        // 1 and 2 are missing at this point
+        sender.writeDatagram(batch(3, "fourth"), host, 10245);
+        // 1 arrives late, 2 never does
+        sender.writeDatagram(batch(1, "second"), host, 10245);
+        QTest::ignoreMessage(QtWarningMsg, "Invalid Log package received");
+        sender.writeDatagram(QByteArray("garbage"), host, 10245);
+        sender.writeDatagram(QByteArray("1%%%legacy%%%file:///main.qml%%%3%%%4"), host, 10245);
+
+        QTRY_COMPARE(messages.count(), 5);
+        QCOMPARE(messages.at(0).at(1).toString(), QString("first"));
+        QCOMPARE(messages.at(1).at(0).toInt(), int(QtWarningMsg));
+        QCOMPARE(messages.at(1).at(1).toString(), QString("LogReceiver: 2 log datagrams lost"));
+        QCOMPARE(messages.at(2).at(1).toString(), QString("fourth"));
+        QCOMPARE(messages.at(3).at(1).toString(), QString("second"));
+        QCOMPARE(messages.at(4).at(0).toInt(), 1);
+        QCOMPARE(messages.at(4).at(1).toString(), QString("legacy"));
+        QCOMPARE(messages.at(4).at(2).toUrl(), QUrl("file:///main.qml"));
+        QCOMPARE(messages.at(4).at(3).toInt(), 3);
+        QCOMPARE(messages.at(4).at(4).toInt(), 4);
+
+        QCOMPARE(receiver.lostDatagrams(), 1);
+        QCOMPARE(receiver.reorderedDatagrams(), 1);
+    }
+
+    // Keep last, the logger replaces the message handler of the test
+    void remoteLoggerSplitsLongMessages() {
+        LogReceiver receiver;
+        receiver.setAddress("127.0.0.1");
+        receiver.setPort(10246);
+        receiver.connectToServer();
+        QSignalSpy messages(&receiver, &LogReceiver::message);
+
+        const QString longMessage = QString(3000, QLatin1Char('x')) + QStringLiteral("end");
+        QQmlError error;
+        error.setUrl(QUrl("file:///main.qml"));
+        error.setLine(3);
+        error.setColumn(4);
+        error.setDescription(longMessage);
+
+        {
+            RemoteLogger logger;
+            logger.setHostAddress(QHostAddress::LocalHost);
+            logger.setPort(10246);
+            logger.appendToLog(QList<QQmlError>() << error);
+            QCOMPARE(logger.droppedRecords(), 0);
+        }
+
+        auto received = [&messages]() {
+            QString message;
+            foreach (const QList<QVariant> &arguments, messages)
+                message += arguments.at(1).toString();
+            return message;
+        };
+        QTRY_COMPARE(received(), longMessage);
+        QVERIFY(messages.count() > 1);
+        foreach (const QList<QVariant> &arguments, messages) {
+            QCOMPARE(arguments.at(2).toUrl(), QUrl("file:///main.qml"));
+            QCOMPARE(arguments.at(3).toInt(), 3);
+        }
+        QCOMPARE(receiver.lostDatagrams(), 0);
+    }
 };
 
 QTEST_MAIN(TestIpc)
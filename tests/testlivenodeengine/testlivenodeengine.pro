@@ -0,0 +1,12 @@
+QT       += testlib core quick
+
+TARGET = tst_testlivenodeengine
+CONFIG   += testcase
+
+include(../../qmllive.pri)
+include(../../src/lib.pri)
+
+TEMPLATE = app
+
+SOURCES += \
+    tst_testlivenodeengine.cpp
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QQmlEngine>
+#include <QQmlError>
+#include <QQuickView>
+
+#include "livedocument.h"
+#include "livenodeengine.h"
+
+class TestLiveNodeEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestLiveNodeEngine() {}
+
+private:
+    static void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    static QByteArray mainDocument()
+    {
+        // Foo is used implicitly, from the directory of the document
+        return "import QtQuick 2.0\nItem { width: 100; height: 100; Foo {} }\n";
+    }
+
+    static QByteArray fooDocument()
+    {
+        return "import QtQuick 2.0\nItem {}\n";
+    }
+
+private Q_SLOTS:
+    void createMissingDependency()
+    {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        writeFile(QDir(workspace.path()).filePath("main.qml"), mainDocument());
+
+        QQmlEngine qmlEngine;
+        QQuickView fallbackView(&qmlEngine, 0);
+        LiveNodeEngine node;
+        node.setQmlEngine(&qmlEngine);
+        node.setFallbackView(&fallbackView);
+        node.setWorkspace(workspace.path(), LiveNodeEngine::AllowUpdates | LiveNodeEngine::AllowCreateMissing);
+
+        QSignalSpy loaded(&node, &LiveNodeEngine::documentLoaded);
+        int errors = 0;
+        connect(&node, &LiveNodeEngine::logErrors, [&errors](const QList<QQmlError> &list) {
+            errors += list.count();
+        });
+
+        node.loadDocument(LiveDocument("main.qml"));
+        QCOMPARE(loaded.count(), 1);
+        QVERIFY(errors > 0);
+
+        // The document does not use Foo.qml as it does not exist yet
+        errors = 0;
+        node.updateDocument(LiveDocument("Foo.qml"), fooDocument());
+        QTRY_COMPARE(loaded.count(), 2);
+        QCOMPARE(errors, 0);
+        QVERIFY(node.activeWindow());
+
+        // Loaded fine and nothing changed since
+        node.loadDocument(LiveDocument("main.qml"));
+        QCOMPARE(loaded.count(), 2);
+    }
+
+    void reloadAfterFailedLoad()
+    {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        const QDir dir(workspace.path());
+        writeFile(dir.filePath("main.qml"), mainDocument());
+
+        QQmlEngine qmlEngine;
+        QQuickView fallbackView(&qmlEngine, 0);
+        LiveNodeEngine node;
+        node.setQmlEngine(&qmlEngine);
+        node.setFallbackView(&fallbackView);
+        node.setWorkspace(workspace.path(), LiveNodeEngine::AllowUpdates);
+
+        QSignalSpy loaded(&node, &LiveNodeEngine::documentLoaded);
+        int errors = 0;
+        connect(&node, &LiveNodeEngine::logErrors, [&errors](const QList<QQmlError> &list) {
+            errors += list.count();
+        });
+
+        node.loadDocument(LiveDocument("main.qml"));
+        QCOMPARE(loaded.count(), 1);
+        QVERIFY(errors > 0);
+
+        // Failed loads are repeated even if nothing changed
+        node.loadDocument(LiveDocument("main.qml"));
+        QCOMPARE(loaded.count(), 2);
+
+        errors = 0;
+        writeFile(dir.filePath("Foo.qml"), fooDocument());
+        node.loadDocument(LiveDocument("main.qml"));
+        QCOMPARE(loaded.count(), 3);
+        QCOMPARE(errors, 0);
+    }
+};
+
+QTEST_MAIN(TestLiveNodeEngine)
+
+#include "tst_testlivenodeengine.moc"
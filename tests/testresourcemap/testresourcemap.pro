@@ -0,0 +1,22 @@
+QT       += testlib core
+
+TARGET = tst_testresourcemap
+CONFIG   += testcase
+
+INCLUDEPATH += $$PWD/../../src
+# Library sources are compiled in
+DEFINES += QMLLIVE_LIBRARY
+
+TEMPLATE = app
+
+SOURCES += \
+    tst_testresourcemap.cpp \
+    $$PWD/../../src/livedocument.cpp \
+    $$PWD/../../src/resourcemap.cpp
+
+HEADERS += \
+    $$PWD/../../src/livedocument.h \
+    $$PWD/../../src/resourcemap.h
+
+RESOURCES += \
+    testresourcemap.qrc
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include "livedocument.h"
+#include "resourcemap.h"
+
+// See main()
+static const char SYSTEM_LOCALE[] = "fi_FI";
+
+class TestResourceMap : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestResourceMap() {}
+
+private:
+    static bool update(ResourceMap *map, const QString &qrcDocument, const QByteArray &qrc)
+    {
+        QBuffer buffer;
+        buffer.setData(qrc);
+        buffer.open(QIODevice::ReadOnly);
+        return map->updateMapping(LiveDocument(qrcDocument), &buffer);
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QCOMPARE(QLocale::system().name(), QString::fromLatin1(SYSTEM_LOCALE));
+        QVERIFY(QFile::exists(":/test/data/main.qml"));
+    }
+
+    void localizedLookup()
+    {
+        ResourceMap map;
+        QVERIFY(update(&map, "qml/app.qrc",
+                       "<RCC>\n"
+                       "  <qresource prefix=\"/test\">\n"
+                       "    <file>data/main.qml</file>\n"
+                       "    <file>data/missing.qml</file>\n"
+                       "  </qresource>\n"
+                       "  <qresource prefix=\"/test\" lang=\"fi_FI\">\n"
+                       "    <file alias=\"data/main.qml\">data/main_fi.qml</file>\n"
+                       "  </qresource>\n"
+                       "  <qresource prefix=\"/test\" lang=\"de_DE\">\n"
+                       "    <file alias=\"data/main.qml\">data/main_de.qml</file>\n"
+                       "  </qresource>\n"
+                       "</RCC>\n"));
+
+        // The mapping for the system locale takes precedence over the nonlocalized one
+        QCOMPARE(map.toDocument(QStringLiteral(":/test/data/main.qml")), LiveDocument("qml/data/main_fi.qml"));
+        const QString url = QStringLiteral("qrc:/test/data/main.qml");
+        QCOMPARE(map.toDocument(url.midRef(3)), LiveDocument("qml/data/main_fi.qml"));
+        QCOMPARE(LiveDocument::resolve(QDir(), map, QUrl(url)), LiveDocument("qml/data/main_fi.qml"));
+
+        QCOMPARE(map.toResource(LiveDocument("qml/data/main_fi.qml")), QStringLiteral(":/test/data/main.qml"));
+        QCOMPARE(map.toResource(LiveDocument("qml/data/main.qml")), QStringLiteral(":/test/data/main.qml"));
+        const QString path = QStringLiteral("qml/data/main.qml");
+        QCOMPARE(map.toResource(QStringRef(&path)), QStringLiteral(":/test/data/main.qml"));
+
+        // Other locales and resources not compiled in are not mapped
+        QVERIFY(map.toResource(LiveDocument("qml/data/main_de.qml")).isEmpty());
+        QVERIFY(map.toResource(LiveDocument("qml/data/missing.qml")).isEmpty());
+        QVERIFY(map.toDocument(QStringLiteral(":/test/data/missing.qml")).isNull());
+    }
+
+    void remapping()
+    {
+        ResourceMap map;
+        QVERIFY(update(&map, "qml/app.qrc",
+                       "<RCC>\n"
+                       "  <qresource prefix=\"/test\" lang=\"fi_FI\">\n"
+                       "    <file alias=\"data/main.qml\">data/main_fi.qml</file>\n"
+                       "  </qresource>\n"
+                       "</RCC>\n"));
+        QCOMPARE(map.toDocument(QStringLiteral(":/test/data/main.qml")), LiveDocument("qml/data/main_fi.qml"));
+
+        const int generation = map.generation();
+        QVERIFY(update(&map, "qml/app.qrc",
+                       "<RCC>\n"
+                       "  <qresource prefix=\"/test\">\n"
+                       "    <file>data/main.qml</file>\n"
+                       "  </qresource>\n"
+                       "</RCC>\n"));
+        QVERIFY(map.generation() != generation);
+
+        // Mappings of the previous content of the same qrc document are gone
+        QCOMPARE(map.toDocument(QStringLiteral(":/test/data/main.qml")), LiveDocument("qml/data/main.qml"));
+        QVERIFY(map.toResource(LiveDocument("qml/data/main_fi.qml")).isEmpty());
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // Localized mappings are chosen by the system locale
+    qputenv("LC_ALL", SYSTEM_LOCALE);
+    QCoreApplication app(argc, argv);
+    TestResourceMap test;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_testresourcemap.moc"
@@ -2,6 +2,11 @@ TEMPLATE = subdirs
 
 
 SUBDIRS += \
-    testipc
+    testipc \
+    testdependencygraph \
+    testworkspacetree \
+    testlivenodeengine \
+    testresourcemap \
+    benchfiletypefilter
     #testsync \
     #http
@@ -0,0 +1,17 @@
+QT       += testlib core
+
+TARGET = tst_testworkspacetree
+CONFIG   += testcase
+
+INCLUDEPATH += $$PWD/../../src
+# Library sources are compiled in
+DEFINES += QMLLIVE_LIBRARY
+
+TEMPLATE = app
+
+SOURCES += \
+    tst_testworkspacetree.cpp \
+    $$PWD/../../src/workspacetree.cpp
+
+HEADERS += \
+    $$PWD/../../src/workspacetree.h
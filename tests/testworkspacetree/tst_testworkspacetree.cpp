@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Jolla Ltd
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QmlLive tool.
+**
+** $QT_BEGIN_LICENSE:GPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: GPL-3.0
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "workspacetree.h"
+
+class TestWorkspaceTree : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestWorkspaceTree() {}
+
+private:
+    static void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    static QStringList childNames(const WorkspaceTree::Node *node)
+    {
+        QStringList names;
+        foreach (const WorkspaceTree::Node *child, node->children)
+            names.append(child->name);
+        return names;
+    }
+
+private Q_SLOTS:
+    void scan() {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        const QDir dir(workspace.path());
+        writeFile(dir.filePath("main.qml"), "Item {}\n");
+        writeFile(dir.filePath("Button.qml"), "Item {}\n");
+        writeFile(dir.filePath("images/logo.png"), "png");
+        writeFile(dir.filePath("Controls/Slider.qml"), "Item {}\n");
+        QVERIFY(dir.mkpath("empty"));
+
+        WorkspaceTree tree;
+        QSignalSpy reset(&tree, &WorkspaceTree::reset);
+        tree.setRootPath(workspace.path());
+        QCOMPARE(reset.count(), 1);
+        QCOMPARE(tree.rootPath(), dir.absolutePath());
+
+        // Directories first, then by name ignoring case
+        QCOMPARE(childNames(tree.root()), QStringList() << "Controls" << "empty" << "images"
+                                                        << "Button.qml" << "main.qml");
+        for (int row = 0; row < tree.root()->children.count(); ++row) {
+            QCOMPARE(tree.root()->children.at(row)->row, row);
+            QCOMPARE(tree.root()->children.at(row)->parent, tree.root());
+        }
+
+        const WorkspaceTree::Node *logo = tree.find(dir.filePath("images/logo.png"));
+        QVERIFY(logo);
+        QVERIFY(!logo->isDir);
+        QCOMPARE(logo->size, qint64(3));
+        QCOMPARE(tree.filePath(logo), dir.absoluteFilePath("images/logo.png"));
+        QCOMPARE(tree.find(dir.absolutePath()), tree.root());
+        QVERIFY(!tree.find(dir.filePath("missing.qml")));
+        QVERIFY(!tree.find(dir.filePath("../outside.qml")));
+
+        QCOMPARE(tree.directories().first(), dir.absolutePath());
+        QCOMPARE(tree.directories().count(), 4);
+        QCOMPARE(tree.files(dir.absolutePath()),
+                 QStringList() << dir.absoluteFilePath("Button.qml") << dir.absoluteFilePath("main.qml"));
+        QVERIFY(tree.files(dir.filePath("empty")).isEmpty());
+        QCOMPARE(tree.fileNodes().count(), 4);
+    }
+
+    void changes() {
+        QTemporaryDir workspace;
+        QVERIFY(workspace.isValid());
+        const QDir dir(workspace.path());
+        writeFile(dir.filePath("main.qml"), "Item {}\n");
+        writeFile(dir.filePath("pages/First.qml"), "Item {}\n");
+
+        WorkspaceTree tree;
+        tree.setRootPath(workspace.path());
+        if (tree.hasError())
+            QSKIP("Watching the workspace failed");
+
+        QSignalSpy filesChanged(&tree, &WorkspaceTree::filesChanged);
+        QSignalSpy directoriesChanged(&tree, &WorkspaceTree::directoriesChanged);
+        QSignalSpy inserted(&tree, &WorkspaceTree::nodesInserted);
+
+        const QString second = dir.absoluteFilePath("pages/Second.qml");
+        writeFile(second, "Item {}\n");
+
+        QTRY_VERIFY(filesChanged.count() > 0);
+        QVERIFY(filesChanged.first().at(0).toStringList().contains(second));
+        QVERIFY(directoriesChanged.count() > 0);
+        QVERIFY(directoriesChanged.first().at(0).toStringList().contains(dir.absoluteFilePath("pages")));
+        QCOMPARE(inserted.count(), 1);
+        QVERIFY(tree.find(second));
+        QCOMPARE(tree.files(dir.filePath("pages")).count(), 2);
+
+        filesChanged.clear();
+        QSignalSpy removed(&tree, &WorkspaceTree::nodesRemoved);
+        QVERIFY(QFile::remove(second));
+
+        QTRY_VERIFY(filesChanged.count() > 0);
+        QVERIFY(filesChanged.first().at(0).toStringList().contains(second));
+        QCOMPARE(removed.count(), 1);
+        QVERIFY(!tree.find(second));
+    }
+};
+
+QTEST_MAIN(TestWorkspaceTree)
+
+#include "tst_testworkspacetree.moc"